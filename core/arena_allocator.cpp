@@ -0,0 +1,159 @@
+/*************************************************************************/
+/*  arena_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "arena_allocator.h"
+
+void *ArenaAllocator::_alloc_slow(size_t p_bytes, size_t p_align) {
+
+	// the current chunk can't fit this, try the chunks left over from a previous rewind
+	// before allocating a new one. Skipped space is still accounted as used, so marks stay valid.
+	while (current && current->next) {
+		used += current->size - current->used;
+		current->used = current->size;
+		current = current->next;
+		current->used = 0;
+		if (p_bytes + p_align <= current->size) {
+			return alloc(p_bytes, p_align);
+		}
+	}
+
+	size_t size = MAX(chunk_size, p_bytes + p_align);
+	Chunk *chunk = (Chunk *)Memory::alloc_static(HEADER_SIZE + size);
+	ERR_FAIL_COND_V(!chunk, NULL);
+	chunk->next = NULL;
+	chunk->size = size;
+	chunk->used = 0;
+
+	if (current) {
+		used += current->size - current->used;
+		current->used = current->size;
+		current->next = chunk;
+	} else {
+		first = chunk;
+	}
+	current = chunk;
+	capacity += size;
+
+	return alloc(p_bytes, p_align);
+}
+
+void ArenaAllocator::_free_chunks() {
+
+	Chunk *c = first;
+	while (c) {
+		Chunk *next = c->next;
+		Memory::free_static(c);
+		c = next;
+	}
+	first = NULL;
+	current = NULL;
+	capacity = 0;
+	used = 0;
+}
+
+ArenaAllocator::Mark ArenaAllocator::get_mark() const {
+
+	Mark mark;
+	mark.chunk = current;
+	mark.chunk_used = current ? current->used : 0;
+	mark.used = used;
+	mark.peak = peak;
+	return mark;
+}
+
+void ArenaAllocator::rewind(const Mark &p_mark) {
+
+	ERR_FAIL_COND(p_mark.used > used);
+
+	// the high water mark reached since p_mark still counts for whoever took earlier marks
+	peak = MAX(peak, p_mark.peak);
+
+	if (p_mark.used == 0) {
+		reset();
+		return;
+	}
+
+	current = p_mark.chunk;
+	current->used = p_mark.chunk_used;
+	used = p_mark.used;
+}
+
+void ArenaAllocator::reset() {
+
+	if (first && first->next) {
+		// the last frames needed more than one chunk, merge them into a single one so
+		// the following frames stay contiguous
+		size_t total = capacity;
+		_free_chunks();
+		chunk_size = MAX(chunk_size, total);
+	}
+
+	if (first) {
+		first->used = 0;
+	}
+	current = first;
+	used = 0;
+}
+
+ArenaAllocator::ArenaAllocator(size_t p_chunk_size) {
+
+	first = NULL;
+	current = NULL;
+	chunk_size = p_chunk_size;
+	used = 0;
+	capacity = 0;
+	peak = 0;
+}
+
+ArenaAllocator::~ArenaAllocator() {
+
+	_free_chunks();
+}
+
+ArenaAllocator FrameAllocator::arena;
+int FrameAllocator::frame_depth = 0;
+uint64_t FrameAllocator::max_frame_usage = 0;
+uint64_t FrameAllocator::last_frame_usage = 0;
+
+ArenaAllocator::Mark FrameAllocator::begin_frame() {
+
+	ArenaAllocator::Mark mark = arena.get_mark();
+	arena.reset_peak();
+	frame_depth++;
+	return mark;
+}
+
+void FrameAllocator::end_frame(const ArenaAllocator::Mark &p_mark) {
+
+	last_frame_usage = arena.get_peak() - p_mark.used;
+	max_frame_usage = MAX(max_frame_usage, last_frame_usage);
+	arena.rewind(p_mark);
+	frame_depth--;
+}
@@ -0,0 +1,161 @@
+/*************************************************************************/
+/*  arena_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include "core/error_macros.h"
+#include "core/os/memory.h"
+#include "core/os/thread.h"
+#include "core/typedefs.h"
+
+/**
+ * Linear (bump) allocator. Memory is carved sequentially out of big chunks and is
+ * only given back in bulk, either by rewinding to a previously taken mark or by
+ * resetting the whole arena. Freeing individual allocations is a no-op.
+ * Not thread safe, each thread is expected to own its arena.
+ */
+
+class ArenaAllocator {
+
+	struct Chunk {
+		Chunk *next;
+		size_t size;
+		size_t used;
+
+		_FORCE_INLINE_ uint8_t *data() { return reinterpret_cast<uint8_t *>(this) + HEADER_SIZE; }
+	};
+
+	enum {
+		HEADER_SIZE = (sizeof(Chunk) + 15) & ~15,
+		DEFAULT_CHUNK_SIZE = 64 * 1024
+	};
+
+	Chunk *first;
+	Chunk *current;
+
+	size_t chunk_size;
+	size_t used; // bytes handed out, including alignment padding
+	size_t capacity;
+	size_t peak;
+
+	void *_alloc_slow(size_t p_bytes, size_t p_align);
+	void _free_chunks();
+
+public:
+	struct Mark {
+		Chunk *chunk;
+		size_t chunk_used;
+		size_t used;
+		size_t peak;
+	};
+
+	_FORCE_INLINE_ void *alloc(size_t p_bytes, size_t p_align = 16) {
+
+		if (likely(current)) {
+			size_t ofs = (current->used + (p_align - 1)) & ~(p_align - 1);
+			if (likely(ofs + p_bytes <= current->size)) {
+				used += ofs + p_bytes - current->used;
+				current->used = ofs + p_bytes;
+				if (used > peak)
+					peak = used;
+				return current->data() + ofs;
+			}
+		}
+
+		return _alloc_slow(p_bytes, p_align);
+	}
+
+	Mark get_mark() const;
+	void rewind(const Mark &p_mark);
+	void reset();
+
+	_FORCE_INLINE_ size_t get_used() const { return used; }
+	_FORCE_INLINE_ size_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ size_t get_peak() const { return peak; }
+	_FORCE_INLINE_ void reset_peak() { peak = used; }
+
+	ArenaAllocator(size_t p_chunk_size = DEFAULT_CHUNK_SIZE);
+	~ArenaAllocator();
+};
+
+/**
+ * Allocator for per-frame temporary data, usable as the allocator template argument
+ * of List, Map and Set. Its arena is rewound by Main::iteration() when the frame
+ * ends, so data allocated here must never outlive the frame. Only the main thread
+ * inside a frame gets arena memory; other threads and code running outside
+ * Main::iteration() (startup, editor tools) fall back to the heap, as nothing would
+ * ever rewind the arena for them.
+ */
+
+class FrameAllocator {
+
+	enum {
+		// tells heap blocks from arena ones in free(), sized to keep 16 byte alignment
+		HEADER_SIZE = 16
+	};
+
+	static ArenaAllocator arena;
+	static int frame_depth;
+	static uint64_t max_frame_usage;
+	static uint64_t last_frame_usage;
+
+public:
+	_FORCE_INLINE_ static ArenaAllocator *get_arena() { return &arena; }
+
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) {
+
+		uint8_t *mem;
+		if (likely(frame_depth > 0 && Thread::get_caller_id() == Thread::get_main_id())) {
+			mem = (uint8_t *)arena.alloc(p_memory + HEADER_SIZE);
+			*(bool *)mem = false;
+		} else {
+			mem = (uint8_t *)memalloc(p_memory + HEADER_SIZE);
+			ERR_FAIL_COND_V(!mem, NULL);
+			*(bool *)mem = true;
+		}
+		return mem + HEADER_SIZE;
+	}
+	_FORCE_INLINE_ static void free(void *p_ptr) {
+
+		uint8_t *mem = (uint8_t *)p_ptr - HEADER_SIZE;
+		if (*(bool *)mem) {
+			memfree(mem);
+		} // arena blocks are released in bulk
+	}
+
+	static ArenaAllocator::Mark begin_frame();
+	static void end_frame(const ArenaAllocator::Mark &p_mark);
+
+	static uint64_t get_max_frame_usage() { return max_frame_usage; }
+	static uint64_t get_last_frame_usage() { return last_frame_usage; }
+};
+
+#endif // ARENA_ALLOCATOR_H
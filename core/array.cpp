@@ -39,8 +39,162 @@ class ArrayPrivate {
 public:
 	SafeRefCount refcount;
 	Vector<Variant> array;
+
+	// Arrays holding only INT, REAL, VECTOR2 or VECTOR3 values keep them packed here
+	// instead of boxing each one in a Variant. packed_type is NIL when they don't, and
+	// array is always empty when it isn't. Anything storing another type or asking
+	// for a Variant reference unpacks the values into array for good, get_value()
+	// reads them in place.
+	Variant::Type packed_type;
+	uint8_t *packed;
+	int packed_size;
+	int packed_capacity;
+
+	ArrayPrivate() {
+		packed_type = Variant::NIL;
+		packed = NULL;
+		packed_size = 0;
+		packed_capacity = 0;
+	}
+
+	~ArrayPrivate() {
+		if (packed)
+			memfree(packed);
+	}
 };
 
+// shared by every moved-from array so moving never allocates; it is never written
+// to, refcounted or freed, and _make_writable() swaps it for a private of its own
+static ArrayPrivate _empty_private;
+
+static _FORCE_INLINE_ int _packed_type_size(Variant::Type p_type) {
+
+	switch (p_type) {
+		case Variant::INT: return sizeof(int64_t);
+		case Variant::REAL: return sizeof(double);
+		case Variant::VECTOR2: return sizeof(Vector2);
+		case Variant::VECTOR3: return sizeof(Vector3);
+		default: return 0;
+	}
+}
+
+static _FORCE_INLINE_ uint8_t *_packed_elem(const ArrayPrivate *p_p, int p_idx) {
+
+	return p_p->packed + (size_t)p_idx * _packed_type_size(p_p->packed_type);
+}
+
+static _FORCE_INLINE_ Variant _packed_get(const ArrayPrivate *p_p, int p_idx) {
+
+	const uint8_t *elem = _packed_elem(p_p, p_idx);
+	switch (p_p->packed_type) {
+		case Variant::INT: return *(const int64_t *)elem;
+		case Variant::REAL: return *(const double *)elem;
+		case Variant::VECTOR2: return *(const Vector2 *)elem;
+		case Variant::VECTOR3: return *(const Vector3 *)elem;
+		default: return Variant();
+	}
+}
+
+// p_value must be of packed_type
+static _FORCE_INLINE_ void _packed_set(ArrayPrivate *p_p, int p_idx, const Variant &p_value) {
+
+	uint8_t *elem = _packed_elem(p_p, p_idx);
+	switch (p_p->packed_type) {
+		case Variant::INT: *(int64_t *)elem = p_value; break;
+		case Variant::REAL: *(double *)elem = p_value; break;
+		case Variant::VECTOR2: *(Vector2 *)elem = p_value; break;
+		case Variant::VECTOR3: *(Vector3 *)elem = p_value; break;
+		default: break;
+	}
+}
+
+template <class T>
+static int _packed_find_typed(const ArrayPrivate *p_p, const T &p_value, int p_from, int p_to, int p_step) {
+
+	const T *data = (const T *)p_p->packed;
+	for (int i = p_from; i != p_to; i += p_step) {
+		if (data[i] == p_value)
+			return i;
+	}
+	return -1;
+}
+
+// searches [p_from, p_to) forward or (p_to, p_from] backwards, depending on p_step
+static int _packed_find(const ArrayPrivate *p_p, const Variant &p_value, int p_from, int p_to, int p_step) {
+
+	switch (p_value.get_type() == p_p->packed_type ? p_p->packed_type : Variant::NIL) {
+		case Variant::INT: return _packed_find_typed<int64_t>(p_p, p_value, p_from, p_to, p_step);
+		case Variant::REAL: return _packed_find_typed<double>(p_p, p_value, p_from, p_to, p_step);
+		case Variant::VECTOR2: return _packed_find_typed<Vector2>(p_p, p_value, p_from, p_to, p_step);
+		case Variant::VECTOR3: return _packed_find_typed<Vector3>(p_p, p_value, p_from, p_to, p_step);
+		default: return -1; // Variant::operator== is strict about types
+	}
+}
+
+static bool _packed_reserve(ArrayPrivate *p_p, int p_size) {
+
+	if (p_size <= p_p->packed_capacity)
+		return true;
+
+	int capacity = next_power_of_2(p_size);
+	size_t elem_size = _packed_type_size(p_p->packed_type);
+	// next_power_of_2 wraps past 2^31, and capacity * elem_size may not fit size_t on 32 bits
+	ERR_FAIL_COND_V(capacity < p_size || (size_t)capacity > SIZE_MAX / elem_size, false);
+	size_t bytes = (size_t)capacity * elem_size;
+	uint8_t *packed = (uint8_t *)(p_p->packed ? memrealloc(p_p->packed, bytes) : memalloc(bytes));
+	ERR_FAIL_COND_V(!packed, false);
+	p_p->packed = packed;
+	p_p->packed_capacity = capacity;
+	return true;
+}
+
+static void _packed_clear(ArrayPrivate *p_p) {
+
+	if (p_p->packed)
+		memfree(p_p->packed);
+	p_p->packed = NULL;
+	p_p->packed_size = 0;
+	p_p->packed_capacity = 0;
+	p_p->packed_type = Variant::NIL;
+}
+
+// whether p_value can be stored packed, starting to pack if the array is empty
+static _FORCE_INLINE_ bool _packed_accepts(ArrayPrivate *p_p, const Variant &p_value) {
+
+	if (p_p->packed_type == p_value.get_type())
+		return p_p->packed_type != Variant::NIL;
+
+	if (p_p->packed_size > 0 || !p_p->array.empty() || _packed_type_size(p_value.get_type()) == 0)
+		return false;
+
+	_packed_clear(p_p);
+
+	p_p->packed_type = p_value.get_type();
+	return true;
+}
+
+static _FORCE_INLINE_ void _packed_swap(ArrayPrivate *p_p, int p_a, int p_b) {
+
+	uint8_t tmp[sizeof(Vector3)];
+	int elem_size = _packed_type_size(p_p->packed_type);
+	copymem(tmp, _packed_elem(p_p, p_a), elem_size);
+	copymem(_packed_elem(p_p, p_a), _packed_elem(p_p, p_b), elem_size);
+	copymem(_packed_elem(p_p, p_b), tmp, elem_size);
+}
+
+static void _unpack(ArrayPrivate *p_p) {
+
+	if (p_p->packed_type == Variant::NIL)
+		return;
+
+	p_p->array.resize(p_p->packed_size);
+	Variant *w = p_p->array.ptrw();
+	for (int i = 0; i < p_p->packed_size; i++) {
+		w[i] = _packed_get(p_p, i);
+	}
+	_packed_clear(p_p);
+}
+
 void Array::_ref(const Array &p_from) const {
 
 	ArrayPrivate *_fp = p_from._p;
@@ -50,6 +204,12 @@ void Array::_ref(const Array &p_from) const {
 	if (_fp == _p)
 		return; // whatever it is, nothing to do here move along
 
+	if (_fp == &_empty_private) {
+		_unref();
+		_p = _fp;
+		return;
+	}
+
 	bool success = _fp->refcount.ref();
 
 	ERR_FAIL_COND(!success); // should really not happen either
@@ -64,32 +224,50 @@ void Array::_unref() const {
 	if (!_p)
 		return;
 
-	if (_p->refcount.unref()) {
+	if (_p != &_empty_private && _p->refcount.unref()) {
 		memdelete(_p);
 	}
 	_p = NULL;
 }
 
+void Array::_make_writable() {
+
+	if (unlikely(_p == &_empty_private)) {
+		_p = memnew(ArrayPrivate);
+		_p->refcount.init();
+	}
+}
+
 Variant &Array::operator[](int p_idx) {
 
+	_make_writable();
+	_unpack(_p);
 	return _p->array.write[p_idx];
 }
 
 const Variant &Array::operator[](int p_idx) const {
 
+	if (unlikely(_p->packed_type != Variant::NIL)) {
+		// references need Variants to point to, readers sharing the array may race
+		// to convert it and nothing else can be writing to it
+		GLOBAL_LOCK_FUNCTION
+		_unpack(_p);
+	}
 	return _p->array[p_idx];
 }
 
 int Array::size() const {
 
-	return _p->array.size();
+	return _p->packed_type != Variant::NIL ? _p->packed_size : _p->array.size();
 }
 bool Array::empty() const {
 
-	return _p->array.empty();
+	return size() == 0;
 }
 void Array::clear() {
 
+	_make_writable();
+	_packed_clear(_p);
 	_p->array.clear();
 }
 
@@ -102,9 +280,9 @@ uint32_t Array::hash() const {
 
 	uint32_t h = hash_djb2_one_32(0);
 
-	for (int i = 0; i < _p->array.size(); i++) {
+	for (int i = 0; i < size(); i++) {
 
-		h = hash_djb2_one_32(_p->array[i].hash(), h);
+		h = hash_djb2_one_32(get_value(i).hash(), h);
 	}
 	return h;
 }
@@ -112,53 +290,112 @@ void Array::operator=(const Array &p_array) {
 
 	_ref(p_array);
 }
+void Array::operator=(Array &&p_array) {
+
+	if (p_array._p == _p)
+		return;
+	_unref();
+	_p = p_array._p;
+	p_array._p = &_empty_private;
+}
 void Array::push_back(const Variant &p_value) {
 
+	_make_writable();
+	if (_packed_accepts(_p, p_value)) {
+		ERR_FAIL_COND(!_packed_reserve(_p, _p->packed_size + 1));
+		_packed_set(_p, _p->packed_size++, p_value);
+		return;
+	}
+	_unpack(_p);
 	_p->array.push_back(p_value);
 }
+void Array::push_back(Variant &&p_value) {
+
+	_make_writable();
+	if (_packed_accepts(_p, p_value)) {
+		push_back((const Variant &)p_value);
+		return;
+	}
+	_unpack(_p);
+	_p->array.push_back(MOVE(p_value));
+}
 
 Error Array::resize(int p_new_size) {
 
+	_make_writable();
+	if (_p->packed_type != Variant::NIL && p_new_size >= 0 && p_new_size <= _p->packed_size) {
+		_p->packed_size = p_new_size;
+		return OK;
+	}
+	// new elements are null, so can't stay packed
+	_unpack(_p);
 	return _p->array.resize(p_new_size);
 }
 
 void Array::insert(int p_pos, const Variant &p_value) {
 
+	_make_writable();
+	if (_packed_accepts(_p, p_value)) {
+		ERR_FAIL_INDEX(p_pos, _p->packed_size + 1);
+		ERR_FAIL_COND(!_packed_reserve(_p, _p->packed_size + 1));
+		int elem_size = _packed_type_size(_p->packed_type);
+		movemem(_packed_elem(_p, p_pos + 1), _packed_elem(_p, p_pos), (size_t)(_p->packed_size - p_pos) * elem_size);
+		_p->packed_size++;
+		_packed_set(_p, p_pos, p_value);
+		return;
+	}
+	_unpack(_p);
 	_p->array.insert(p_pos, p_value);
 }
 
 void Array::erase(const Variant &p_value) {
 
+	_make_writable();
+	if (_p->packed_type != Variant::NIL) {
+		int idx = find(p_value);
+		if (idx >= 0)
+			remove(idx);
+		return;
+	}
 	_p->array.erase(p_value);
 }
 
 Variant Array::front() const {
-	ERR_FAIL_COND_V(_p->array.size() == 0, Variant());
-	return operator[](0);
+	ERR_FAIL_COND_V(size() == 0, Variant());
+	return get_value(0);
 }
 
 Variant Array::back() const {
-	ERR_FAIL_COND_V(_p->array.size() == 0, Variant());
-	return operator[](_p->array.size() - 1);
+	ERR_FAIL_COND_V(size() == 0, Variant());
+	return get_value(size() - 1);
 }
 
 int Array::find(const Variant &p_value, int p_from) const {
 
+	if (_p->packed_type != Variant::NIL) {
+		if (p_from < 0)
+			return -1;
+		return _packed_find(_p, p_value, MIN(p_from, _p->packed_size), _p->packed_size, 1);
+	}
 	return _p->array.find(p_value, p_from);
 }
 
 int Array::rfind(const Variant &p_value, int p_from) const {
 
-	if (_p->array.size() == 0)
+	if (size() == 0)
 		return -1;
 
 	if (p_from < 0) {
 		// Relative offset from the end
-		p_from = _p->array.size() + p_from;
+		p_from = size() + p_from;
 	}
-	if (p_from < 0 || p_from >= _p->array.size()) {
+	if (p_from < 0 || p_from >= size()) {
 		// Limit to array boundaries
-		p_from = _p->array.size() - 1;
+		p_from = size() - 1;
+	}
+
+	if (_p->packed_type != Variant::NIL) {
+		return _packed_find(_p, p_value, p_from, -1, -1);
 	}
 
 	for (int i = p_from; i >= 0; i--) {
@@ -178,10 +415,18 @@ int Array::find_last(const Variant &p_value) const {
 
 int Array::count(const Variant &p_value) const {
 
-	if (_p->array.size() == 0)
+	if (size() == 0)
 		return 0;
 
 	int amount = 0;
+
+	if (_p->packed_type != Variant::NIL) {
+		for (int i = _packed_find(_p, p_value, 0, _p->packed_size, 1); i >= 0; i = _packed_find(_p, p_value, i + 1, _p->packed_size, 1)) {
+			amount++;
+		}
+		return amount;
+	}
+
 	for (int i = 0; i < _p->array.size(); i++) {
 
 		if (_p->array[i] == p_value) {
@@ -193,16 +438,30 @@ int Array::count(const Variant &p_value) const {
 }
 
 bool Array::has(const Variant &p_value) const {
-	return _p->array.find(p_value, 0) != -1;
+	return find(p_value, 0) != -1;
 }
 
 void Array::remove(int p_pos) {
 
+	_make_writable();
+	if (_p->packed_type != Variant::NIL) {
+		ERR_FAIL_INDEX(p_pos, _p->packed_size);
+		int elem_size = _packed_type_size(_p->packed_type);
+		movemem(_packed_elem(_p, p_pos), _packed_elem(_p, p_pos + 1), (size_t)(_p->packed_size - p_pos - 1) * elem_size);
+		_p->packed_size--;
+		return;
+	}
 	_p->array.remove(p_pos);
 }
 
 void Array::set(int p_idx, const Variant &p_value) {
 
+	_make_writable();
+	if (_p->packed_type != Variant::NIL && p_value.get_type() == _p->packed_type) {
+		CRASH_BAD_INDEX(p_idx, _p->packed_size);
+		_packed_set(_p, p_idx, p_value);
+		return;
+	}
 	operator[](p_idx) = p_value;
 }
 
@@ -211,8 +470,27 @@ const Variant &Array::get(int p_idx) const {
 	return operator[](p_idx);
 }
 
+Variant Array::get_value(int p_idx) const {
+
+	if (_p->packed_type != Variant::NIL) {
+		CRASH_BAD_INDEX(p_idx, _p->packed_size);
+		return _packed_get(_p, p_idx);
+	}
+	return _p->array[p_idx];
+}
+
 Array Array::duplicate(bool p_deep) const {
 
+	if (_p->packed_type != Variant::NIL) {
+		// numbers and vectors, nothing to deep copy
+		Array new_arr;
+		new_arr._p->packed_type = _p->packed_type;
+		ERR_FAIL_COND_V(!_packed_reserve(new_arr._p, _p->packed_size), Array());
+		copymem(new_arr._p->packed, _p->packed, (size_t)_p->packed_size * _packed_type_size(_p->packed_type));
+		new_arr._p->packed_size = _p->packed_size;
+		return new_arr;
+	}
+
 	Array new_arr;
 	int element_count = size();
 	new_arr.resize(element_count);
@@ -234,9 +512,24 @@ struct _ArrayVariantSort {
 	}
 };
 
+template <class T>
+static void _packed_sort(ArrayPrivate *p_p) {
+
+	// same order as OP_LESS gives for these types
+	SortArray<T> sorter;
+	sorter.sort((T *)p_p->packed, p_p->packed_size);
+}
+
 Array &Array::sort() {
 
-	_p->array.sort_custom<_ArrayVariantSort>();
+	_make_writable();
+	switch (_p->packed_type) {
+		case Variant::INT: _packed_sort<int64_t>(_p); break;
+		case Variant::REAL: _packed_sort<double>(_p); break;
+		case Variant::VECTOR2: _packed_sort<Vector2>(_p); break;
+		case Variant::VECTOR3: _packed_sort<Vector3>(_p); break;
+		default: _p->array.sort_custom<_ArrayVariantSort>();
+	}
 	return *this;
 }
 
@@ -259,6 +552,8 @@ Array &Array::sort_custom(Object *p_obj, const StringName &p_function) {
 
 	ERR_FAIL_NULL_V(p_obj, *this);
 
+	_make_writable();
+	_unpack(_p);
 	SortArray<Variant, _ArrayVariantSortCustom, true> avs;
 	avs.compare.obj = p_obj;
 	avs.compare.func = p_function;
@@ -268,9 +563,16 @@ Array &Array::sort_custom(Object *p_obj, const StringName &p_function) {
 
 void Array::shuffle() {
 
-	const int n = _p->array.size();
+	const int n = size();
 	if (n < 2)
 		return;
+	if (_p->packed_type != Variant::NIL) {
+		for (int i = n - 1; i >= 1; i--) {
+			const int j = Math::rand() % (i + 1);
+			_packed_swap(_p, i, j);
+		}
+		return;
+	}
 	Variant *data = _p->array.ptrw();
 	for (int i = n - 1; i >= 1; i--) {
 		const int j = Math::rand() % (i + 1);
@@ -281,14 +583,14 @@ void Array::shuffle() {
 }
 
 template <typename Less>
-_FORCE_INLINE_ int bisect(const Vector<Variant> &p_array, const Variant &p_value, bool p_before, const Less &p_less) {
+_FORCE_INLINE_ int bisect(const Array &p_array, const Variant &p_value, bool p_before, const Less &p_less) {
 
 	int lo = 0;
 	int hi = p_array.size();
 	if (p_before) {
 		while (lo < hi) {
 			const int mid = (lo + hi) / 2;
-			if (p_less(p_array.get(mid), p_value)) {
+			if (p_less(p_array.get_value(mid), p_value)) {
 				lo = mid + 1;
 			} else {
 				hi = mid;
@@ -297,7 +599,7 @@ _FORCE_INLINE_ int bisect(const Vector<Variant> &p_array, const Variant &p_value
 	} else {
 		while (lo < hi) {
 			const int mid = (lo + hi) / 2;
-			if (p_less(p_value, p_array.get(mid))) {
+			if (p_less(p_value, p_array.get_value(mid))) {
 				hi = mid;
 			} else {
 				lo = mid + 1;
@@ -309,7 +611,7 @@ _FORCE_INLINE_ int bisect(const Vector<Variant> &p_array, const Variant &p_value
 
 int Array::bsearch(const Variant &p_value, bool p_before) {
 
-	return bisect(_p->array, p_value, p_before, _ArrayVariantSort());
+	return bisect(*this, p_value, p_before, _ArrayVariantSort());
 }
 
 int Array::bsearch_custom(const Variant &p_value, Object *p_obj, const StringName &p_function, bool p_before) {
@@ -320,26 +622,33 @@ int Array::bsearch_custom(const Variant &p_value, Object *p_obj, const StringNam
 	less.obj = p_obj;
 	less.func = p_function;
 
-	return bisect(_p->array, p_value, p_before, less);
+	return bisect(*this, p_value, p_before, less);
 }
 
 Array &Array::invert() {
 
+	_make_writable();
+	if (_p->packed_type != Variant::NIL) {
+		for (int i = 0; i < _p->packed_size / 2; i++) {
+			_packed_swap(_p, i, _p->packed_size - i - 1);
+		}
+		return *this;
+	}
 	_p->array.invert();
 	return *this;
 }
 
 void Array::push_front(const Variant &p_value) {
 
-	_p->array.insert(0, p_value);
+	insert(0, p_value);
 }
 
 Variant Array::pop_back() {
 
-	if (!_p->array.empty()) {
-		int n = _p->array.size() - 1;
-		Variant ret = _p->array.get(n);
-		_p->array.resize(n);
+	if (!empty()) {
+		int n = size() - 1;
+		Variant ret = get_value(n);
+		resize(n);
 		return ret;
 	}
 	return Variant();
@@ -347,9 +656,9 @@ Variant Array::pop_back() {
 
 Variant Array::pop_front() {
 
-	if (!_p->array.empty()) {
-		Variant ret = _p->array.get(0);
-		_p->array.remove(0);
+	if (!empty()) {
+		Variant ret = get_value(0);
+		remove(0);
 		return ret;
 	}
 	return Variant();
@@ -360,11 +669,11 @@ Variant Array::min() const {
 	Variant minval;
 	for (int i = 0; i < size(); i++) {
 		if (i == 0) {
-			minval = get(i);
+			minval = get_value(i);
 		} else {
 			bool valid;
 			Variant ret;
-			Variant test = get(i);
+			Variant test = get_value(i);
 			Variant::evaluate(Variant::OP_LESS, test, minval, ret, valid);
 			if (!valid) {
 				return Variant(); //not a valid comparison
@@ -383,11 +692,11 @@ Variant Array::max() const {
 	Variant maxval;
 	for (int i = 0; i < size(); i++) {
 		if (i == 0) {
-			maxval = get(i);
+			maxval = get_value(i);
 		} else {
 			bool valid;
 			Variant ret;
-			Variant test = get(i);
+			Variant test = get_value(i);
 			Variant::evaluate(Variant::OP_GREATER, test, maxval, ret, valid);
 			if (!valid) {
 				return Variant(); //not a valid comparison
@@ -402,7 +711,7 @@ Variant Array::max() const {
 }
 
 const void *Array::id() const {
-	return _p->array.ptr();
+	return _p;
 }
 
 Array::Array(const Array &p_from) {
@@ -411,6 +720,13 @@ Array::Array(const Array &p_from) {
 	_ref(p_from);
 }
 
+Array::Array(Array &&p_from) {
+
+	// the moved-from array is left empty, but still usable
+	_p = p_from._p;
+	p_from._p = &_empty_private;
+}
+
 Array::Array() {
 
 	_p = memnew(ArrayPrivate);
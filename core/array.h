@@ -43,6 +43,7 @@ class Array {
 	mutable ArrayPrivate *_p;
 	void _ref(const Array &p_from) const;
 	void _unref() const;
+	void _make_writable();
 
 public:
 	Variant &operator[](int p_idx);
@@ -50,6 +51,7 @@ public:
 
 	void set(int p_idx, const Variant &p_value);
 	const Variant &get(int p_idx) const;
+	Variant get_value(int p_idx) const; // by value, doesn't unpack packed arrays
 
 	int size() const;
 	bool empty() const;
@@ -59,8 +61,10 @@ public:
 
 	uint32_t hash() const;
 	void operator=(const Array &p_array);
+	void operator=(Array &&p_array);
 
 	void push_back(const Variant &p_value);
+	void push_back(Variant &&p_value);
 	_FORCE_INLINE_ void append(const Variant &p_value) { push_back(p_value); } //for python compatibility
 	Error resize(int p_new_size);
 
@@ -97,6 +101,7 @@ public:
 	const void *id() const;
 
 	Array(const Array &p_from);
+	Array(Array &&p_from);
 	Array();
 	~Array();
 };
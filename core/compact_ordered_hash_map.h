@@ -0,0 +1,435 @@
+/*************************************************************************/
+/*  compact_ordered_hash_map.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef COMPACT_ORDERED_HASH_MAP_H
+#define COMPACT_ORDERED_HASH_MAP_H
+
+#include "core/error_macros.h"
+#include "core/hashfuncs.h"
+#include "core/os/memory.h"
+
+/**
+ * An insertion ordered HashMap optimized for memory usage.
+ *
+ * Entries (hash, key and value) are stored densely in insertion order, and a separate
+ * open addressing table of 32 bits indices (linear probing, backward shift deletion)
+ * points into them. There is no per-element allocation and nothing at all is allocated until
+ * the first insertion.
+ *
+ * Entries live in pages that double in size and are never reallocated, and erasing only
+ * leaves a hole behind, so pointers to keys and values stay valid across insert() and
+ * erase(). Holes at the end are reused right away, the others stay until clear() or an
+ * explicit compact(), which is the only thing moving entries around.
+ */
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey> >
+class CompactOrderedHashMap {
+
+	struct Entry {
+		uint32_t hash; // EMPTY_HASH once erased
+		TKey key;
+		TValue value;
+	};
+
+	enum {
+		FIRST_PAGE_SHIFT = 3, // first page holds 8 entries
+		MIN_INDEX_CAPACITY = 8
+	};
+
+	static const uint32_t EMPTY_HASH = 0;
+
+	Entry **pages;
+	uint32_t page_count;
+
+	uint32_t *indices; // entry index + 1, 0 means the slot is free
+	uint32_t index_mask;
+
+	uint32_t used; // entries in use, including erased holes
+	uint32_t num_elements;
+
+	_FORCE_INLINE_ static uint32_t _hash(const TKey &p_key) {
+		uint32_t hash = hash_fmix32(Hasher::hash(p_key));
+		return hash == EMPTY_HASH ? EMPTY_HASH + 1 : hash;
+	}
+
+	_FORCE_INLINE_ static uint32_t _page_of(uint32_t p_entry) {
+		// page k holds (1 << (k + FIRST_PAGE_SHIFT)) entries and starts at ((1 << k) - 1) << FIRST_PAGE_SHIFT
+		uint32_t n = (p_entry >> FIRST_PAGE_SHIFT) + 1;
+#if defined(__GNUC__) || _llvm_has_builtin(__builtin_clz)
+		return 31 - __builtin_clz(n);
+#else
+		uint32_t page = 0;
+		while (n >>= 1) {
+			page++;
+		}
+		return page;
+#endif
+	}
+
+	_FORCE_INLINE_ Entry *_entry(uint32_t p_entry) const {
+		uint32_t page = _page_of(p_entry);
+		return &pages[page][p_entry - (((1 << page) - 1) << FIRST_PAGE_SHIFT)];
+	}
+
+	_FORCE_INLINE_ uint32_t _entry_capacity() const {
+		return ((1 << page_count) - 1) << FIRST_PAGE_SHIFT;
+	}
+
+	// returns the slot holding p_key, or the free slot where it would go; the index must exist
+	_FORCE_INLINE_ uint32_t _find_slot(const TKey &p_key, uint32_t p_hash) const {
+
+		uint32_t pos = p_hash & index_mask;
+		while (true) {
+			uint32_t idx = indices[pos];
+			if (idx == 0) {
+				return pos;
+			}
+			const Entry *e = _entry(idx - 1);
+			if (e->hash == p_hash && Comparator::compare(e->key, p_key)) {
+				return pos;
+			}
+			pos = (pos + 1) & index_mask;
+		}
+	}
+
+	_FORCE_INLINE_ void _index_insert(uint32_t p_hash, uint32_t p_entry) {
+
+		uint32_t pos = p_hash & index_mask;
+		while (indices[pos] != 0) {
+			pos = (pos + 1) & index_mask;
+		}
+		indices[pos] = p_entry + 1;
+	}
+
+	void _rebuild_index(uint32_t p_capacity) {
+
+		if (indices) {
+			memfree(indices);
+		}
+		indices = (uint32_t *)memalloc(sizeof(uint32_t) * p_capacity);
+		for (uint32_t i = 0; i < p_capacity; i++) {
+			indices[i] = 0;
+		}
+		index_mask = p_capacity - 1;
+
+		for (uint32_t i = 0; i < used; i++) {
+			const Entry *e = _entry(i);
+			if (e->hash != EMPTY_HASH) {
+				_index_insert(e->hash, i);
+			}
+		}
+	}
+
+	void _remove_slot(uint32_t p_pos) {
+
+		// backward shift deletion, keeps probe sequences intact without tombstones
+		uint32_t hole = p_pos;
+		uint32_t pos = p_pos;
+		while (true) {
+			pos = (pos + 1) & index_mask;
+			uint32_t idx = indices[pos];
+			if (idx == 0) {
+				break;
+			}
+			uint32_t home = _entry(idx - 1)->hash & index_mask;
+			// move it into the hole unless its home lies cyclically in (hole, pos]
+			bool movable = (hole <= pos) ? (home <= hole || home > pos) : (home <= hole && home > pos);
+			if (movable) {
+				indices[hole] = idx;
+				hole = pos;
+			}
+		}
+		indices[hole] = 0;
+	}
+
+	Entry *_insert(const TKey &p_key, uint32_t p_hash, uint32_t p_slot, const TValue &p_value) {
+
+		if (used == _entry_capacity()) {
+			pages = (Entry **)memrealloc(pages, sizeof(Entry *) * (page_count + 1));
+			pages[page_count] = (Entry *)memalloc(sizeof(Entry) << (page_count + FIRST_PAGE_SHIFT));
+			page_count++;
+		}
+
+		Entry *e = _entry(used);
+		e->hash = p_hash;
+		memnew_placement(&e->key, TKey(p_key));
+		memnew_placement(&e->value, TValue(p_value));
+
+		num_elements++;
+		if (num_elements * 4 > (index_mask + 1) * 3) {
+			used++;
+			_rebuild_index((index_mask + 1) * 2);
+		} else {
+			indices[p_slot] = used + 1;
+			used++;
+		}
+
+		return e;
+	}
+
+	void _copy_from(const CompactOrderedHashMap &p_from) {
+
+		for (uint32_t i = 0; i < p_from.used; i++) {
+			const Entry *e = p_from._entry(i);
+			if (e->hash != EMPTY_HASH) {
+				insert(e->key, e->value);
+			}
+		}
+	}
+
+public:
+	_FORCE_INLINE_ int size() const { return num_elements; }
+	_FORCE_INLINE_ bool empty() const { return num_elements == 0; }
+
+	TValue *getptr(const TKey &p_key) {
+
+		if (unlikely(num_elements == 0)) {
+			return NULL;
+		}
+		uint32_t idx = indices[_find_slot(p_key, _hash(p_key))];
+		return idx ? &_entry(idx - 1)->value : NULL;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+
+		return const_cast<CompactOrderedHashMap *>(this)->getptr(p_key);
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return getptr(p_key) != NULL;
+	}
+
+	TValue &insert(const TKey &p_key, const TValue &p_value) {
+
+		if (unlikely(!indices)) {
+			_rebuild_index(MIN_INDEX_CAPACITY);
+		}
+		uint32_t hash = _hash(p_key);
+		uint32_t slot = _find_slot(p_key, hash);
+		if (indices[slot]) {
+			Entry *e = _entry(indices[slot] - 1);
+			e->value = p_value;
+			return e->value;
+		}
+		return _insert(p_key, hash, slot, p_value)->value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+
+		if (unlikely(!indices)) {
+			_rebuild_index(MIN_INDEX_CAPACITY);
+		}
+		uint32_t hash = _hash(p_key);
+		uint32_t slot = _find_slot(p_key, hash);
+		if (indices[slot]) {
+			return _entry(indices[slot] - 1)->value;
+		}
+		// consistent with Map behaviour
+		return _insert(p_key, hash, slot, TValue())->value;
+	}
+
+	const TValue &operator[](const TKey &p_key) const {
+
+		const TValue *v = getptr(p_key);
+		CRASH_COND(!v);
+		return *v;
+	}
+
+	bool erase(const TKey &p_key) {
+
+		if (num_elements == 0) {
+			return false;
+		}
+
+		uint32_t slot = _find_slot(p_key, _hash(p_key));
+		uint32_t idx = indices[slot];
+		if (!idx) {
+			return false;
+		}
+
+		_remove_slot(slot);
+
+		Entry *e = _entry(idx - 1);
+		e->key.~TKey();
+		e->value.~TValue();
+		e->hash = EMPTY_HASH;
+		num_elements--;
+
+		// holes at the end can be reused right away, the others wait for an insertion to compact them
+		while (used > 0 && _entry(used - 1)->hash == EMPTY_HASH) {
+			used--;
+		}
+
+		return true;
+	}
+
+	void clear() {
+
+		for (uint32_t i = 0; i < used; i++) {
+			Entry *e = _entry(i);
+			if (e->hash != EMPTY_HASH) {
+				e->key.~TKey();
+				e->value.~TValue();
+			}
+		}
+		if (indices) {
+			for (uint32_t i = 0; i <= index_mask; i++) {
+				indices[i] = 0;
+			}
+		}
+		used = 0;
+		num_elements = 0;
+	}
+
+	/**
+	 * Iteration goes through entry positions in insertion order, skipping erased ones:
+	 * for (int i = map.next_pos(-1); i >= 0; i = map.next_pos(i)) { ... map.key_at(i) ... }
+	 */
+	int next_pos(int p_pos) const {
+
+		for (uint32_t i = p_pos + 1; i < used; i++) {
+			if (_entry(i)->hash != EMPTY_HASH) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	int find_pos(const TKey &p_key) const {
+
+		if (num_elements == 0) {
+			return -1;
+		}
+		uint32_t idx = indices[_find_slot(p_key, _hash(p_key))];
+		return int(idx) - 1;
+	}
+
+	// position of the p_index-th element, constant time unless elements were erased
+	int get_pos_at_index(int p_index) const {
+
+		ERR_FAIL_INDEX_V(p_index, (int)num_elements, -1);
+		if (used == num_elements) {
+			return p_index;
+		}
+		int pos = next_pos(-1);
+		while (p_index-- > 0) {
+			pos = next_pos(pos);
+		}
+		return pos;
+	}
+
+	_FORCE_INLINE_ const TKey &key_at(int p_pos) const { return _entry(p_pos)->key; }
+	_FORCE_INLINE_ TValue &value_at(int p_pos) { return _entry(p_pos)->value; }
+	_FORCE_INLINE_ const TValue &value_at(int p_pos) const { return _entry(p_pos)->value; }
+
+	// closes the holes left by erase() and frees the pages left empty, invalidating
+	// pointers to keys and values
+	void compact() {
+
+		if (used == num_elements) {
+			return;
+		}
+
+		uint32_t to = 0;
+		for (uint32_t from = 0; from < used; from++) {
+			Entry *src = _entry(from);
+			if (src->hash == EMPTY_HASH) {
+				continue;
+			}
+			if (to != from) {
+				Entry *dst = _entry(to);
+				dst->hash = src->hash;
+				memnew_placement(&dst->key, TKey(MOVE(src->key)));
+				memnew_placement(&dst->value, TValue(MOVE(src->value)));
+				src->key.~TKey();
+				src->value.~TValue();
+				src->hash = EMPTY_HASH;
+			}
+			to++;
+		}
+		used = to;
+		while (page_count > 0 && _entry_capacity() - (1 << (page_count - 1 + FIRST_PAGE_SHIFT)) >= used) {
+			memfree(pages[--page_count]);
+		}
+		_rebuild_index(index_mask + 1);
+	}
+
+	// memory used by the table itself, not counting what keys and values may point to
+	size_t get_memory_usage() const {
+		return sizeof(Entry) * _entry_capacity() + sizeof(Entry *) * page_count + (indices ? sizeof(uint32_t) * (index_mask + 1) : 0);
+	}
+
+	void operator=(const CompactOrderedHashMap &p_from) {
+
+		if (this == &p_from) {
+			return;
+		}
+		clear();
+		_copy_from(p_from);
+	}
+
+	CompactOrderedHashMap(const CompactOrderedHashMap &p_from) {
+
+		pages = NULL;
+		page_count = 0;
+		indices = NULL;
+		index_mask = 0;
+		used = 0;
+		num_elements = 0;
+		_copy_from(p_from);
+	}
+
+	CompactOrderedHashMap() {
+
+		pages = NULL;
+		page_count = 0;
+		indices = NULL;
+		index_mask = 0;
+		used = 0;
+		num_elements = 0;
+	}
+
+	~CompactOrderedHashMap() {
+
+		clear();
+		for (uint32_t i = 0; i < page_count; i++) {
+			memfree(pages[i]);
+		}
+		if (pages) {
+			memfree(pages);
+		}
+		if (indices) {
+			memfree(indices);
+		}
+	}
+};
+
+#endif // COMPACT_ORDERED_HASH_MAP_H
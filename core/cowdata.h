@@ -107,10 +107,13 @@ private:
 	void _unref(void *p_data);
 	void _ref(const CowData *p_from);
 	void _ref(const CowData &p_from);
+	void _steal(CowData &p_from);
 	void _copy_on_write();
+	Error _resize(int p_size, bool p_construct);
 
 public:
 	void operator=(const CowData<T> &p_from) { _ref(p_from); }
+	void operator=(CowData<T> &&p_from) { _steal(p_from); }
 
 	_FORCE_INLINE_ T *ptrw() {
 		_copy_on_write();
@@ -139,6 +142,13 @@ public:
 		_get_data()[p_index] = p_elem;
 	}
 
+	_FORCE_INLINE_ void set(int p_index, T &&p_elem) {
+
+		CRASH_BAD_INDEX(p_index, size());
+		_copy_on_write();
+		_get_data()[p_index] = MOVE(p_elem);
+	}
+
 	_FORCE_INLINE_ T &get_m(int p_index) {
 
 		CRASH_BAD_INDEX(p_index, size());
@@ -153,7 +163,7 @@ public:
 		return _get_data()[p_index];
 	}
 
-	Error resize(int p_size);
+	Error resize(int p_size) { return _resize(p_size, true); }
 
 	_FORCE_INLINE_ void remove(int p_index) {
 
@@ -162,7 +172,7 @@ public:
 		int len = size();
 		for (int i = p_index; i < len - 1; i++) {
 
-			p[i] = p[i + 1];
+			p[i] = MOVE(p[i + 1]);
 		};
 
 		resize(len - 1);
@@ -170,20 +180,41 @@ public:
 
 	Error insert(int p_pos, const T &p_val) {
 
+		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
+		T val = p_val; // p_val may alias an element that is about to be moved
+		resize(size() + 1);
+		T *p = ptrw();
+		for (int i = (size() - 1); i > p_pos; i--)
+			p[i] = MOVE(p[i - 1]);
+		p[p_pos] = MOVE(val);
+
+		return OK;
+	};
+
+	Error insert(int p_pos, T &&p_val) {
+
 		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
 		resize(size() + 1);
+		T *p = ptrw();
 		for (int i = (size() - 1); i > p_pos; i--)
-			set(i, get(i - 1));
-		set(p_pos, p_val);
+			p[i] = MOVE(p[i - 1]);
+		p[p_pos] = MOVE(p_val);
 
 		return OK;
 	};
 
+	template <class... P>
+	Error emplace(int p_pos, P &&... p_args);
+
 	int find(const T &p_val, int p_from = 0) const;
 
 	_FORCE_INLINE_ CowData();
 	_FORCE_INLINE_ ~CowData();
 	_FORCE_INLINE_ CowData(CowData<T> &p_from) { _ref(p_from); };
+	_FORCE_INLINE_ CowData(CowData<T> &&p_from) {
+		_ptr = p_from._ptr;
+		p_from._ptr = NULL;
+	};
 };
 
 template <class T>
@@ -247,7 +278,7 @@ void CowData<T>::_copy_on_write() {
 }
 
 template <class T>
-Error CowData<T>::resize(int p_size) {
+Error CowData<T>::_resize(int p_size, bool p_construct) {
 
 	ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
 
@@ -286,7 +317,7 @@ Error CowData<T>::resize(int p_size) {
 
 		// construct the newly created elements
 
-		if (!__has_trivial_constructor(T)) {
+		if (p_construct && !__has_trivial_constructor(T)) {
 			T *elems = _get_data();
 
 			for (int i = *_get_size(); i < p_size; i++) {
@@ -317,6 +348,26 @@ Error CowData<T>::resize(int p_size) {
 	return OK;
 }
 
+template <class T>
+template <class... P>
+Error CowData<T>::emplace(int p_pos, P &&... p_args) {
+
+	int len = size();
+	ERR_FAIL_INDEX_V(p_pos, len + 1, ERR_INVALID_PARAMETER);
+	// grow without constructing the new slot, elements are relocated bitwise
+	// like realloc() already does, then the new element is built in place
+	Error err = _resize(len + 1, false);
+	ERR_FAIL_COND_V(err, err);
+
+	T *p = _get_data();
+	if (p_pos < len) {
+		memmove((void *)&p[p_pos + 1], (void *)&p[p_pos], (len - p_pos) * sizeof(T));
+	}
+	_post_initialize(new (&p[p_pos], sizeof(T), "") T(FORWARD(P, p_args)...));
+
+	return OK;
+}
+
 template <class T>
 int CowData<T>::find(const T &p_val, int p_from) const {
 	int ret = -1;
@@ -357,6 +408,17 @@ void CowData<T>::_ref(const CowData &p_from) {
 	}
 }
 
+template <class T>
+void CowData<T>::_steal(CowData &p_from) {
+
+	if (_ptr == p_from._ptr)
+		return; // self assign, do nothing.
+
+	_unref(_ptr);
+	_ptr = p_from._ptr;
+	p_from._ptr = NULL;
+}
+
 template <class T>
 CowData<T>::CowData() {
 
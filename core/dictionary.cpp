@@ -30,54 +30,59 @@
 
 #include "dictionary.h"
 
-#include "core/ordered_hash_map.h"
+#include "core/compact_ordered_hash_map.h"
 #include "core/safe_refcount.h"
 #include "core/variant.h"
 
 struct DictionaryPrivate {
 
 	SafeRefCount refcount;
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
+	CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
 };
 
+// shared by every moved-from dictionary so moving never allocates; it is never
+// written to, refcounted or freed, and _make_writable() swaps it for a private of its own
+static DictionaryPrivate _empty_private;
+
+void Dictionary::_make_writable() {
+
+	if (unlikely(_p == &_empty_private)) {
+		_p = memnew(DictionaryPrivate);
+		_p->refcount.init();
+	}
+}
+
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
 
 	if (_p->variant_map.empty())
 		return;
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		p_keys->push_back(E.key());
+	for (int i = _p->variant_map.next_pos(-1); i >= 0; i = _p->variant_map.next_pos(i)) {
+		p_keys->push_back(_p->variant_map.key_at(i));
 	}
 }
 
 Variant Dictionary::get_key_at_index(int p_index) const {
 
-	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		if (index == p_index) {
-			return E.key();
-		}
-		index++;
+	if (p_index < 0 || p_index >= _p->variant_map.size()) {
+		return Variant();
 	}
 
-	return Variant();
+	return _p->variant_map.key_at(_p->variant_map.get_pos_at_index(p_index));
 }
 
 Variant Dictionary::get_value_at_index(int p_index) const {
 
-	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		if (index == p_index) {
-			return E.value();
-		}
-		index++;
+	if (p_index < 0 || p_index >= _p->variant_map.size()) {
+		return Variant();
 	}
 
-	return Variant();
+	return _p->variant_map.value_at(_p->variant_map.get_pos_at_index(p_index));
 }
 
 Variant &Dictionary::operator[](const Variant &p_key) {
 
+	_make_writable();
 	return _p->variant_map[p_key];
 }
 
@@ -87,29 +92,21 @@ const Variant &Dictionary::operator[](const Variant &p_key) const {
 }
 const Variant *Dictionary::getptr(const Variant &p_key) const {
 
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E)
-		return NULL;
-	return &E.get();
+	return ((const DictionaryPrivate *)_p)->variant_map.getptr(p_key);
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
 
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(p_key);
-
-	if (!E)
-		return NULL;
-	return &E.get();
+	_make_writable();
+	return _p->variant_map.getptr(p_key);
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
 
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E)
+	const Variant *result = getptr(p_key);
+	if (!result)
 		return Variant();
-	return E.get();
+	return *result;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -146,6 +143,7 @@ bool Dictionary::has_all(const Array &p_keys) const {
 
 bool Dictionary::erase(const Variant &p_key) {
 
+	_make_writable();
 	return _p->variant_map.erase(p_key);
 }
 
@@ -161,6 +159,13 @@ bool Dictionary::operator!=(const Dictionary &p_dictionary) const {
 
 void Dictionary::_ref(const Dictionary &p_from) const {
 
+	if (p_from._p == &_empty_private) {
+		if (_p)
+			_unref();
+		_p = p_from._p;
+		return;
+	}
+
 	//make a copy first (thread safe)
 	if (!p_from._p->refcount.ref())
 		return; // couldn't copy
@@ -177,13 +182,14 @@ void Dictionary::_ref(const Dictionary &p_from) const {
 
 void Dictionary::clear() {
 
+	_make_writable();
 	_p->variant_map.clear();
 }
 
 void Dictionary::_unref() const {
 
 	ERR_FAIL_COND(!_p);
-	if (_p->refcount.unref()) {
+	if (_p != &_empty_private && _p->refcount.unref()) {
 		memdelete(_p);
 	}
 	_p = NULL;
@@ -192,13 +198,10 @@ uint32_t Dictionary::hash() const {
 
 	uint32_t h = hash_djb2_one_32(Variant::DICTIONARY);
 
-	List<Variant> keys;
-	get_key_list(&keys);
-
-	for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+	for (int i = _p->variant_map.next_pos(-1); i >= 0; i = _p->variant_map.next_pos(i)) {
 
-		h = hash_djb2_one_32(E->get().hash(), h);
-		h = hash_djb2_one_32(operator[](E->get()).hash(), h);
+		h = hash_djb2_one_32(_p->variant_map.key_at(i).hash(), h);
+		h = hash_djb2_one_32(_p->variant_map.value_at(i).hash(), h);
 	}
 
 	return h;
@@ -211,10 +214,9 @@ Array Dictionary::keys() const {
 	if (_p->variant_map.empty())
 		return varr;
 
-	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		varr[i] = E.key();
-		i++;
+	int idx = 0;
+	for (int i = _p->variant_map.next_pos(-1); i >= 0; i = _p->variant_map.next_pos(i)) {
+		varr[idx++] = _p->variant_map.key_at(i);
 	}
 
 	return varr;
@@ -227,10 +229,9 @@ Array Dictionary::values() const {
 	if (_p->variant_map.empty())
 		return varr;
 
-	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		varr[i] = E.get();
-		i++;
+	int idx = 0;
+	for (int i = _p->variant_map.next_pos(-1); i >= 0; i = _p->variant_map.next_pos(i)) {
+		varr[idx++] = _p->variant_map.value_at(i);
 	}
 
 	return varr;
@@ -238,28 +239,24 @@ Array Dictionary::values() const {
 
 const Variant *Dictionary::next(const Variant *p_key) const {
 
-	if (p_key == NULL) {
-		// caller wants to get the first element
-		if (_p->variant_map.front())
-			return &_p->variant_map.front().key();
+	// a NULL key means the caller wants to get the first element
+	int pos = p_key ? _p->variant_map.find_pos(*p_key) : -1;
+	if (p_key && pos < 0)
 		return NULL;
-	}
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(*p_key);
 
-	if (E && E.next())
-		return &E.next().key();
-	return NULL;
+	pos = _p->variant_map.next_pos(pos);
+	if (pos < 0)
+		return NULL;
+	return &_p->variant_map.key_at(pos);
 }
 
 Dictionary Dictionary::duplicate(bool p_deep) const {
 
 	Dictionary n;
 
-	List<Variant> keys;
-	get_key_list(&keys);
-
-	for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
-		n[E->get()] = p_deep ? operator[](E->get()).duplicate(p_deep) : operator[](E->get());
+	for (int i = _p->variant_map.next_pos(-1); i >= 0; i = _p->variant_map.next_pos(i)) {
+		const Variant &value = _p->variant_map.value_at(i);
+		n[_p->variant_map.key_at(i)] = p_deep ? value.duplicate(p_deep) : value;
 	}
 
 	return n;
@@ -270,8 +267,17 @@ void Dictionary::operator=(const Dictionary &p_dictionary) {
 	_ref(p_dictionary);
 }
 
+void Dictionary::operator=(Dictionary &&p_dictionary) {
+
+	if (p_dictionary._p == _p)
+		return;
+	_unref();
+	_p = p_dictionary._p;
+	p_dictionary._p = &_empty_private;
+}
+
 const void *Dictionary::id() const {
-	return _p->variant_map.id();
+	return _p;
 }
 
 Dictionary::Dictionary(const Dictionary &p_from) {
@@ -279,6 +285,13 @@ Dictionary::Dictionary(const Dictionary &p_from) {
 	_ref(p_from);
 }
 
+Dictionary::Dictionary(Dictionary &&p_from) {
+
+	// the moved-from dictionary is left empty, but still usable
+	_p = p_from._p;
+	p_from._p = &_empty_private;
+}
+
 Dictionary::Dictionary() {
 
 	_p = memnew(DictionaryPrivate);
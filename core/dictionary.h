@@ -45,6 +45,7 @@ class Dictionary {
 
 	void _ref(const Dictionary &p_from) const;
 	void _unref() const;
+	void _make_writable();
 
 public:
 	void get_key_list(List<Variant> *p_keys) const;
@@ -74,6 +75,7 @@ public:
 
 	uint32_t hash() const;
 	void operator=(const Dictionary &p_dictionary);
+	void operator=(Dictionary &&p_dictionary);
 
 	const Variant *next(const Variant *p_key = NULL) const;
 
@@ -85,6 +87,7 @@ public:
 	const void *id() const;
 
 	Dictionary(const Dictionary &p_from);
+	Dictionary(Dictionary &&p_from);
 	Dictionary();
 	~Dictionary();
 };
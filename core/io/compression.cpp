@@ -33,6 +33,7 @@
 #include "core/io/zip_io.h"
 #include "core/os/copymem.h"
 #include "core/project_settings.h"
+#include "core/sort_array.h"
 
 #include "thirdparty/misc/fastlz.h"
 
@@ -187,6 +188,225 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 	ERR_FAIL_V(-1);
 }
 
+struct Compression::ZstdDictionary {
+
+	ZSTD_CDict *cdict;
+	ZSTD_DDict *ddict;
+};
+
+struct Compression::ZstdContext {
+
+	ZSTD_CCtx *cctx;
+	ZSTD_DCtx *dctx;
+};
+
+Compression::ZstdDictionary *Compression::zstd_create_dictionary(const uint8_t *p_dict, int p_dict_size, bool p_compress) {
+
+	ZstdDictionary *dict = memnew(ZstdDictionary);
+	dict->cdict = p_compress ? ZSTD_createCDict(p_dict, p_dict_size, zstd_level) : NULL;
+	dict->ddict = p_compress ? NULL : ZSTD_createDDict(p_dict, p_dict_size);
+	if (!dict->cdict && !dict->ddict) {
+		memdelete(dict);
+		ERR_FAIL_V(NULL);
+	}
+	return dict;
+}
+
+void Compression::zstd_free_dictionary(ZstdDictionary *p_dict) {
+
+	if (!p_dict)
+		return;
+	ZSTD_freeCDict(p_dict->cdict);
+	ZSTD_freeDDict(p_dict->ddict);
+	memdelete(p_dict);
+}
+
+Compression::ZstdContext *Compression::zstd_create_context() {
+
+	// the zstd contexts are created on first use, so a context only used to decompress doesn't hold compression buffers
+	ZstdContext *context = memnew(ZstdContext);
+	context->cctx = NULL;
+	context->dctx = NULL;
+	return context;
+}
+
+void Compression::zstd_free_context(ZstdContext *p_context) {
+
+	if (!p_context)
+		return;
+	ZSTD_freeCCtx(p_context->cctx);
+	ZSTD_freeDCtx(p_context->dctx);
+	memdelete(p_context);
+}
+
+int Compression::compress_with_dictionary(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, ZstdContext *p_context, const ZstdDictionary *p_dict) {
+
+	ERR_FAIL_COND_V(!p_context || (p_dict && !p_dict->cdict), -1);
+
+	if (!p_context->cctx) {
+		p_context->cctx = ZSTD_createCCtx();
+		ERR_FAIL_COND_V(!p_context->cctx, -1);
+	}
+
+	int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
+	size_t ret;
+	if (p_dict) {
+		ret = ZSTD_compress_usingCDict(p_context->cctx, p_dst, max_dst_size, p_src, p_src_size, p_dict->cdict);
+	} else {
+		ret = ZSTD_compressCCtx(p_context->cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
+	}
+	ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+	return ret;
+}
+
+int Compression::decompress_with_dictionary(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, ZstdContext *p_context, const ZstdDictionary *p_dict) {
+
+	ERR_FAIL_COND_V(!p_context || (p_dict && !p_dict->ddict), -1);
+
+	if (!p_context->dctx) {
+		p_context->dctx = ZSTD_createDCtx();
+		ERR_FAIL_COND_V(!p_context->dctx, -1);
+		if (zstd_long_distance_matching) {
+			ZSTD_DCtx_setParameter(p_context->dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
+		}
+	}
+
+	size_t ret;
+	if (p_dict) {
+		ret = ZSTD_decompress_usingDDict(p_context->dctx, p_dst, p_dst_max_size, p_src, p_src_size, p_dict->ddict);
+	} else {
+		ret = ZSTD_decompressDCtx(p_context->dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+	}
+	ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+	return ret;
+}
+
+struct _DictionarySegment {
+
+	int sample;
+	int offset;
+	int size;
+	uint64_t score;
+
+	bool operator<(const _DictionarySegment &p_segment) const {
+		if (score != p_segment.score)
+			return score > p_segment.score; // best first
+		if (sample != p_segment.sample)
+			return sample < p_segment.sample;
+		return offset < p_segment.offset;
+	}
+};
+
+enum {
+	DICTIONARY_KMER = 8, // bytes looked at together when searching for content shared between samples
+	DICTIONARY_SEGMENT = 1024,
+	DICTIONARY_TABLE_BITS = 20,
+};
+
+static _FORCE_INLINE_ uint32_t _dictionary_kmer_hash(const uint8_t *p_data) {
+
+	uint64_t v;
+	copymem(&v, p_data, sizeof(v));
+	return (v * 0x9E3779B97F4A7C15ULL) >> (64 - DICTIONARY_TABLE_BITS);
+}
+
+Vector<uint8_t> Compression::train_dictionary(const Vector<Vector<uint8_t> > &p_samples, int p_max_size) {
+
+	// The bundled zstd does not include its dictionary builder, so this picks
+	// the sample segments with the most content found in other samples too
+	// and uses them as a raw content dictionary, roughly like zstd's COVER
+	// algorithm does. The best segments go last, where matches are cheapest.
+
+	Vector<uint8_t> dictionary;
+	ERR_FAIL_COND_V(p_max_size <= 0, dictionary);
+
+	// in how many samples each k-mer shows up
+	Vector<uint16_t> counts;
+	Vector<uint32_t> last_sample;
+	counts.resize(1 << DICTIONARY_TABLE_BITS);
+	last_sample.resize(1 << DICTIONARY_TABLE_BITS);
+	uint16_t *c = counts.ptrw();
+	uint32_t *l = last_sample.ptrw();
+	zeromem(c, counts.size() * sizeof(uint16_t));
+	for (int i = 0; i < last_sample.size(); i++) {
+		l[i] = 0xFFFFFFFF;
+	}
+
+	for (int i = 0; i < p_samples.size(); i++) {
+
+		const uint8_t *r = p_samples[i].ptr();
+		for (int j = 0; j + DICTIONARY_KMER <= p_samples[i].size(); j++) {
+
+			uint32_t h = _dictionary_kmer_hash(r + j);
+			if (l[h] != uint32_t(i)) {
+				l[h] = i;
+				if (c[h] < 0xFFFF)
+					c[h]++;
+			}
+		}
+	}
+	last_sample.clear();
+
+	Vector<_DictionarySegment> segments;
+	for (int i = 0; i < p_samples.size(); i++) {
+
+		for (int j = 0; j + DICTIONARY_KMER <= p_samples[i].size(); j += DICTIONARY_SEGMENT) {
+
+			_DictionarySegment segment;
+			segment.sample = i;
+			segment.offset = j;
+			segment.size = MIN(int(DICTIONARY_SEGMENT), p_samples[i].size() - j);
+			segment.score = 0;
+
+			const uint8_t *r = p_samples[i].ptr() + j;
+			for (int k = 0; k + DICTIONARY_KMER <= segment.size; k++) {
+				segment.score += c[_dictionary_kmer_hash(r + k)] - 1;
+			}
+			if (segment.score > 0) {
+				segments.push_back(segment);
+			}
+		}
+	}
+
+	segments.sort();
+
+	Vector<const _DictionarySegment *> picked;
+	int size = 0;
+	for (int i = 0; i < segments.size() && size < p_max_size; i++) {
+
+		// content already picked doesn't count again
+		const _DictionarySegment &segment = segments[i];
+		const uint8_t *r = p_samples[segment.sample].ptr() + segment.offset;
+		uint64_t score = 0;
+		for (int k = 0; k + DICTIONARY_KMER <= segment.size; k++) {
+			score += c[_dictionary_kmer_hash(r + k)] - 1;
+		}
+		if (score == 0 || score * 2 < segment.score)
+			continue;
+
+		for (int k = 0; k + DICTIONARY_KMER <= segment.size; k++) {
+			c[_dictionary_kmer_hash(r + k)] = 1;
+		}
+		picked.push_back(&segment);
+		size += segment.size;
+	}
+
+	size = MIN(size, p_max_size);
+	if (size < DICTIONARY_KMER)
+		return dictionary; // nothing in common, a dictionary won't help
+
+	dictionary.resize(size);
+	uint8_t *w = dictionary.ptrw() + size;
+	for (int i = 0; i < picked.size() && w > dictionary.ptr(); i++) {
+
+		int len = MIN(picked[i]->size, int(w - dictionary.ptr()));
+		w -= len;
+		copymem(w, p_samples[picked[i]->sample].ptr() + picked[i]->offset, len);
+	}
+
+	return dictionary;
+}
+
 int Compression::zlib_level = Z_DEFAULT_COMPRESSION;
 int Compression::gzip_level = Z_DEFAULT_COMPRESSION;
 int Compression::zstd_level = 3;
@@ -32,6 +32,7 @@
 #define COMPRESSION_H
 
 #include "core/typedefs.h"
+#include "core/vector.h"
 
 class Compression {
 
@@ -53,6 +54,23 @@ public:
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
 
+	// Zstandard with a dictionary, which helps a lot with small buffers that
+	// are similar to each other. The same dictionary is needed to decompress.
+	// A dictionary is digested once and can be shared between threads, while
+	// a context keeps its buffers between calls and is used by one thread at
+	// a time. Without a dictionary this is plain zstd on a reused context.
+	struct ZstdDictionary;
+	struct ZstdContext;
+
+	static ZstdDictionary *zstd_create_dictionary(const uint8_t *p_dict, int p_dict_size, bool p_compress);
+	static void zstd_free_dictionary(ZstdDictionary *p_dict);
+	static ZstdContext *zstd_create_context();
+	static void zstd_free_context(ZstdContext *p_context);
+
+	static int compress_with_dictionary(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, ZstdContext *p_context, const ZstdDictionary *p_dict);
+	static int decompress_with_dictionary(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, ZstdContext *p_context, const ZstdDictionary *p_dict);
+	static Vector<uint8_t> train_dictionary(const Vector<Vector<uint8_t> > &p_samples, int p_max_size);
+
 	Compression();
 };
 
@@ -166,6 +166,18 @@ int FileAccessMemory::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::get_buffer_direct(int p_length) const {
+
+	ERR_FAIL_COND_V(!data, NULL);
+
+	if (p_length < 0 || p_length > length - pos)
+		return NULL;
+
+	const uint8_t *ptr = &data[pos];
+	pos += p_length;
+	return ptr;
+}
+
 Error FileAccessMemory::get_error() const {
 
 	return pos >= length ? ERR_FILE_EOF : OK;
@@ -30,6 +30,10 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/os/copymem.h"
+#include "core/sort_array.h"
 #include "core/version.h"
 
 #include <stdio.h>
@@ -38,6 +42,8 @@
 
 Error PackedData::add_pack(const String &p_path) {
 
+	mount_count++;
+
 	for (int i = 0; i < sources.size(); i++) {
 
 		if (sources[i]->try_open_pack(p_path)) {
@@ -49,7 +55,7 @@ Error PackedData::add_pack(const String &p_path) {
 	return ERR_FILE_UNRECOGNIZED;
 };
 
-void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src) {
+void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, FileAccess *p_mapped_pack, const PackCompression *p_compression) {
 
 	PathMD5 pmd5(path.md5_buffer());
 	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
@@ -63,38 +69,354 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	for (int i = 0; i < 16; i++)
 		pf.md5[i] = p_md5[i];
 	pf.src = p_src;
+	pf.mapped_pack = p_mapped_pack;
+	pf.mount = mount_count;
+	pf.compression = p_compression;
 
 	files[pmd5] = pf;
 
 	if (!exists) {
-		//search for dir
-		String p = path.replace_first("res://", "");
-		PackedDir *cd = root;
+		dir_mutex->lock();
+		_add_dir_path(path);
+		dir_mutex->unlock();
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_path) {
+
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
+
+	if (p.find("/") != -1) { //in a subdir
+
+		Vector<String> ds = p.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+
+			if (!cd->subdirs.has(ds[j])) {
+
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
+			}
+		}
+	}
+	String filename = p_path.get_file();
+	// Don't add as a file if the path points to a directoryy
+	if (!filename.empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+
+	// the directory tree is only needed to list packed directories, so
+	// indexed packs are added to it the first time somebody asks for it
+	dir_mutex->lock();
+	for (; indices_in_dirs < indices.size(); indices_in_dirs++) {
+
+		const PackIndex *index = indices[indices_in_dirs];
+		for (uint32_t i = 0; i < index->file_count; i++) {
+
+			String path;
+			path.parse_utf8(index->strings + index->entries[i].path_offset, index->entries[i].path_length);
+			_add_dir_path(path);
+		}
+	}
+	dir_mutex->unlock();
+
+	return root;
+}
+
+uint64_t PackedData::hash_path_utf8(const char *p_path, int p_len) {
+
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < p_len; i++) {
+		hash = (hash ^ uint8_t(p_path[i])) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t PackedData::hash_path(const String &p_path) {
+
+	// same as hash_path_utf8(p_path.utf8()), encoding on the fly so lookups don't allocate
+	uint64_t hash = 14695981039346656037ULL;
+	const CharType *c = p_path.c_str();
+	int len = p_path.length();
+
+	for (int i = 0; i < len; i++) {
+
+		uint32_t cp = c[i];
+		if (sizeof(CharType) == 2 && cp >= 0xD800 && cp < 0xDC00 && i + 1 < len && uint32_t(c[i + 1]) >= 0xDC00 && uint32_t(c[i + 1]) < 0xE000) {
+			cp = 0x10000 + ((cp - 0xD800) << 10) + (uint32_t(c[i + 1]) - 0xDC00);
+			i++;
+		}
+
+		uint8_t bytes[4];
+		int count;
+		if (cp < 0x80) {
+			bytes[0] = cp;
+			count = 1;
+		} else if (cp < 0x800) {
+			bytes[0] = 0xC0 | (cp >> 6);
+			bytes[1] = 0x80 | (cp & 0x3F);
+			count = 2;
+		} else if (cp < 0x10000) {
+			bytes[0] = 0xE0 | (cp >> 12);
+			bytes[1] = 0x80 | ((cp >> 6) & 0x3F);
+			bytes[2] = 0x80 | (cp & 0x3F);
+			count = 3;
+		} else {
+			bytes[0] = 0xF0 | ((cp >> 18) & 0x07);
+			bytes[1] = 0x80 | ((cp >> 12) & 0x3F);
+			bytes[2] = 0x80 | ((cp >> 6) & 0x3F);
+			bytes[3] = 0x80 | (cp & 0x3F);
+			count = 4;
+		}
+
+		for (int j = 0; j < count; j++) {
+			hash = (hash ^ bytes[j]) * 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
+
+static uint32_t _get_index_bucket_bits(int p_file_count) {
+
+	uint32_t bits = 0;
+	while ((1 << bits) < p_file_count && bits < 24) {
+		bits++;
+	}
+	return bits;
+}
+
+uint64_t PackedData::get_index_size(int p_file_count, uint64_t p_strings_size) {
+
+	uint32_t bucket_count = 1 << _get_index_bucket_bits(p_file_count);
+	return sizeof(IndexHeader) + sizeof(IndexEntry) * p_file_count + sizeof(uint32_t) * (bucket_count + 1) + p_strings_size;
+}
+
+struct _IndexEntrySort {
+
+	bool operator()(const PackedData::IndexEntry &p_a, const PackedData::IndexEntry &p_b) const {
+		return p_a.hash < p_b.hash;
+	}
+};
+
+Vector<uint8_t> PackedData::make_index(const Vector<IndexedFile> &p_files) {
+
+	uint64_t strings_size = 0;
+	for (int i = 0; i < p_files.size(); i++) {
+		strings_size += p_files[i].path.length();
+	}
+
+	Vector<uint8_t> index;
+	index.resize(get_index_size(p_files.size(), strings_size));
+	uint8_t *w = index.ptrw();
+
+	IndexHeader *header = (IndexHeader *)w;
+	header->magic = INDEX_MAGIC;
+	header->file_count = p_files.size();
+	header->bucket_bits = _get_index_bucket_bits(p_files.size());
+	header->strings_size = strings_size;
+
+	IndexEntry *entries = (IndexEntry *)(w + sizeof(IndexHeader));
+	uint32_t bucket_count = 1 << header->bucket_bits;
+	uint32_t *buckets = (uint32_t *)(entries + p_files.size());
+	char *strings = (char *)(buckets + bucket_count + 1);
+
+	uint32_t string_ofs = 0;
+	for (int i = 0; i < p_files.size(); i++) {
+
+		const IndexedFile &file = p_files[i];
+		IndexEntry &entry = entries[i];
+		entry.hash = hash_path_utf8(file.path.get_data(), file.path.length());
+		entry.offset = file.offset;
+		entry.size = file.size;
+		entry.path_offset = string_ofs;
+		entry.path_length = file.path.length();
+		copymem(entry.md5, file.md5, 16);
+
+		copymem(strings + string_ofs, file.path.get_data(), file.path.length());
+		string_ofs += file.path.length();
+	}
+
+	SortArray<IndexEntry, _IndexEntrySort> sorter;
+	sorter.sort(entries, p_files.size());
+
+	// buckets[b] is the first entry whose hash falls in bucket b or later
+	uint32_t e = 0;
+	for (uint32_t b = 0; b < bucket_count; b++) {
+		while (e < header->file_count && (header->bucket_bits ? entries[e].hash >> (64 - header->bucket_bits) : 0) < b) {
+			e++;
+		}
+		buckets[b] = e;
+	}
+	buckets[bucket_count] = header->file_count;
+
+	return index;
+}
+
+Vector<uint8_t> PackedData::make_dictionary(const Vector<Vector<uint8_t> > &p_samples) {
+
+	return Compression::train_dictionary(p_samples, DICTIONARY_SIZE);
+}
+
+uint64_t PackedData::store_chunked(FileAccess *p_dst, FileAccess *p_src, uint64_t p_size, Compression::ZstdContext *p_context, const Compression::ZstdDictionary *p_dictionary) {
+
+	uint32_t chunk_count = (p_size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	uint64_t start = p_dst->get_position();
+
+	p_dst->store_32(CHUNK_SIZE);
+	p_dst->store_32(chunk_count);
+	uint64_t table_pos = p_dst->get_position();
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		p_dst->store_32(0); // filled in below
+	}
+
+	Vector<uint8_t> src;
+	Vector<uint8_t> dst;
+	Vector<uint32_t> ends;
+	src.resize(CHUNK_SIZE);
+	dst.resize(Compression::get_max_compressed_buffer_size(CHUNK_SIZE, Compression::MODE_ZSTD));
+	ends.resize(chunk_count);
+
+	uint64_t end = 0;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+
+		int size = MIN(uint64_t(CHUNK_SIZE), p_size - uint64_t(i) * CHUNK_SIZE);
+		p_src->get_buffer(src.ptrw(), size);
+
+		int compressed = Compression::compress_with_dictionary(dst.ptrw(), src.ptr(), size, p_context, p_dictionary);
+
+		if (compressed > 0 && compressed < size) {
+			p_dst->store_buffer(dst.ptr(), compressed);
+			end += compressed;
+		} else {
+			p_dst->store_buffer(src.ptr(), size); // same size as the chunk, so it's read as is
+			end += size;
+		}
+
+		ERR_FAIL_COND_V(end > 0xFFFFFFFF, 0);
+		ends.write[i] = end;
+	}
+
+	uint64_t end_pos = p_dst->get_position();
+	p_dst->seek(table_pos);
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		p_dst->store_32(ends[i]);
+	}
+	p_dst->seek(end_pos);
+
+	return end_pos - start;
+}
+
+bool PackedData::add_index(const String &p_pack, const uint8_t *p_index, uint64_t p_size, const Vector<uint8_t> &p_buffer, PackSource *p_src, FileAccess *p_mapped_pack, const PackCompression *p_compression) {
+
+	ERR_FAIL_COND_V(p_size < sizeof(IndexHeader), false);
+	const IndexHeader *header = (const IndexHeader *)p_index;
+	ERR_FAIL_COND_V(header->magic != INDEX_MAGIC, false);
+	ERR_FAIL_COND_V(header->bucket_bits > 24, false);
+	ERR_FAIL_COND_V(get_index_size(header->file_count, header->strings_size) != p_size || _get_index_bucket_bits(header->file_count) != header->bucket_bits, false);
+
+	PackIndex *index = memnew(PackIndex);
+	index->pack = p_pack;
+	index->src = p_src;
+	index->mapped_pack = p_mapped_pack;
+	index->mount = mount_count;
+	index->compression = p_compression;
+	index->buffer = p_buffer; // shares the data, keeps p_index valid
+	index->file_count = header->file_count;
+	index->bucket_bits = header->bucket_bits;
+	index->entries = (const IndexEntry *)(p_index + sizeof(IndexHeader));
+	index->buckets = (const uint32_t *)(index->entries + index->file_count);
+	index->strings = (const char *)(index->buckets + (1 << index->bucket_bits) + 1);
+
+	indices.push_back(index);
+	return true;
+}
+
+const PackedData::IndexEntry *PackedData::_find_indexed(const String &p_path, PackIndex **r_index) const {
+
+	if (indices.empty())
+		return NULL;
+
+	uint64_t hash = hash_path(p_path);
 
-		if (p.find("/") != -1) { //in a subdir
+	// later packs override earlier ones
+	for (int i = indices.size() - 1; i >= 0; i--) {
 
-			Vector<String> ds = p.get_base_dir().split("/");
+		const PackIndex *index = indices[i];
+		uint32_t bucket = index->bucket_bits ? hash >> (64 - index->bucket_bits) : 0;
+		const IndexEntry *end = index->entries + index->buckets[bucket + 1];
 
-			for (int j = 0; j < ds.size(); j++) {
+		for (const IndexEntry *e = index->entries + index->buckets[bucket]; e < end && e->hash <= hash; e++) {
 
-				if (!cd->subdirs.has(ds[j])) {
+			if (e->hash != hash)
+				continue;
 
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
+			// hashes can collide, compare the actual path too
+			const char *str = index->strings + e->path_offset;
+			const CharType *c = p_path.c_str();
+			bool equal = true;
+			uint32_t j = 0;
+			for (; j < e->path_length && *c; j++, c++) {
+				if (uint8_t(str[j]) >= 0x80) {
+					// not ASCII, decode it
+					String path;
+					path.parse_utf8(str, e->path_length);
+					equal = path == p_path;
+					j = e->path_length;
+					c = p_path.c_str() + p_path.length();
+					break;
 				}
+				if (CharType(str[j]) != *c) {
+					equal = false;
+					break;
+				}
+			}
+			if (equal && j == e->path_length && *c == 0) {
+				*r_index = indices[i];
+				return e;
 			}
 		}
-		String filename = path.get_file();
-		// Don't add as a file if the path points to a directoryy
-		if (!filename.empty()) {
-			cd->files.insert(filename);
+	}
+
+	return NULL;
+}
+
+PackedData::PackedFile *PackedData::_find_file(const String &p_path, PackedFile *r_indexed) {
+
+	PackIndex *index = NULL;
+	const IndexEntry *entry = _find_indexed(p_path, &index);
+
+	PackedFile *legacy = NULL;
+	if (!files.empty()) {
+		Map<PathMD5, PackedFile>::Element *E = files.find(PathMD5(p_path.md5_buffer()));
+		if (E) {
+			legacy = &E->get();
 		}
 	}
+
+	if (!entry || (legacy && legacy->mount > index->mount))
+		return legacy;
+
+	r_indexed->pack = index->pack;
+	r_indexed->offset = entry->offset;
+	r_indexed->size = entry->size;
+	copymem(r_indexed->md5, entry->md5, 16);
+	r_indexed->src = index->src;
+	r_indexed->mapped_pack = index->mapped_pack;
+	r_indexed->mount = index->mount;
+	r_indexed->compression = index->compression;
+	return r_indexed;
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -112,6 +434,9 @@ PackedData::PackedData() {
 	root = memnew(PackedDir);
 	root->parent = NULL;
 	disabled = false;
+	mount_count = 0;
+	indices_in_dirs = 0;
+	dir_mutex = Mutex::create();
 
 	add_pack_source(memnew(PackedSourcePCK));
 }
@@ -128,7 +453,11 @@ PackedData::~PackedData() {
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
+	for (int i = 0; i < indices.size(); i++) {
+		memdelete(indices[i]);
+	}
 	_free_packed_dirs(root);
+	memdelete(dir_mutex);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -166,22 +495,103 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		}
 	}
 
+	uint64_t pack_start = f->get_position() - 4;
+
 	uint32_t version = f->get_32();
 	uint32_t ver_major = f->get_32();
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // ver_rev
 
 	ERR_EXPLAIN("Pack version unsupported: " + itos(version));
-	ERR_FAIL_COND_V(version != PACK_VERSION, false);
+	ERR_FAIL_COND_V(version != PACK_VERSION && version != PackedData::PACK_VERSION_CHUNKED, false);
 	ERR_EXPLAIN("Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor));
 	ERR_FAIL_COND_V(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false);
 
-	for (int i = 0; i < 16; i++) {
+	uint64_t index_offset = f->get_32();
+	index_offset |= uint64_t(f->get_32()) << 32;
+
+	uint32_t flags = f->get_32();
+	uint64_t dictionary_offset = f->get_32();
+	dictionary_offset |= uint64_t(f->get_32()) << 32;
+	uint32_t dictionary_size = f->get_32();
+
+	for (int i = 6; i < 16; i++) {
 		//reserved
 		f->get_32();
 	}
 
 	int file_count = f->get_32();
+	uint64_t entries_pos = f->get_position();
+
+	// keep the pack open and mapped when the platform allows it, so files inside can be read without going through the OS
+	FileAccess *mapped_pack = f->map_contents() ? f : NULL;
+
+	PackedData::PackCompression *compression = NULL;
+	if (version == PackedData::PACK_VERSION_CHUNKED && (flags & PackedData::PACK_FLAG_CHUNKED_ZSTD)) {
+
+		compression = memnew(PackedData::PackCompression);
+		compressions.push_back(compression);
+
+		if (dictionary_size) {
+			if (pack_start + dictionary_offset + dictionary_size > f->get_len()) {
+				memdelete(f);
+				ERR_EXPLAIN("Invalid compression dictionary in pack: " + p_path);
+				ERR_FAIL_V(false);
+			}
+			// digested once here, so opening and seeking files doesn't do it for every chunk
+			Vector<uint8_t> dictionary;
+			dictionary.resize(dictionary_size);
+			f->seek(pack_start + dictionary_offset);
+			f->get_buffer(dictionary.ptrw(), dictionary_size);
+			f->seek(entries_pos);
+			compression->dictionary = Compression::zstd_create_dictionary(dictionary.ptr(), dictionary_size, false);
+			if (!compression->dictionary) {
+				memdelete(f);
+				ERR_EXPLAIN("Invalid compression dictionary in pack: " + p_path);
+				ERR_FAIL_V(false);
+			}
+		}
+	}
+
+#ifndef BIG_ENDIAN_ENABLED
+	if (index_offset) {
+
+		// the flat index is stored in host layout, use it instead of going through the file entries
+		uint64_t index_pos = pack_start + index_offset;
+		PackedData::IndexHeader header;
+		f->seek(index_pos);
+		f->get_buffer((uint8_t *)&header, sizeof(header));
+
+		uint64_t index_size = PackedData::get_index_size(header.file_count, header.strings_size);
+		bool indexed = false;
+
+		if (header.magic == PackedData::INDEX_MAGIC && int(header.file_count) == file_count && index_pos + index_size <= f->get_len()) {
+
+			if (mapped_pack) {
+				indexed = PackedData::get_singleton()->add_index(p_path, f->map_contents() + index_pos, index_size, Vector<uint8_t>(), this, mapped_pack, compression);
+			} else {
+				Vector<uint8_t> buffer;
+				buffer.resize(index_size);
+				f->seek(index_pos);
+				if (f->get_buffer(buffer.ptrw(), index_size) == int(index_size)) {
+					indexed = PackedData::get_singleton()->add_index(p_path, buffer.ptr(), index_size, buffer, this, NULL, compression);
+				}
+			}
+		}
+
+		if (indexed) {
+			if (mapped_pack) {
+				mapped_packs.push_back(mapped_pack);
+			} else {
+				memdelete(f);
+			}
+			return true;
+		}
+
+		WARN_PRINTS("Invalid file index in pack, reading file entries instead: " + p_path);
+		f->seek(entries_pos);
+	}
+#endif
 
 	for (int i = 0; i < file_count; i++) {
 
@@ -198,9 +608,15 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		uint64_t size = f->get_64();
 		uint8_t md5[16];
 		f->get_buffer(md5, 16);
-		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
+		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, mapped_pack, compression);
 	};
 
+	if (mapped_pack) {
+		mapped_packs.push_back(mapped_pack);
+	} else {
+		memdelete(f);
+	}
+
 	return true;
 };
 
@@ -209,6 +625,16 @@ FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFi
 	return memnew(FileAccessPack(p_path, *p_file));
 };
 
+PackedSourcePCK::~PackedSourcePCK() {
+
+	for (int i = 0; i < mapped_packs.size(); i++) {
+		memdelete(mapped_packs[i]);
+	}
+	for (int i = 0; i < compressions.size(); i++) {
+		memdelete(compressions[i]);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -217,14 +643,99 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 	return ERR_UNAVAILABLE;
 }
 
+bool FileAccessPack::_open_chunked() {
+
+	const uint8_t *table = NULL;
+	uint32_t count;
+
+	if (pf.mapped_pack) {
+		ERR_FAIL_COND_V(pf.offset + 8 > pf.mapped_pack->get_len(), false);
+		table = pf.mapped_pack->map_contents() + pf.offset;
+		chunk_size = decode_uint32(table);
+		count = decode_uint32(table + 4);
+		ERR_FAIL_COND_V(pf.offset + 8 + uint64_t(count) * 4 > pf.mapped_pack->get_len(), false);
+	} else {
+		f->seek(pf.offset);
+		chunk_size = f->get_32();
+		count = f->get_32();
+	}
+
+	ERR_FAIL_COND_V(chunk_size == 0 || count != (pf.size + chunk_size - 1) / chunk_size, false);
+
+	chunk_ends.resize(count);
+	uint32_t *w = chunk_ends.ptrw();
+	uint32_t prev = 0;
+	for (uint32_t i = 0; i < count; i++) {
+
+		w[i] = table ? decode_uint32(table + 8 + i * 4) : f->get_32();
+		ERR_FAIL_COND_V(w[i] < prev || w[i] - prev > chunk_size, false);
+		prev = w[i];
+	}
+
+	chunks_offset = pf.offset + 8 + uint64_t(count) * 4;
+
+	if (pf.mapped_pack) {
+		ERR_FAIL_COND_V(chunks_offset + prev > pf.mapped_pack->get_len(), false);
+		chunks = pf.mapped_pack->map_contents() + chunks_offset;
+		pf.mapped_pack->prefetch(chunks_offset, MIN(uint64_t(prev), (uint64_t)PREFETCH_MAX));
+	}
+
+	return true;
+}
+
+bool FileAccessPack::_load_chunk(int p_index) const {
+
+	if (p_index == chunk_index)
+		return true;
+
+	ERR_FAIL_INDEX_V(p_index, chunk_ends.size(), false);
+
+	uint32_t from = p_index ? chunk_ends[p_index - 1] : 0;
+	int stored = chunk_ends[p_index] - from;
+	int size = MIN(uint64_t(chunk_size), pf.size - uint64_t(p_index) * chunk_size);
+
+	const uint8_t *src;
+	if (chunks) {
+		src = chunks + from;
+	} else {
+		if (chunk_buffer.size() < stored)
+			chunk_buffer.resize(stored);
+		f->seek(chunks_offset + from);
+		ERR_FAIL_COND_V(f->get_buffer(chunk_buffer.ptrw(), stored) != stored, false);
+		src = chunk_buffer.ptr();
+	}
+
+	chunk_index = -1;
+	chunk.resize(size);
+
+	if (stored == size) {
+		copymem(chunk.ptrw(), src, size); // did not compress
+	} else {
+		if (!zstd_context) {
+			zstd_context = Compression::zstd_create_context();
+		}
+		int got = Compression::decompress_with_dictionary(chunk.ptrw(), size, src, stored, zstd_context, pf.compression->dictionary);
+		ERR_EXPLAIN("Corrupt compressed data in pack: " + pf.pack);
+		ERR_FAIL_COND_V(got != size, false);
+	}
+
+	chunk_index = p_index;
+	return true;
+}
+
 void FileAccessPack::close() {
 
-	f->close();
+	if (f)
+		f->close();
+	data = NULL;
+	chunks = NULL;
 }
 
 bool FileAccessPack::is_open() const {
 
-	return f->is_open();
+	if (data || chunks)
+		return true;
+	return f && f->is_open();
 }
 
 void FileAccessPack::seek(size_t p_position) {
@@ -235,7 +746,8 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (!data && !chunked)
+		f->seek(pf.offset + p_position);
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -263,17 +775,31 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data)
+		return data[pos++];
+
+	if (chunked) {
+		if (!_load_chunk(pos / chunk_size)) {
+			eof = true;
+			return 0;
+		}
+		return chunk[pos++ % chunk_size];
+	}
+
 	pos++;
 	return f->get_8();
 }
 
 int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 
+	ERR_FAIL_COND_V(p_length < 0, -1);
+
 	if (eof)
 		return 0;
 
-	uint64_t to_read = p_length;
-	if (to_read + pos > pf.size) {
+	//signed, so reading from past the end comes out negative
+	int64_t to_read = p_length;
+	if (int64_t(pos) + to_read > int64_t(pf.size)) {
 		eof = true;
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
@@ -282,14 +808,62 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
 
-	return to_read;
+	if (data) {
+		const uint8_t *src = data + pos - p_length;
+		if (to_read >= PREFETCH_MIN) {
+			pf.mapped_pack->prefetch(pf.offset + pos - p_length, to_read);
+		}
+		copymem(p_dst, src, to_read);
+		return to_read;
+	}
+
+	if (chunked) {
+		uint64_t from = pos - p_length;
+		int64_t done = 0;
+		while (done < to_read) {
+			if (!_load_chunk((from + done) / chunk_size)) {
+				eof = true;
+				break;
+			}
+			int ofs = (from + done) % chunk_size;
+			int len = MIN(to_read - done, int64_t(chunk.size() - ofs));
+			copymem(p_dst + done, chunk.ptr() + ofs, len);
+			done += len;
+		}
+		return done;
+	}
+
+	//the pack may end before the file does, see the constructor
+	return f->get_buffer(p_dst, to_read);
+}
+
+const uint8_t *FileAccessPack::get_buffer_direct(int p_length) const {
+
+	if (eof || p_length < 0 || pos + p_length > pf.size)
+		return NULL;
+
+	if (chunked) {
+		// only valid until the next read, which may decompress another chunk
+		uint32_t ofs = pos % chunk_size;
+		if (p_length == 0 || ofs + p_length > chunk_size || !_load_chunk(pos / chunk_size))
+			return NULL;
+		pos += p_length;
+		return chunk.ptr() + ofs;
+	}
+
+	if (!data)
+		return NULL;
+
+	const uint8_t *ptr = data + pos;
+	pos += p_length;
+	return ptr;
 }
 
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f)
+		f->set_endian_swap(p_swap);
 }
 
 Error FileAccessPack::get_error() const {
@@ -321,19 +895,58 @@ bool FileAccessPack::file_exists(const String &p_name) {
 
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(NULL),
+		data(NULL),
+		chunked(p_file.compression != NULL),
+		chunk_size(0),
+		chunks_offset(0),
+		chunks(NULL),
+		chunk_index(-1),
+		zstd_context(NULL) {
+	pos = 0;
+	eof = false;
+
+	if (pf.mapped_pack && chunked) {
+		if (!_open_chunked()) {
+			ERR_PRINTS("Invalid compressed file in pack: " + String(pf.pack));
+		}
+		return;
+	}
+
+	if (pf.mapped_pack) {
+		uint64_t len = pf.mapped_pack->get_len();
+		if (pf.offset <= len && pf.size <= len - pf.offset) {
+			data = pf.mapped_pack->map_contents() + pf.offset;
+			// loaders read most files front to back right away, so start paging in the beginning
+			pf.mapped_pack->prefetch(pf.offset, MIN(pf.size, (uint64_t)PREFETCH_MAX));
+			return;
+		}
+		// the index points past the end of the mapping, read through the file instead, which stops at its end
+		ERR_PRINTS("File in pack goes past the end of the pack: " + String(pf.pack));
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
 		ERR_FAIL_COND(!f);
 	}
+
+	if (chunked) {
+		if (!_open_chunked()) {
+			memdelete(f);
+			f = NULL;
+			ERR_PRINTS("Invalid compressed file in pack: " + String(pf.pack));
+		}
+		return;
+	}
+
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
 	if (f)
 		memdelete(f);
+	Compression::zstd_free_context(zstd_context);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -420,7 +1033,7 @@ Error DirAccessPack::change_dir(String p_dir) {
 	PackedData::PackedDir *pd;
 
 	if (absolute)
-		pd = PackedData::get_singleton()->root;
+		pd = PackedData::get_singleton()->_get_root();
 	else
 		pd = current;
 
@@ -496,7 +1109,7 @@ String DirAccessPack::get_filesystem_type() const {
 
 DirAccessPack::DirAccessPack() {
 
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 	cdir = false;
 }
 
@@ -31,10 +31,12 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/io/compression.h"
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/dir_access.h"
 #include "core/os/file_access.h"
+#include "core/os/mutex.h"
 #include "core/print_string.h"
 
 class PackSource;
@@ -45,6 +47,32 @@ class PackedData {
 	friend class PackSource;
 
 public:
+	// Compressed packs (PACK_FLAG_CHUNKED_ZSTD in the third reserved header
+	// word) store each file as independently compressed zstd chunks, so
+	// seeking only needs to decompress the chunk holding the new position.
+	// The offset of a file points at its chunk table: the uncompressed chunk
+	// size and chunk count, then where each chunk ends, counted from the end
+	// of the table. Chunks that don't get smaller are stored as they are.
+	// The entries and the index keep the uncompressed size of the files.
+	// A dictionary shared by all the chunks can be stored in the pack, its
+	// offset and size go in the three reserved words after the flags.
+
+	enum {
+		PACK_FLAG_CHUNKED_ZSTD = 1,
+		PACK_VERSION_CHUNKED = 2, // so older versions refuse compressed packs
+		CHUNK_SIZE = 64 * 1024,
+		DICTIONARY_SIZE = 110 * 1024,
+		DICTIONARY_SAMPLE_SIZE = 16 * 1024, // taken from the start of each file
+		DICTIONARY_MAX_SAMPLES = 100 * DICTIONARY_SIZE,
+	};
+
+	struct PackCompression {
+		Compression::ZstdDictionary *dictionary; // digested from the raw content dictionary, or NULL
+
+		PackCompression() { dictionary = NULL; }
+		~PackCompression() { Compression::zstd_free_dictionary(dictionary); }
+	};
+
 	struct PackedFile {
 
 		String pack;
@@ -52,6 +80,44 @@ public:
 		uint64_t size;
 		uint8_t md5[16];
 		PackSource *src;
+		FileAccess *mapped_pack; //open, memory mapped pack this file can be read from directly, or NULL
+		uint32_t mount; //add_pack() call that added the file, later ones take precedence
+		const PackCompression *compression; //set if the file is stored in compressed chunks
+	};
+
+	// Packs written by PCKPacker and the exporter carry a flat index of
+	// their files after the regular file entries, pointed to by the first
+	// reserved words of the header. Entries are sorted by path hash and a
+	// bucket table on top maps the high bits of the hash to the first entry,
+	// so lookups are a couple of reads and mounting needs no per file work.
+	// The index is used in place, straight from the mapped pack when possible.
+
+	enum {
+		INDEX_MAGIC = 0x49504447, // GDPI
+		INDEX_ALIGNMENT = 8,
+	};
+
+	struct IndexHeader {
+		uint32_t magic;
+		uint32_t file_count;
+		uint32_t bucket_bits;
+		uint32_t strings_size;
+	};
+
+	struct IndexEntry {
+		uint64_t hash;
+		uint64_t offset;
+		uint64_t size;
+		uint32_t path_offset; // into the string table, UTF-8 without terminator
+		uint32_t path_length;
+		uint8_t md5[16];
+	};
+
+	struct IndexedFile {
+		CharString path;
+		uint64_t offset;
+		uint64_t size;
+		uint8_t md5[16];
 	};
 
 private:
@@ -88,21 +154,52 @@ private:
 		};
 	};
 
+	struct PackIndex {
+		String pack;
+		PackSource *src;
+		FileAccess *mapped_pack;
+		uint32_t mount;
+		const PackCompression *compression;
+		Vector<uint8_t> buffer; // holds the index when the pack is not mapped
+		const IndexEntry *entries;
+		const uint32_t *buckets;
+		const char *strings;
+		uint32_t file_count;
+		uint32_t bucket_bits;
+	};
+
 	Map<PathMD5, PackedFile> files;
+	Vector<PackIndex *> indices;
+	uint32_t mount_count;
 
 	Vector<PackSource *> sources;
 
 	PackedDir *root;
 	//Map<String,PackedDir*> dirs;
+	int indices_in_dirs;
+	Mutex *dir_mutex;
 
 	static PackedData *singleton;
 	bool disabled;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _add_dir_path(const String &p_path);
+	PackedDir *_get_root();
+
+	const IndexEntry *_find_indexed(const String &p_path, PackIndex **r_index) const;
+	PackedFile *_find_file(const String &p_path, PackedFile *r_indexed);
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, FileAccess *p_mapped_pack = NULL, const PackCompression *p_compression = NULL); // for PackSource
+	bool add_index(const String &p_pack, const uint8_t *p_index, uint64_t p_size, const Vector<uint8_t> &p_buffer, PackSource *p_src, FileAccess *p_mapped_pack, const PackCompression *p_compression = NULL); // for PackSource, p_index points into p_mapped_pack or p_buffer
+
+	static uint64_t hash_path(const String &p_path);
+	static uint64_t hash_path_utf8(const char *p_path, int p_len);
+	static uint64_t get_index_size(int p_file_count, uint64_t p_strings_size);
+	static Vector<uint8_t> make_index(const Vector<IndexedFile> &p_files);
+	static Vector<uint8_t> make_dictionary(const Vector<Vector<uint8_t> > &p_samples);
+	static uint64_t store_chunked(FileAccess *p_dst, FileAccess *p_src, uint64_t p_size, Compression::ZstdContext *p_context, const Compression::ZstdDictionary *p_dictionary = NULL); // returns the bytes written
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -127,19 +224,45 @@ public:
 
 class PackedSourcePCK : public PackSource {
 
+	Vector<FileAccess *> mapped_packs;
+	Vector<PackedData::PackCompression *> compressions;
+
 public:
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
 
+	enum {
+		PREFETCH_MIN = 64 * 1024,
+		PREFETCH_MAX = 4 * 1024 * 1024,
+	};
+
 	PackedData::PackedFile pf;
 
 	mutable size_t pos;
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *data; // contents of the file inside the mapped pack, f is not used then
+
+	// compressed files, see PackedData::PACK_FLAG_CHUNKED_ZSTD
+	bool chunked;
+	uint32_t chunk_size;
+	uint64_t chunks_offset; // in the pack
+	const uint8_t *chunks; // first chunk inside the mapped pack, or NULL to read them with f
+	Vector<uint32_t> chunk_ends;
+	mutable Vector<uint8_t> chunk; // decompressed contents of chunk_index
+	mutable Vector<uint8_t> chunk_buffer; // compressed chunk read from f
+	mutable int chunk_index;
+	mutable Compression::ZstdContext *zstd_context; // created by the first compressed chunk
+
+	bool _open_chunked();
+	bool _load_chunk(int p_index) const;
+
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -159,6 +282,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_direct(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -177,19 +301,20 @@ public:
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 
-	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E)
+	PackedFile indexed;
+	PackedFile *pf = _find_file(p_path, &indexed);
+	if (!pf)
 		return NULL; //not found
-	if (E->get().offset == 0)
+	if (pf->offset == 0)
 		return NULL; //was erased
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf->src->get_file(p_path, pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
 
-	return files.has(PathMD5(p_path.md5_buffer()));
+	PackedFile indexed;
+	return _find_file(p_path, &indexed) != NULL;
 }
 
 class DirAccessPack : public DirAccess {
@@ -30,9 +30,25 @@
 
 #include "json.h"
 
+#include "core/hashfuncs.h"
 #include "core/print_string.h"
+#include "core/string_builder.h"
+
+enum TokenType {
+	TK_CURLY_BRACKET_OPEN,
+	TK_CURLY_BRACKET_CLOSE,
+	TK_BRACKET_OPEN,
+	TK_BRACKET_CLOSE,
+	TK_IDENTIFIER,
+	TK_STRING,
+	TK_NUMBER,
+	TK_COLON,
+	TK_COMMA,
+	TK_EOF,
+	TK_MAX
+};
 
-const char *JSON::tk_name[TK_MAX] = {
+static const char *tk_name[TK_MAX] = {
 	"'{'",
 	"'}'",
 	"'['",
@@ -45,54 +61,173 @@ const char *JSON::tk_name[TK_MAX] = {
 	"EOF",
 };
 
-static String _make_indent(const String &p_indent, int p_size) {
+// Writes the output in chunks of a fixed size, which StringBuilder joins at
+// the end, so small pieces like brackets and numbers need no String each.
+class JSONWriter {
+
+	enum {
+		CHUNK_SIZE = 16384
+	};
+
+	StringBuilder chunks;
+	String chunk;
+	CharType *dst;
+	int used;
+
+	void _next_chunk() {
+
+		if (used) {
+			dst[used] = 0;
+			chunk.resize(used + 1);
+			chunks += chunk;
+		}
+		chunk = String();
+		chunk.resize(CHUNK_SIZE + 1);
+		dst = chunk.ptrw();
+		used = 0;
+	}
+
+public:
+	_FORCE_INLINE_ void put(CharType p_char) {
+
+		if (used == CHUNK_SIZE)
+			_next_chunk();
+		dst[used++] = p_char;
+	}
+
+	void put(const char *p_str) {
+
+		for (; *p_str; p_str++)
+			put(CharType(*p_str));
+	}
+
+	void put(const CharType *p_str, int p_len) {
+
+		while (p_len) {
+			if (used == CHUNK_SIZE)
+				_next_chunk();
+			int len = MIN(p_len, CHUNK_SIZE - used);
+			memcpy(dst + used, p_str, len * sizeof(CharType));
+			used += len;
+			p_str += len;
+			p_len -= len;
+		}
+	}
+
+	void put(const String &p_str) {
+
+		put(p_str.c_str(), p_str.length());
+	}
+
+	void put_int(int64_t p_int) {
+
+		// same digits as itos()
+		CharType digits[20];
+		int len = 0;
+		uint64_t n = p_int < 0 ? -uint64_t(p_int) : uint64_t(p_int);
+		do {
+			digits[len++] = '0' + n % 10;
+			n /= 10;
+		} while (n);
+
+		if (p_int < 0)
+			put('-');
+		while (len)
+			put(digits[--len]);
+	}
+
+	void put_string(const String &p_str) {
+
+		// same escapes as String::json_escape()
+		const CharType *src = p_str.c_str();
+		int len = p_str.length();
+
+		put('"');
+		int start = 0;
+		for (int i = 0; i < len; i++) {
+
+			CharType c = src[i];
+			CharType escape;
+			switch (c) {
+				case '\\': escape = '\\'; break;
+				case '"': escape = '"'; break;
+				case '\b': escape = 'b'; break;
+				case '\t': escape = 't'; break;
+				case '\n': escape = 'n'; break;
+				case '\v': escape = 'v'; break;
+				case '\f': escape = 'f'; break;
+				case '\r': escape = 'r'; break;
+				default: continue;
+			}
+
+			put(src + start, i - start);
+			put('\\');
+			put(escape);
+			start = i + 1;
+		}
+		put(src + start, len - start);
+		put('"');
+	}
+
+	void put_indent(const String &p_indent, int p_size) {
 
-	String indent_text = "";
-	if (!p_indent.empty()) {
 		for (int i = 0; i < p_size; i++)
-			indent_text += p_indent;
+			put(p_indent);
 	}
-	return indent_text;
-}
 
-String JSON::_print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys) {
+	String get_string() {
 
-	String colon = ":";
-	String end_statement = "";
+		_next_chunk();
+		return chunks.as_string();
+	}
 
-	if (!p_indent.empty()) {
-		colon += " ";
-		end_statement += "\n";
+	JSONWriter() {
+		dst = NULL;
+		used = 0;
+		_next_chunk();
 	}
+};
+
+static void _print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, JSONWriter &r_out) {
+
+	const char *colon = p_indent.empty() ? ":" : ": ";
+	bool new_lines = !p_indent.empty();
 
 	switch (p_var.get_type()) {
 
-		case Variant::NIL: return "null";
-		case Variant::BOOL: return p_var.operator bool() ? "true" : "false";
-		case Variant::INT: return itos(p_var);
-		case Variant::REAL: return rtos(p_var);
+		case Variant::NIL: r_out.put("null"); break;
+		case Variant::BOOL: r_out.put(p_var.operator bool() ? "true" : "false"); break;
+		case Variant::INT: r_out.put_int(p_var); break;
+		case Variant::REAL: r_out.put(rtos(p_var)); break;
+		case Variant::STRING: r_out.put_string(p_var); break;
 		case Variant::POOL_INT_ARRAY:
 		case Variant::POOL_REAL_ARRAY:
 		case Variant::POOL_STRING_ARRAY:
 		case Variant::ARRAY: {
 
-			String s = "[";
-			s += end_statement;
+			r_out.put('[');
+			if (new_lines)
+				r_out.put('\n');
 			Array a = p_var;
 			for (int i = 0; i < a.size(); i++) {
 				if (i > 0) {
-					s += ",";
-					s += end_statement;
+					r_out.put(',');
+					if (new_lines)
+						r_out.put('\n');
 				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _print_var(a[i], p_indent, p_cur_indent + 1, p_sort_keys);
+				r_out.put_indent(p_indent, p_cur_indent + 1);
+				_print_var(a[i], p_indent, p_cur_indent + 1, p_sort_keys, r_out);
 			}
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "]";
-			return s;
-		};
+			if (new_lines)
+				r_out.put('\n');
+			r_out.put_indent(p_indent, p_cur_indent);
+			r_out.put(']');
+		} break;
 		case Variant::DICTIONARY: {
 
-			String s = "{";
-			s += end_statement;
+			r_out.put('{');
+			if (new_lines)
+				r_out.put('\n');
 			Dictionary d = p_var;
 			List<Variant> keys;
 			d.get_key_list(&keys);
@@ -103,35 +238,262 @@ String JSON::_print_var(const Variant &p_var, const String &p_indent, int p_cur_
 			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
 
 				if (E != keys.front()) {
-					s += ",";
-					s += end_statement;
+					r_out.put(',');
+					if (new_lines)
+						r_out.put('\n');
 				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _print_var(String(E->get()), p_indent, p_cur_indent + 1, p_sort_keys);
-				s += colon;
-				s += _print_var(d[E->get()], p_indent, p_cur_indent + 1, p_sort_keys);
+				r_out.put_indent(p_indent, p_cur_indent + 1);
+				r_out.put_string(E->get());
+				r_out.put(colon);
+				_print_var(d[E->get()], p_indent, p_cur_indent + 1, p_sort_keys, r_out);
 			}
 
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "}";
-			return s;
-		};
-		default: return "\"" + String(p_var).json_escape() + "\"";
+			if (new_lines)
+				r_out.put('\n');
+			r_out.put_indent(p_indent, p_cur_indent);
+			r_out.put('}');
+		} break;
+		default: r_out.put_string(p_var);
 	}
 }
 
 String JSON::print(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
 
-	return _print_var(p_var, p_indent, 0, p_sort_keys);
+	JSONWriter out;
+	_print_var(p_var, p_indent, 0, p_sort_keys, out);
+	return out.get_string();
 }
 
-Error JSON::_get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+// Parses straight from the character buffer. Strings are copied once, with
+// no per character appends, numbers are converted without going through
+// String, and object keys repeated across a text share the same String.
+
+class JSONReader {
+
+	enum {
+		KEY_CACHE_SIZE = 256,
+		MAX_EXACT_DIGITS = 15, // as many as a double holds exactly
+		MAX_EXACT_EXPONENT = 22,
+	};
+
+	struct Token {
+
+		TokenType type;
+		String str;
+		double number;
+		const CharType *identifier;
+		int identifier_len;
+	};
+
+	const CharType *src;
+	String key_cache[KEY_CACHE_SIZE];
+
+	Error _get_token(Token &r_token, bool p_key = false);
+	Error _read_string(String &r_str, bool p_key);
+	void _read_number(double &r_number);
+	bool _is_identifier(const Token &p_token, const char *p_name) const;
+
+	template <class H>
+	Error _parse_value(H &p_handler, const Token &p_token);
+	template <class H>
+	Error _parse_array(H &p_handler);
+	template <class H>
+	Error _parse_object(H &p_handler);
+
+public:
+	int line;
+	String err_str;
+
+	template <class H>
+	Error parse(H &p_handler);
+
+	JSONReader(const String &p_json) {
+		src = p_json.c_str();
+		line = 0;
+	}
+};
+
+Error JSONReader::_read_string(String &r_str, bool p_key) {
+
+	// find the end first, so the String is allocated only once
+	const CharType *begin = src;
+	const CharType *end = src;
+	bool escaped = false;
+	while (*end != '"') {
+		if (*end == 0) {
+			err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		} else if (*end == '\\') {
+			escaped = true;
+			end++;
+			if (*end == 0) {
+				err_str = "Unterminated String";
+				return ERR_PARSE_ERROR;
+			}
+		} else if (*end == '\n') {
+			line++;
+		}
+		end++;
+	}
+	src = end + 1;
 
-	while (p_len > 0) {
-		switch (p_str[index]) {
+	int len = end - begin;
+
+	if (!escaped) {
+		if (!p_key) {
+			r_str = String(begin, len);
+			return OK;
+		}
+
+		uint32_t hash = 5381;
+		for (int i = 0; i < len; i++)
+			hash = hash_djb2_one_32(begin[i], hash);
+
+		String &cached = key_cache[hash % KEY_CACHE_SIZE];
+		if (cached.length() != len || memcmp(cached.c_str(), begin, len * sizeof(CharType)) != 0)
+			cached = String(begin, len);
+		r_str = cached;
+		return OK;
+	}
+
+	r_str.resize(len + 1);
+	CharType *dst = r_str.ptrw();
+	for (const CharType *c = begin; c < end; c++) {
+
+		if (*c != '\\') {
+			*dst++ = *c;
+			continue;
+		}
+
+		//escaped characters...
+		c++;
+		CharType res = 0;
+
+		switch (*c) {
+
+			case 'b': res = 8; break;
+			case 't': res = 9; break;
+			case 'n': res = 10; break;
+			case 'f': res = 12; break;
+			case 'r': res = 13; break;
+			case 'u': {
+				//hexnumbarh - oct is deprecated
+
+				for (int j = 0; j < 4; j++) {
+					CharType h = c[j + 1];
+					if (h == 0) {
+						err_str = "Unterminated String";
+						return ERR_PARSE_ERROR;
+					}
+					CharType v;
+					if (h >= '0' && h <= '9') {
+						v = h - '0';
+					} else if (h >= 'a' && h <= 'f') {
+						v = h - 'a' + 10;
+					} else if (h >= 'A' && h <= 'F') {
+						v = h - 'A' + 10;
+					} else {
+						err_str = "Malformed hex constant in string";
+						return ERR_PARSE_ERROR;
+					}
+
+					res <<= 4;
+					res |= v;
+				}
+				c += 4;
+
+			} break;
+			default: {
+				res = *c;
+			} break;
+		}
+
+		*dst++ = res;
+	}
+
+	*dst = 0;
+	r_str.resize(dst - r_str.ptr() + 1);
+	return OK;
+}
+
+void JSONReader::_read_number(double &r_number) {
+
+	static const double powers_of_ten[MAX_EXACT_EXPONENT + 1] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// few digits and a small exponent convert exactly, as String::to_double()
+	// would, everything else is left to it
+	const CharType *c = src;
+	bool negative = *c == '-';
+	if (negative)
+		c++;
+
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+
+	for (; *c >= '0' && *c <= '9'; c++, digits++)
+		mantissa = mantissa * 10 + (*c - '0');
+
+	if (*c == '.') {
+		for (c++; *c >= '0' && *c <= '9'; c++, digits++, exponent--)
+			mantissa = mantissa * 10 + (*c - '0');
+	}
+
+	bool exact = digits > 0 && digits <= MAX_EXACT_DIGITS;
+
+	if (exact && (*c == 'e' || *c == 'E')) {
+		c++;
+		bool exp_negative = *c == '-';
+		if (*c == '-' || *c == '+')
+			c++;
+
+		int exp = 0;
+		exact = *c >= '0' && *c <= '9';
+		for (; *c >= '0' && *c <= '9'; c++) {
+			if (exp < 1000)
+				exp = exp * 10 + (*c - '0');
+		}
+		exponent += exp_negative ? -exp : exp;
+	}
+
+	if (!exact || exponent < -MAX_EXACT_EXPONENT || exponent > MAX_EXACT_EXPONENT) {
+		const CharType *end;
+		r_number = String::to_double(src, &end);
+		src = end;
+		return;
+	}
+
+	double number = double(mantissa);
+	if (exponent < 0)
+		number /= powers_of_ten[-exponent];
+	else
+		number *= powers_of_ten[exponent];
+
+	r_number = negative ? -number : number;
+	src = c;
+}
+
+bool JSONReader::_is_identifier(const Token &p_token, const char *p_name) const {
+
+	for (int i = 0; i < p_token.identifier_len; i++) {
+		if (p_name[i] != p_token.identifier[i])
+			return false;
+	}
+	return p_name[p_token.identifier_len] == 0;
+}
+
+Error JSONReader::_get_token(Token &r_token, bool p_key) {
+
+	while (true) {
+		switch (*src) {
 
 			case '\n': {
 
 				line++;
-				index++;
+				src++;
 				break;
 			};
 			case 0: {
@@ -141,237 +503,145 @@ Error JSON::_get_token(const CharType *p_str, int &index, int p_len, Token &r_to
 			case '{': {
 
 				r_token.type = TK_CURLY_BRACKET_OPEN;
-				index++;
+				src++;
 				return OK;
 			};
 			case '}': {
 
 				r_token.type = TK_CURLY_BRACKET_CLOSE;
-				index++;
+				src++;
 				return OK;
 			};
 			case '[': {
 
 				r_token.type = TK_BRACKET_OPEN;
-				index++;
+				src++;
 				return OK;
 			};
 			case ']': {
 
 				r_token.type = TK_BRACKET_CLOSE;
-				index++;
+				src++;
 				return OK;
 			};
 			case ':': {
 
 				r_token.type = TK_COLON;
-				index++;
+				src++;
 				return OK;
 			};
 			case ',': {
 
 				r_token.type = TK_COMMA;
-				index++;
+				src++;
 				return OK;
 			};
 			case '"': {
 
-				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated String";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
-						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						CharType next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated String";
-							return ERR_PARSE_ERROR;
-						}
-						CharType res = 0;
-
-						switch (next) {
-
-							case 'b': res = 8; break;
-							case 't': res = 9; break;
-							case 'n': res = 10; break;
-							case 'f': res = 12; break;
-							case 'r': res = 13; break;
-							case 'u': {
-								//hexnumbarh - oct is deprecated
-
-								for (int j = 0; j < 4; j++) {
-									CharType c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									CharType v;
-									if (c >= '0' && c <= '9') {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("BUG");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-							} break;
-							//case '\"': res='\"'; break;
-							//case '\\': res='\\'; break;
-							//case '/': res='/'; break;
-							default: {
-								res = next;
-								//r_err_str="Invalid escape sequence";
-								//return ERR_PARSE_ERROR;
-							} break;
-						}
-
-						str += res;
-
-					} else {
-						if (p_str[index] == '\n')
-							line++;
-						str += p_str[index];
-					}
-					index++;
-				}
-
+				src++;
 				r_token.type = TK_STRING;
-				r_token.value = str;
-				return OK;
+				return _read_string(r_token.str, p_key);
 
 			} break;
 			default: {
 
-				if (p_str[index] <= 32) {
-					index++;
+				CharType c = *src;
+				if (c <= 32) {
+					src++;
 					break;
 				}
 
-				if (p_str[index] == '-' || (p_str[index] >= '0' && p_str[index] <= '9')) {
-					//a number
-					const CharType *rptr;
-					double number = String::to_double(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
+				if (c == '-' || (c >= '0' && c <= '9')) {
+
 					r_token.type = TK_NUMBER;
-					r_token.value = number;
+					_read_number(r_token.number);
 					return OK;
 
-				} else if ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
+				} else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
 
-					String id;
-
-					while ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
-
-						id += p_str[index];
-						index++;
-					}
+					r_token.identifier = src;
+					while ((*src >= 'A' && *src <= 'Z') || (*src >= 'a' && *src <= 'z'))
+						src++;
 
 					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
+					r_token.identifier_len = src - r_token.identifier;
 					return OK;
 				} else {
-					r_err_str = "Unexpected character.";
+					err_str = "Unexpected character.";
 					return ERR_PARSE_ERROR;
 				}
 			}
 		}
 	}
-
-	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+template <class H>
+Error JSONReader::_parse_value(H &p_handler, const Token &p_token) {
 
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
+	switch (p_token.type) {
 
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
-		value = d;
-		return OK;
-	} else if (token.type == TK_BRACKET_OPEN) {
+		case TK_CURLY_BRACKET_OPEN: {
 
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
-		value = a;
-		return OK;
+			return _parse_object(p_handler);
+		} break;
+		case TK_BRACKET_OPEN: {
+
+			return _parse_array(p_handler);
+		} break;
+		case TK_IDENTIFIER: {
+
+			if (_is_identifier(p_token, "true"))
+				return p_handler.value(true);
+			else if (_is_identifier(p_token, "false"))
+				return p_handler.value(false);
+			else if (_is_identifier(p_token, "null"))
+				return p_handler.value(Variant());
 
-	} else if (token.type == TK_IDENTIFIER) {
-
-		String id = token.value;
-		if (id == "true")
-			value = true;
-		else if (id == "false")
-			value = false;
-		else if (id == "null")
-			value = Variant();
-		else {
-			r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
+			err_str = "Expected 'true','false' or 'null', got '" + String(p_token.identifier, p_token.identifier_len) + "'.";
 			return ERR_PARSE_ERROR;
-		}
-		return OK;
+		} break;
+		case TK_NUMBER: {
 
-	} else if (token.type == TK_NUMBER) {
+			return p_handler.value(p_token.number);
+		} break;
+		case TK_STRING: {
 
-		value = token.value;
-		return OK;
-	} else if (token.type == TK_STRING) {
+			return p_handler.value(p_token.str);
+		} break;
+		default: {
 
-		value = token.value;
-		return OK;
-	} else {
-		r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
-		return ERR_PARSE_ERROR;
+			err_str = "Expected value, got " + String(tk_name[p_token.type]) + ".";
+			return ERR_PARSE_ERROR;
+		}
 	}
-
-	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+template <class H>
+Error JSONReader::_parse_array(H &p_handler) {
+
+	Error err = p_handler.begin_array();
+	if (err)
+		return err;
 
 	Token token;
 	bool need_comma = false;
 
-	while (index < p_len) {
+	while (true) {
 
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
+		err = _get_token(token);
 		if (err != OK)
 			return err;
 
 		if (token.type == TK_BRACKET_CLOSE) {
 
-			return OK;
+			return p_handler.end_array();
 		}
 
 		if (need_comma) {
 
 			if (token.type != TK_COMMA) {
 
-				r_err_str = "Expected ','";
+				err_str = "Expected ','";
 				return ERR_PARSE_ERROR;
 			} else {
 				need_comma = false;
@@ -379,99 +649,189 @@ Error JSON::_parse_array(Array &array, const CharType *p_str, int &index, int p_
 			}
 		}
 
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
+		err = _parse_value(p_handler, token);
 		if (err)
 			return err;
 
-		array.push_back(v);
 		need_comma = true;
 	}
-
-	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+template <class H>
+Error JSONReader::_parse_object(H &p_handler) {
+
+	Error err = p_handler.begin_object();
+	if (err)
+		return err;
 
-	bool at_key = true;
-	String key;
 	Token token;
 	bool need_comma = false;
 
-	while (index < p_len) {
-
-		if (at_key) {
+	while (true) {
 
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
+		err = _get_token(token, !need_comma);
+		if (err != OK)
+			return err;
 
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
+		if (token.type == TK_CURLY_BRACKET_CLOSE) {
 
-				return OK;
-			}
+			return p_handler.end_object();
+		}
 
-			if (need_comma) {
+		if (need_comma) {
 
-				if (token.type != TK_COMMA) {
+			if (token.type != TK_COMMA) {
 
-					r_err_str = "Expected '}' or ','";
-					return ERR_PARSE_ERROR;
-				} else {
-					need_comma = false;
-					continue;
-				}
+				err_str = "Expected '}' or ','";
+				return ERR_PARSE_ERROR;
+			} else {
+				need_comma = false;
+				continue;
 			}
+		}
 
-			if (token.type != TK_STRING) {
+		if (token.type != TK_STRING) {
 
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
+			err_str = "Expected key";
+			return ERR_PARSE_ERROR;
+		}
 
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
-			if (token.type != TK_COLON) {
+		err = p_handler.key(token.str);
+		if (err)
+			return err;
 
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
-			}
-			at_key = false;
-		} else {
-
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
-
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-			if (err)
-				return err;
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
+		err = _get_token(token);
+		if (err != OK)
+			return err;
+		if (token.type != TK_COLON) {
+
+			err_str = "Expected ':'";
+			return ERR_PARSE_ERROR;
 		}
-	}
 
-	return ERR_PARSE_ERROR;
+		err = _get_token(token);
+		if (err != OK)
+			return err;
+
+		err = _parse_value(p_handler, token);
+		if (err)
+			return err;
+
+		need_comma = true;
+	}
 }
 
-Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+template <class H>
+Error JSONReader::parse(H &p_handler) {
 
-	const CharType *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
 	Token token;
-	r_err_line = 0;
-	String aux_key;
-
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	Error err = _get_token(token);
 	if (err)
 		return err;
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, r_err_str);
+	return _parse_value(p_handler, token);
+}
+
+// Builds the Variant for JSON::parse(), keeping the open arrays and objects
+// on a stack instead of the C++ one.
+class JSONBuilder {
+
+	struct Container {
+
+		Array array;
+		Dictionary object;
+		String key;
+		bool is_object;
+	};
+
+	Vector<Container> stack;
+	int depth;
+
+	Error _end() {
+
+		// the finished container stays referenced until its slot is reused
+		const Container &c = stack[--depth];
+		return value(c.is_object ? Variant(c.object) : Variant(c.array));
+	}
+
+	Container &_begin() {
+
+		if (depth == stack.size())
+			stack.resize(depth + 1);
+		return stack.write[depth++];
+	}
+
+public:
+	Variant result;
+
+	Error begin_object() {
+
+		Container &c = _begin();
+		c.object = Dictionary();
+		c.is_object = true;
+		return OK;
+	}
+
+	Error key(const String &p_key) {
+
+		stack.write[depth - 1].key = p_key;
+		return OK;
+	}
+
+	Error end_object() { return _end(); }
+
+	Error begin_array() {
+
+		Container &c = _begin();
+		c.array = Array();
+		c.is_object = false;
+		return OK;
+	}
+
+	Error end_array() { return _end(); }
+
+	Error value(const Variant &p_value) {
+
+		if (depth == 0) {
+			result = p_value;
+			return OK;
+		}
+
+		Container &c = stack.write[depth - 1];
+		if (c.is_object)
+			c.object[c.key] = p_value;
+		else
+			c.array.push_back(p_value);
+		return OK;
+	}
+
+	JSONBuilder() {
+		depth = 0;
+	}
+};
+
+Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+
+	JSONReader reader(p_json);
+	JSONBuilder builder;
+
+	Error err = reader.parse(builder);
+	r_ret = builder.result;
+	r_err_str = reader.err_str;
+	r_err_line = reader.line;
+
+	return err;
+}
+
+Error JSON::parse(const String &p_json, Handler *p_handler, String &r_err_str, int &r_err_line) {
+
+	ERR_FAIL_NULL_V(p_handler, ERR_INVALID_PARAMETER);
+
+	JSONReader reader(p_json);
+
+	Error err = reader.parse(*p_handler);
+	r_err_str = reader.err_str;
+	r_err_line = reader.line;
 
 	return err;
 }
@@ -35,46 +35,24 @@
 
 class JSON {
 
-	enum TokenType {
-		TK_CURLY_BRACKET_OPEN,
-		TK_CURLY_BRACKET_CLOSE,
-		TK_BRACKET_OPEN,
-		TK_BRACKET_CLOSE,
-		TK_IDENTIFIER,
-		TK_STRING,
-		TK_NUMBER,
-		TK_COLON,
-		TK_COMMA,
-		TK_EOF,
-		TK_MAX
-	};
-
-	enum Expecting {
-
-		EXPECT_OBJECT,
-		EXPECT_OBJECT_KEY,
-		EXPECT_COLON,
-		EXPECT_OBJECT_VALUE,
-	};
-
-	struct Token {
-
-		TokenType type;
-		Variant value;
+public:
+	// Receives a JSON text piece by piece while it is parsed, for texts too
+	// large to keep as Variants. Returning an error stops parsing with it.
+	class Handler {
+	public:
+		virtual Error begin_object() { return OK; }
+		virtual Error key(const String &p_key) { return OK; }
+		virtual Error end_object() { return OK; }
+		virtual Error begin_array() { return OK; }
+		virtual Error end_array() { return OK; }
+		virtual Error value(const Variant &p_value) { return OK; }
+
+		virtual ~Handler() {}
 	};
 
-	static const char *tk_name[TK_MAX];
-
-	static String _print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys);
-
-	static Error _get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-
-public:
 	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
 	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse(const String &p_json, Handler *p_handler, String &r_err_str, int &r_err_line);
 };
 
 #endif // JSON_H
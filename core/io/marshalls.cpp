@@ -98,6 +98,59 @@ static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r
 	return OK;
 }
 
+// Pool arrays are runs of little endian 32 bit words, which on little endian
+// hosts are copied as they are, unless real_t is a double.
+
+static _FORCE_INLINE_ void _encode_word(int p_value, uint8_t *p_dst) {
+	encode_uint32(p_value, p_dst);
+}
+
+static _FORCE_INLINE_ void _encode_word(float p_value, uint8_t *p_dst) {
+	encode_float(p_value, p_dst);
+}
+
+static _FORCE_INLINE_ void _encode_word(double p_value, uint8_t *p_dst) {
+	encode_float(p_value, p_dst);
+}
+
+static _FORCE_INLINE_ void _decode_word(const uint8_t *p_src, int &r_value) {
+	r_value = decode_uint32(p_src);
+}
+
+static _FORCE_INLINE_ void _decode_word(const uint8_t *p_src, float &r_value) {
+	r_value = decode_float(p_src);
+}
+
+static _FORCE_INLINE_ void _decode_word(const uint8_t *p_src, double &r_value) {
+	r_value = decode_float(p_src);
+}
+
+template <class T>
+static void _encode_words(const T *p_src, int p_count, uint8_t *p_dst) {
+
+#ifndef BIG_ENDIAN_ENABLED
+	if (sizeof(T) == 4) {
+		copymem(p_dst, p_src, p_count * 4);
+		return;
+	}
+#endif
+	for (int i = 0; i < p_count; i++)
+		_encode_word(p_src[i], &p_dst[i * 4]);
+}
+
+template <class T>
+static void _decode_words(const uint8_t *p_src, int p_count, T *p_dst) {
+
+#ifndef BIG_ENDIAN_ENABLED
+	if (sizeof(T) == 4) {
+		copymem(p_dst, p_src, p_count * 4);
+		return;
+	}
+#endif
+	for (int i = 0; i < p_count; i++)
+		_decode_word(&p_src[i * 4], p_dst[i]);
+}
+
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
 
 	const uint8_t *buf = p_buffer;
@@ -555,12 +608,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				data.resize(count);
 				PoolVector<uint8_t>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i] = buf[i];
-				}
-
-				w = PoolVector<uint8_t>::Write();
+				copymem(w.ptr(), buf, count);
 			}
 
 			r_variant = data;
@@ -584,15 +632,9 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			PoolVector<int> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				PoolVector<int>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i] = decode_uint32(&buf[i * 4]);
-				}
-
-				w = PoolVector<int>::Write();
+				_decode_words(buf, count, w.ptr());
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -609,18 +651,12 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_MUL_OF(count, 4, ERR_INVALID_DATA);
 			ERR_FAIL_COND_V(count < 0 || count * 4 > len, ERR_INVALID_DATA);
 
-			PoolVector<float> data;
+			PoolVector<real_t> data;
 
 			if (count) {
-				//const float*rbuf=(const float*)buf;
 				data.resize(count);
-				PoolVector<float>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i] = decode_float(&buf[i * 4]);
-				}
-
-				w = PoolVector<float>::Write();
+				PoolVector<real_t>::Write w = data.write();
+				_decode_words(buf, count, w.ptr());
 			}
 			r_variant = data;
 
@@ -674,11 +710,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				PoolVector<Vector2>::Write w = varray.write();
 
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].x = decode_float(buf + i * 4 * 2 + 4 * 0);
-					w[i].y = decode_float(buf + i * 4 * 2 + 4 * 1);
-				}
+				_decode_words(buf, count * 2, (real_t *)w.ptr());
 
 				int adv = 4 * 2 * count;
 
@@ -711,12 +743,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				PoolVector<Vector3>::Write w = varray.write();
 
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].x = decode_float(buf + i * 4 * 3 + 4 * 0);
-					w[i].y = decode_float(buf + i * 4 * 3 + 4 * 1);
-					w[i].z = decode_float(buf + i * 4 * 3 + 4 * 2);
-				}
+				_decode_words(buf, count * 3, (real_t *)w.ptr());
 
 				int adv = 4 * 3 * count;
 
@@ -749,13 +776,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				carray.resize(count);
 				PoolVector<Color>::Write w = carray.write();
 
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
-					w[i].g = decode_float(buf + i * 4 * 4 + 4 * 1);
-					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
-					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
-				}
+				_decode_words(buf, count * 4, (float *)w.ptr());
 
 				int adv = 4 * 4 * count;
 
@@ -776,31 +797,119 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
-static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
+// Where the encoder puts its output: nowhere when only measuring the size, a
+// buffer known to be large enough, or a Vector grown as needed, so variants
+// can be encoded in a single pass.
+class VariantEncoder {
+
+	uint8_t *buf;
+	Vector<uint8_t> *vector;
+	int capacity;
+
+	void _grow(int p_size) {
+
+		capacity = MAX(p_size, MAX(capacity * 2, 64));
+		vector->resize(capacity);
+		buf = vector->ptrw();
+	}
+
+public:
+	int start;
+	int ofs;
+
+	_FORCE_INLINE_ uint8_t *reserve(int p_size) {
+
+		int at = ofs;
+		ofs += p_size;
+		if (vector && ofs > capacity)
+			_grow(ofs);
+		return buf ? buf + at : NULL;
+	}
+
+	_FORCE_INLINE_ void put_32(uint32_t p_value) {
+
+		uint8_t *w = reserve(4);
+		if (w)
+			encode_uint32(p_value, w);
+	}
+
+	_FORCE_INLINE_ void put_64(uint64_t p_value) {
+
+		uint8_t *w = reserve(8);
+		if (w)
+			encode_uint64(p_value, w);
+	}
+
+	_FORCE_INLINE_ void put_float(float p_value) {
+
+		uint8_t *w = reserve(4);
+		if (w)
+			encode_float(p_value, w);
+	}
+
+	_FORCE_INLINE_ void put_double(double p_value) {
+
+		uint8_t *w = reserve(8);
+		if (w)
+			encode_double(p_value, w);
+	}
 
-	CharString utf8 = p_string.utf8();
+	void put_data(const void *p_data, int p_size) {
 
-	if (buf) {
-		encode_uint32(utf8.length(), buf);
-		buf += 4;
-		copymem(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+		uint8_t *w = reserve(p_size);
+		if (w)
+			copymem(w, p_data, p_size);
 	}
 
-	r_len += 4 + utf8.length();
-	while (r_len % 4) {
-		r_len++; //pad
-		if (buf) {
-			*(buf++) = 0;
+	void put_padding() {
+
+		while ((ofs - start) % 4) {
+			uint8_t *w = reserve(1);
+			if (w)
+				*w = 0;
 		}
 	}
-}
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
+	void put_string(const String &p_string) {
 
-	uint8_t *buf = r_buffer;
+		CharString utf8 = p_string.utf8();
+		put_32(utf8.length());
+		put_data(utf8.get_data(), utf8.length());
+		put_padding();
+	}
 
-	r_len = 0;
+	VariantEncoder(uint8_t *p_buffer) {
+		buf = p_buffer;
+		vector = NULL;
+		capacity = 0;
+		start = 0;
+		ofs = 0;
+	}
+
+	VariantEncoder(Vector<uint8_t> &p_vector, int p_ofs) {
+		vector = &p_vector;
+		capacity = p_vector.size();
+		buf = capacity ? p_vector.ptrw() : NULL;
+		start = p_ofs;
+		ofs = p_ofs;
+	}
+};
+
+template <class T, class W>
+static void _encode_pool_array(const Variant &p_variant, int p_words, VariantEncoder &r_enc) {
+
+	PoolVector<T> data = p_variant;
+	int count = data.size();
+
+	r_enc.put_32(count);
+	uint8_t *w = r_enc.reserve(count * p_words * 4);
+	if (w && count) {
+		typename PoolVector<T>::Read r = data.read();
+		_encode_words((const W *)r.ptr(), count * p_words, w);
+	}
+}
+
+static Error _encode_variant(const Variant &p_variant, VariantEncoder &r_enc, bool p_full_objects) {
 
 	uint32_t flags = 0;
 
@@ -829,11 +938,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} // nothing to do at this stage
 	}
 
-	if (buf) {
-		encode_uint32(p_variant.get_type() | flags, buf);
-		buf += 4;
-	}
-	r_len += 4;
+	r_enc.put_32(p_variant.get_type() | flags);
 
 	switch (p_variant.get_type()) {
 
@@ -843,240 +948,155 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 		case Variant::BOOL: {
 
-			if (buf) {
-				encode_uint32(p_variant.operator bool(), buf);
-			}
-
-			r_len += 4;
+			r_enc.put_32(p_variant.operator bool());
 
 		} break;
 		case Variant::INT: {
 
 			if (flags & ENCODE_FLAG_64) {
 				//64 bits
-				if (buf) {
-					encode_uint64(p_variant.operator int64_t(), buf);
-				}
-
-				r_len += 8;
+				r_enc.put_64(p_variant.operator int64_t());
 			} else {
-				if (buf) {
-					encode_uint32(p_variant.operator int32_t(), buf);
-				}
-
-				r_len += 4;
+				r_enc.put_32(p_variant.operator int32_t());
 			}
 		} break;
 		case Variant::REAL: {
 
 			if (flags & ENCODE_FLAG_64) {
-				if (buf) {
-					encode_double(p_variant.operator double(), buf);
-				}
-
-				r_len += 8;
-
+				r_enc.put_double(p_variant.operator double());
 			} else {
-
-				if (buf) {
-					encode_float(p_variant.operator float(), buf);
-				}
-
-				r_len += 4;
+				r_enc.put_float(p_variant.operator float());
 			}
 
 		} break;
 		case Variant::NODE_PATH: {
 
 			NodePath np = p_variant;
-			if (buf) {
-				encode_uint32(uint32_t(np.get_name_count()) | 0x80000000, buf); //for compatibility with the old format
-				encode_uint32(np.get_subname_count(), buf + 4);
-				uint32_t np_flags = 0;
-				if (np.is_absolute())
-					np_flags |= 1;
-
-				encode_uint32(np_flags, buf + 8);
-
-				buf += 12;
-			}
+			r_enc.put_32(uint32_t(np.get_name_count()) | 0x80000000); //for compatibility with the old format
+			r_enc.put_32(np.get_subname_count());
+			uint32_t np_flags = 0;
+			if (np.is_absolute())
+				np_flags |= 1;
 
-			r_len += 12;
+			r_enc.put_32(np_flags);
 
 			int total = np.get_name_count() + np.get_subname_count();
 
 			for (int i = 0; i < total; i++) {
 
-				String str;
-
 				if (i < np.get_name_count())
-					str = np.get_name(i);
+					r_enc.put_string(np.get_name(i));
 				else
-					str = np.get_subname(i - np.get_name_count());
-
-				CharString utf8 = str.utf8();
-
-				int pad = 0;
-
-				if (utf8.length() % 4)
-					pad = 4 - utf8.length() % 4;
-
-				if (buf) {
-					encode_uint32(utf8.length(), buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length());
-					buf += pad + utf8.length();
-				}
-
-				r_len += 4 + utf8.length() + pad;
+					r_enc.put_string(np.get_subname(i - np.get_name_count()));
 			}
 
 		} break;
 		case Variant::STRING: {
 
-			_encode_string(p_variant, buf, r_len);
+			r_enc.put_string(p_variant);
 
 		} break;
 
 		// math types
 		case Variant::VECTOR2: {
 
-			if (buf) {
-				Vector2 v2 = p_variant;
-				encode_float(v2.x, &buf[0]);
-				encode_float(v2.y, &buf[4]);
-			}
-
-			r_len += 2 * 4;
+			Vector2 v2 = p_variant;
+			r_enc.put_float(v2.x);
+			r_enc.put_float(v2.y);
 
 		} break; // 5
 		case Variant::RECT2: {
 
-			if (buf) {
-				Rect2 r2 = p_variant;
-				encode_float(r2.position.x, &buf[0]);
-				encode_float(r2.position.y, &buf[4]);
-				encode_float(r2.size.x, &buf[8]);
-				encode_float(r2.size.y, &buf[12]);
-			}
-			r_len += 4 * 4;
+			Rect2 r2 = p_variant;
+			r_enc.put_float(r2.position.x);
+			r_enc.put_float(r2.position.y);
+			r_enc.put_float(r2.size.x);
+			r_enc.put_float(r2.size.y);
 
 		} break;
 		case Variant::VECTOR3: {
 
-			if (buf) {
-				Vector3 v3 = p_variant;
-				encode_float(v3.x, &buf[0]);
-				encode_float(v3.y, &buf[4]);
-				encode_float(v3.z, &buf[8]);
-			}
-
-			r_len += 3 * 4;
+			Vector3 v3 = p_variant;
+			r_enc.put_float(v3.x);
+			r_enc.put_float(v3.y);
+			r_enc.put_float(v3.z);
 
 		} break;
 		case Variant::TRANSFORM2D: {
 
-			if (buf) {
-				Transform2D val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 2; j++) {
+			Transform2D val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 2; j++) {
 
-						copymem(&buf[(i * 2 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
+					r_enc.put_float(val.elements[i][j]);
 				}
 			}
 
-			r_len += 6 * 4;
-
 		} break;
 		case Variant::PLANE: {
 
-			if (buf) {
-				Plane p = p_variant;
-				encode_float(p.normal.x, &buf[0]);
-				encode_float(p.normal.y, &buf[4]);
-				encode_float(p.normal.z, &buf[8]);
-				encode_float(p.d, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Plane p = p_variant;
+			r_enc.put_float(p.normal.x);
+			r_enc.put_float(p.normal.y);
+			r_enc.put_float(p.normal.z);
+			r_enc.put_float(p.d);
 
 		} break;
 		case Variant::QUAT: {
 
-			if (buf) {
-				Quat q = p_variant;
-				encode_float(q.x, &buf[0]);
-				encode_float(q.y, &buf[4]);
-				encode_float(q.z, &buf[8]);
-				encode_float(q.w, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Quat q = p_variant;
+			r_enc.put_float(q.x);
+			r_enc.put_float(q.y);
+			r_enc.put_float(q.z);
+			r_enc.put_float(q.w);
 
 		} break;
 		case Variant::AABB: {
 
-			if (buf) {
-				AABB aabb = p_variant;
-				encode_float(aabb.position.x, &buf[0]);
-				encode_float(aabb.position.y, &buf[4]);
-				encode_float(aabb.position.z, &buf[8]);
-				encode_float(aabb.size.x, &buf[12]);
-				encode_float(aabb.size.y, &buf[16]);
-				encode_float(aabb.size.z, &buf[20]);
-			}
-
-			r_len += 6 * 4;
+			AABB aabb = p_variant;
+			r_enc.put_float(aabb.position.x);
+			r_enc.put_float(aabb.position.y);
+			r_enc.put_float(aabb.position.z);
+			r_enc.put_float(aabb.size.x);
+			r_enc.put_float(aabb.size.y);
+			r_enc.put_float(aabb.size.z);
 
 		} break;
 		case Variant::BASIS: {
 
-			if (buf) {
-				Basis val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
+			Basis val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
 
-						copymem(&buf[(i * 3 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
+					r_enc.put_float(val.elements[i][j]);
 				}
 			}
 
-			r_len += 9 * 4;
-
 		} break;
 		case Variant::TRANSFORM: {
 
-			if (buf) {
-				Transform val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
+			Transform val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
 
-						copymem(&buf[(i * 3 + j) * 4], &val.basis.elements[i][j], sizeof(float));
-					}
+					r_enc.put_float(val.basis.elements[i][j]);
 				}
-
-				encode_float(val.origin.x, &buf[36]);
-				encode_float(val.origin.y, &buf[40]);
-				encode_float(val.origin.z, &buf[44]);
 			}
 
-			r_len += 12 * 4;
+			r_enc.put_float(val.origin.x);
+			r_enc.put_float(val.origin.y);
+			r_enc.put_float(val.origin.z);
 
 		} break;
 
 		// misc types
 		case Variant::COLOR: {
 
-			if (buf) {
-				Color c = p_variant;
-				encode_float(c.r, &buf[0]);
-				encode_float(c.g, &buf[4]);
-				encode_float(c.b, &buf[8]);
-				encode_float(c.a, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Color c = p_variant;
+			r_enc.put_float(c.r);
+			r_enc.put_float(c.g);
+			r_enc.put_float(c.b);
+			r_enc.put_float(c.a);
 
 		} break;
 		/*case Variant::RESOURCE: {
@@ -1093,14 +1113,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 				Object *obj = p_variant;
 				if (!obj) {
-					if (buf) {
-						encode_uint32(0, buf);
-						buf += 4;
-					}
-					r_len += 4;
+					r_enc.put_32(0);
 
 				} else {
-					_encode_string(obj->get_class(), buf, r_len);
+					r_enc.put_string(obj->get_class());
 
 					List<PropertyInfo> props;
 					obj->get_property_list(&props);
@@ -1113,43 +1129,29 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						pc++;
 					}
 
-					if (buf) {
-						encode_uint32(pc, buf);
-						buf += 4;
-					}
-
-					r_len += 4;
+					r_enc.put_32(pc);
 
 					for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
 
 						if (!(E->get().usage & PROPERTY_USAGE_STORAGE))
 							continue;
 
-						_encode_string(E->get().name, buf, r_len);
+						r_enc.put_string(E->get().name);
 
-						int len;
-						Error err = encode_variant(obj->get(E->get().name), buf, len, p_full_objects);
+						Error err = _encode_variant(obj->get(E->get().name), r_enc, p_full_objects);
 						if (err)
 							return err;
-						ERR_FAIL_COND_V(len % 4, ERR_BUG);
-						r_len += len;
-						if (buf)
-							buf += len;
 					}
 				}
 			} else {
-				if (buf) {
 
-					Object *obj = p_variant;
-					ObjectID id = 0;
-					if (obj && ObjectDB::instance_validate(obj)) {
-						id = obj->get_instance_id();
-					}
-
-					encode_uint64(id, buf);
+				Object *obj = p_variant;
+				ObjectID id = 0;
+				if (obj && ObjectDB::instance_validate(obj)) {
+					id = obj->get_instance_id();
 				}
 
-				r_len += 8;
+				r_enc.put_64(id);
 			}
 
 		} break;
@@ -1157,43 +1159,21 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Dictionary d = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(d.size()), buf);
-				buf += 4;
-			}
-			r_len += 4;
+			r_enc.put_32(uint32_t(d.size()));
 
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
 			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
 
-				/*
-				CharString utf8 = E->->utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length()+1,buf);
-					buf+=4;
-					copymem(buf,utf8.get_data(),utf8.length()+1);
-				}
-
-				r_len+=4+utf8.length()+1;
-				while (r_len%4)
-					r_len++; //pad
-				*/
-				int len;
-				encode_variant(E->get(), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(E->get(), r_enc, p_full_objects);
+				if (err)
+					return err;
 				Variant *v = d.getptr(E->get());
 				ERR_FAIL_COND_V(!v, ERR_BUG);
-				encode_variant(*v, buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				err = _encode_variant(*v, r_enc, p_full_objects);
+				if (err)
+					return err;
 			}
 
 		} break;
@@ -1201,21 +1181,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Array v = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(v.size()), buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			r_enc.put_32(uint32_t(v.size()));
 
 			for (int i = 0; i < v.size(); i++) {
 
-				int len;
-				encode_variant(v.get(i), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(v.get(i), r_enc, p_full_objects);
+				if (err)
+					return err;
 			}
 
 		} break;
@@ -1224,56 +1196,24 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			PoolVector<uint8_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(uint8_t);
 
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
+			r_enc.put_32(datalen);
+			uint8_t *w = r_enc.reserve(datalen);
+			if (w && datalen) {
 				PoolVector<uint8_t>::Read r = data.read();
-				copymem(buf, &r[0], datalen * datasize);
-				buf += datalen * datasize;
-			}
-
-			r_len += 4 + datalen * datasize;
-			while (r_len % 4) {
-				r_len++;
-				if (buf)
-					*(buf++) = 0;
+				copymem(w, r.ptr(), datalen);
 			}
+			r_enc.put_padding();
 
 		} break;
 		case Variant::POOL_INT_ARRAY: {
 
-			PoolVector<int> data = p_variant;
-			int datalen = data.size();
-			int datasize = sizeof(int32_t);
-
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<int>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_uint32(r[i], &buf[i * datasize]);
-			}
-
-			r_len += 4 + datalen * datasize;
+			_encode_pool_array<int, int>(p_variant, 1, r_enc);
 
 		} break;
 		case Variant::POOL_REAL_ARRAY: {
 
-			PoolVector<real_t> data = p_variant;
-			int datalen = data.size();
-			int datasize = sizeof(real_t);
-
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<real_t>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_float(r[i], &buf[i * datasize]);
-			}
-
-			r_len += 4 + datalen * datasize;
+			_encode_pool_array<real_t, real_t>(p_variant, 1, r_enc);
 
 		} break;
 		case Variant::POOL_STRING_ARRAY: {
@@ -1281,121 +1221,96 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<String> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			r_enc.put_32(len);
 
+			PoolVector<String>::Read r = data.read();
 			for (int i = 0; i < len; i++) {
 
-				CharString utf8 = data.get(i).utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length() + 1, buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length() + 1);
-					buf += utf8.length() + 1;
-				}
+				CharString utf8 = r[i].utf8();
 
-				r_len += 4 + utf8.length() + 1;
-				while (r_len % 4) {
-					r_len++; //pad
-					if (buf)
-						*(buf++) = 0;
-				}
+				r_enc.put_32(utf8.length() + 1);
+				r_enc.put_data(utf8.get_data(), utf8.length() + 1);
+				r_enc.put_padding();
 			}
 
 		} break;
 		case Variant::POOL_VECTOR2_ARRAY: {
 
-			PoolVector<Vector2> data = p_variant;
-			int len = data.size();
-
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
-
-					Vector2 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					buf += 4 * 2;
-				}
-			}
-
-			r_len += 4 * 2 * len;
+			_encode_pool_array<Vector2, real_t>(p_variant, 2, r_enc);
 
 		} break;
 		case Variant::POOL_VECTOR3_ARRAY: {
 
-			PoolVector<Vector3> data = p_variant;
-			int len = data.size();
-
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
+			_encode_pool_array<Vector3, real_t>(p_variant, 3, r_enc);
 
-					Vector3 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					encode_float(v.z, &buf[8]);
-					buf += 4 * 3;
-				}
-			}
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
 
-			r_len += 4 * 3 * len;
+			_encode_pool_array<Color, float>(p_variant, 4, r_enc);
 
 		} break;
-		case Variant::POOL_COLOR_ARRAY: {
+		default: {
+			ERR_FAIL_V(ERR_BUG);
+		}
+	}
 
-			PoolVector<Color> data = p_variant;
-			int len = data.size();
+	return OK;
+}
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
 
-			r_len += 4;
+	VariantEncoder enc(r_buffer);
+	Error err = _encode_variant(p_variant, enc, p_full_objects);
+	r_len = enc.ofs;
+	return err;
+}
 
-			if (buf) {
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_ofs, bool p_full_objects) {
 
-				for (int i = 0; i < len; i++) {
+	VariantEncoder enc(r_buffer, r_ofs);
+	Error err = _encode_variant(p_variant, enc, p_full_objects);
+	if (err == OK)
+		r_ofs = enc.ofs;
+	return err;
+}
 
-					Color c = data.get(i);
+Error decode_pool_array_view(PoolArrayView &r_view, const uint8_t *p_buffer, int p_len, int *r_len) {
 
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
-					buf += 4 * 4;
-				}
-			}
+	ERR_FAIL_COND_V(p_len < 8, ERR_INVALID_DATA);
 
-			r_len += 4 * 4 * len;
+	uint32_t type = decode_uint32(p_buffer) & ENCODE_MASK;
+	int32_t count = decode_uint32(p_buffer + 4);
+	int words;
 
-		} break;
+	switch (type) {
+		case Variant::POOL_BYTE_ARRAY: words = 0; break;
+		case Variant::POOL_INT_ARRAY:
+		case Variant::POOL_REAL_ARRAY: words = 1; break;
+		case Variant::POOL_VECTOR2_ARRAY: words = 2; break;
+		case Variant::POOL_VECTOR3_ARRAY: words = 3; break;
+		case Variant::POOL_COLOR_ARRAY: words = 4; break;
 		default: {
-			ERR_FAIL_V(ERR_BUG);
+			ERR_EXPLAIN("Only pool arrays of bytes, numbers, vectors and colors can be viewed");
+			ERR_FAIL_V(ERR_INVALID_PARAMETER);
 		}
 	}
 
+	int size = count;
+	if (words) {
+		ERR_FAIL_MUL_OF(count, 4 * words, ERR_INVALID_DATA);
+		size = count * 4 * words;
+	}
+	ERR_FAIL_COND_V(count < 0 || size > p_len - 8, ERR_INVALID_DATA);
+
+	r_view.type = Variant::Type(type);
+	r_view.count = count;
+	r_view.data = p_buffer + 8;
+
+	if (r_len) {
+		*r_len = 8 + size;
+		if (size % 4)
+			(*r_len) += 4 - size % 4;
+	}
+
 	return OK;
 }
@@ -199,7 +199,21 @@ public:
 	EncodedObjectAsID();
 };
 
+// Elements of an encoded pool array, read in place instead of decoding a copy.
+// They are little endian 32 bit words (bytes for POOL_BYTE_ARRAY) and stay
+// valid as long as the encoded buffer does.
+struct PoolArrayView {
+
+	Variant::Type type;
+	int count;
+	const uint8_t *data;
+};
+
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = false);
+Error decode_pool_array_view(PoolArrayView &r_view, const uint8_t *p_buffer, int p_len, int *r_len = NULL);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false);
+// Encodes in a single pass at r_ofs, growing r_buffer when it is too small,
+// and advances r_ofs past the data. The buffer may end up larger than r_ofs.
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_ofs, bool p_full_objects = false);
 
 #endif
@@ -30,6 +30,7 @@
 
 #include "pck_packer.h"
 
+#include "core/io/file_access_pack.h"
 #include "core/os/file_access.h"
 #include "core/version.h"
 
@@ -55,12 +56,16 @@ static void _pad(FileAccess *p_file, int p_bytes) {
 
 void PCKPacker::_bind_methods() {
 
-	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment"), &PCKPacker::pck_start);
+	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "compression"), &PCKPacker::pck_start, DEFVAL(COMPRESSION_NONE));
 	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path"), &PCKPacker::add_file);
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush);
+
+	BIND_ENUM_CONSTANT(COMPRESSION_NONE);
+	BIND_ENUM_CONSTANT(COMPRESSION_ZSTD);
+	BIND_ENUM_CONSTANT(COMPRESSION_ZSTD_DICTIONARY);
 };
 
-Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
+Error PCKPacker::pck_start(const String &p_file, int p_alignment, CompressionMode p_compression) {
 
 	file = FileAccess::open(p_file, FileAccess::WRITE);
 	if (file == NULL) {
@@ -69,9 +74,10 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 	};
 
 	alignment = p_alignment;
+	compression = p_compression;
 
 	file->store_32(0x43504447); // MAGIC
-	file->store_32(1); // # version
+	file->store_32(compression == COMPRESSION_NONE ? 1 : PackedData::PACK_VERSION_CHUNKED); // # version
 	file->store_32(VERSION_MAJOR); // # major
 	file->store_32(VERSION_MINOR); // # minor
 	file->store_32(0); // # revision
@@ -97,7 +103,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 	pf.path = p_file;
 	pf.src_path = p_src;
 	pf.size = f->get_len();
-	pf.offset_offset = 0;
 
 	files.push_back(pf);
 
@@ -114,51 +119,85 @@ Error PCKPacker::flush(bool p_verbose) {
 		return ERR_INVALID_PARAMETER;
 	};
 
-	// write the index
+	// lay out the header first, the file data goes after it and the file
+	// entries and the flat index are filled in once the data is written
 
-	file->store_32(files.size());
+	Vector<PackedData::IndexedFile> indexed_files;
+	indexed_files.resize(files.size());
 
+	uint64_t header_size = file->get_position() + 4;
+	uint64_t strings_size = 0;
 	for (int i = 0; i < files.size(); i++) {
 
-		file->store_pascal_string(files[i].path);
-		files.write[i].offset_offset = file->get_position();
-		file->store_64(0); // offset
-		file->store_64(files[i].size); // size
+		PackedData::IndexedFile &indexed = indexed_files.write[i];
+		indexed.path = files[i].path.utf8();
+		indexed.size = files[i].size;
+		zeromem(indexed.md5, 16);
 
-		// # empty md5
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-	};
+		header_size += 4 + indexed.path.length() + 8 + 8 + 16;
+		strings_size += indexed.path.length();
+	}
+
+	uint64_t index_pos = _align(header_size, PackedData::INDEX_ALIGNMENT);
+	uint64_t data_pos = _align(index_pos + PackedData::get_index_size(files.size(), strings_size), alignment);
 
-	uint64_t ofs = file->get_position();
-	ofs = _align(ofs, alignment);
+	uint64_t entries_pos = file->get_position();
+	_pad(file, data_pos - entries_pos);
 
-	_pad(file, ofs - file->get_position());
+	Vector<uint8_t> dictionary;
+	if (compression == COMPRESSION_ZSTD_DICTIONARY) {
+
+		// train it on the start of the files, that's what small files are made of
+		Vector<Vector<uint8_t> > samples;
+		int sampled = 0;
+		for (int i = 0; i < files.size() && sampled < PackedData::DICTIONARY_MAX_SAMPLES; i++) {
+
+			FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
+			ERR_CONTINUE(!src);
+			Vector<uint8_t> sample;
+			sample.resize(MIN(files[i].size, int(PackedData::DICTIONARY_SAMPLE_SIZE)));
+			sample.resize(src->get_buffer(sample.ptrw(), sample.size()));
+			memdelete(src);
+
+			sampled += sample.size();
+			samples.push_back(sample);
+		}
+
+		dictionary = PackedData::make_dictionary(samples);
+	}
+
+	uint64_t dictionary_pos = file->get_position();
+	if (dictionary.size()) {
+		file->store_buffer(dictionary.ptr(), dictionary.size());
+		_pad(file, _align(file->get_position(), alignment) - file->get_position());
+	}
 
 	const uint32_t buf_max = 65536;
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
+	// the dictionary is digested and the context set up once for all the files
+	Compression::ZstdContext *zstd_context = compression != COMPRESSION_NONE ? Compression::zstd_create_context() : NULL;
+	Compression::ZstdDictionary *zstd_dictionary = dictionary.size() ? Compression::zstd_create_dictionary(dictionary.ptr(), dictionary.size(), true) : NULL;
+
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
 
-		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-		while (to_write > 0) {
-
-			int read = src->get_buffer(buf, MIN(to_write, buf_max));
-			file->store_buffer(buf, read);
-			to_write -= read;
-		};
+		indexed_files.write[i].offset = file->get_position();
 
-		uint64_t pos = file->get_position();
-		file->seek(files[i].offset_offset); // go back to store the file's offset
-		file->store_64(ofs);
-		file->seek(pos);
+		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
+		if (compression != COMPRESSION_NONE) {
+			PackedData::store_chunked(file, src, files[i].size, zstd_context, zstd_dictionary);
+		} else {
+			uint64_t to_write = files[i].size;
+			while (to_write > 0) {
+
+				int read = src->get_buffer(buf, MIN(to_write, buf_max));
+				file->store_buffer(buf, read);
+				to_write -= read;
+			};
+		}
 
-		ofs = _align(ofs + files[i].size, alignment);
-		_pad(file, ofs - pos);
+		_pad(file, _align(file->get_position(), alignment) - file->get_position());
 
 		src->close();
 		memdelete(src);
@@ -174,8 +213,40 @@ Error PCKPacker::flush(bool p_verbose) {
 	if (p_verbose)
 		printf("\n");
 
-	file->close();
 	memdelete_arr(buf);
+	Compression::zstd_free_dictionary(zstd_dictionary);
+	Compression::zstd_free_context(zstd_context);
+
+	// the reserved words point to the flat index, then the compression flags and the dictionary
+
+	file->seek(entries_pos - 16 * 4); // first reserved words
+	file->store_64(index_pos);
+	file->store_32(compression != COMPRESSION_NONE ? PackedData::PACK_FLAG_CHUNKED_ZSTD : 0);
+	file->store_64(dictionary.size() ? dictionary_pos : 0);
+	file->store_32(dictionary.size());
+	file->seek(entries_pos);
+
+	file->store_32(files.size());
+
+	for (int i = 0; i < files.size(); i++) {
+
+		file->store_pascal_string(files[i].path);
+		file->store_64(indexed_files[i].offset); // offset
+		file->store_64(files[i].size); // size
+
+		// # empty md5
+		file->store_32(0);
+		file->store_32(0);
+		file->store_32(0);
+		file->store_32(0);
+	};
+
+	_pad(file, index_pos - file->get_position());
+
+	Vector<uint8_t> index = PackedData::make_index(indexed_files);
+	file->store_buffer(index.ptr(), index.size());
+
+	file->close();
 
 	return OK;
 };
@@ -183,6 +254,8 @@ Error PCKPacker::flush(bool p_verbose) {
 PCKPacker::PCKPacker() {
 
 	file = NULL;
+	alignment = 0;
+	compression = COMPRESSION_NONE;
 };
 
 PCKPacker::~PCKPacker() {
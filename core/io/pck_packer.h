@@ -39,8 +39,17 @@ class PCKPacker : public Reference {
 
 	GDCLASS(PCKPacker, Reference);
 
+public:
+	enum CompressionMode {
+		COMPRESSION_NONE,
+		COMPRESSION_ZSTD,
+		COMPRESSION_ZSTD_DICTIONARY,
+	};
+
+private:
 	FileAccess *file;
 	int alignment;
+	CompressionMode compression;
 
 	static void _bind_methods();
 
@@ -49,12 +58,11 @@ class PCKPacker : public Reference {
 		String path;
 		String src_path;
 		int size;
-		uint64_t offset_offset;
 	};
 	Vector<File> files;
 
 public:
-	Error pck_start(const String &p_file, int p_alignment);
+	Error pck_start(const String &p_file, int p_alignment = 0, CompressionMode p_compression = COMPRESSION_NONE);
 	Error add_file(const String &p_file, const String &p_src);
 	Error flush(bool p_verbose = false);
 
@@ -62,4 +70,6 @@ public:
 	~PCKPacker();
 };
 
+VARIANT_ENUM_CAST(PCKPacker::CompressionMode);
+
 #endif // PCK_PACKER_H
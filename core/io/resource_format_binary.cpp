@@ -111,9 +111,14 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 		}
 		if (len == 0)
 			return StringName();
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
-		s.parse_utf8(&str_buf[0]);
+		const uint8_t *direct = f->get_buffer_direct(len);
+		if (direct) {
+			s.parse_utf8((const char *)direct, len);
+		} else {
+			f->get_buffer((uint8_t *)&str_buf[0], len);
+			s.parse_utf8(&str_buf[0], len);
+		}
 		return s;
 	}
 
@@ -793,11 +798,16 @@ static void save_ustring(FileAccess *f, const String &p_string) {
 static String get_ustring(FileAccess *f) {
 
 	int len = f->get_32();
+	String s;
+	const uint8_t *direct = f->get_buffer_direct(len);
+	if (direct) {
+		s.parse_utf8((const char *)direct, len);
+		return s;
+	}
 	Vector<char> str_buf;
 	str_buf.resize(len);
 	f->get_buffer((uint8_t *)&str_buf[0], len);
-	String s;
-	s.parse_utf8(&str_buf[0]);
+	s.parse_utf8(&str_buf[0], len);
 	return s;
 }
 
@@ -809,9 +819,14 @@ String ResourceInteractiveLoaderBinary::get_unicode_string() {
 	}
 	if (len == 0)
 		return String();
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
-	s.parse_utf8(&str_buf[0]);
+	const uint8_t *direct = f->get_buffer_direct(len);
+	if (direct) {
+		s.parse_utf8((const char *)direct, len);
+	} else {
+		f->get_buffer((uint8_t *)&str_buf[0], len);
+		s.parse_utf8(&str_buf[0], len);
+	}
 	return s;
 }
 
@@ -202,6 +202,15 @@ bool ResourceFormatImporter::can_be_imported(const String &p_path) const {
 
 int ResourceFormatImporter::get_import_order(const String &p_path) const {
 
+	int order = 0;
+	bool can_threads = false;
+	String importer;
+	get_import_order_threads_and_importer(p_path, order, can_threads, importer);
+	return order;
+}
+
+void ResourceFormatImporter::get_import_order_threads_and_importer(const String &p_path, int &r_order, bool &r_can_threads, String &r_importer) const {
+
 	Ref<ResourceImporter> importer;
 
 	if (FileAccess::exists(p_path + ".import")) {
@@ -217,10 +226,15 @@ int ResourceFormatImporter::get_import_order(const String &p_path) const {
 		importer = get_importer_by_extension(p_path.get_extension().to_lower());
 	}
 
-	if (importer.is_valid())
-		return importer->get_import_order();
-
-	return 0;
+	if (importer.is_valid()) {
+		r_order = importer->get_import_order();
+		r_can_threads = importer->can_import_threaded();
+		r_importer = importer->get_importer_name();
+	} else {
+		r_order = 0;
+		r_can_threads = false;
+		r_importer = String();
+	}
 }
 
 bool ResourceFormatImporter::handles_type(const String &p_type) const {
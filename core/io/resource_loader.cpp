@@ -343,6 +343,99 @@ void ResourceLoader::_remove_from_loading_map_and_thread(const String &p_path, T
 	}
 }
 
+RES ResourceLoader::_get_cached(const String &p_path) {
+
+	//lock first if possible
+	if (ResourceCache::lock) {
+		ResourceCache::lock->read_lock();
+	}
+
+	//get ptr
+	Resource **rptr = ResourceCache::resources.getptr(p_path);
+
+	//it is possible this resource was just freed in a thread. If so, this referencing will not work and resource is considered not cached
+	RES res;
+	if (rptr) {
+		res = RES(*rptr);
+	}
+
+	if (ResourceCache::lock) {
+		ResourceCache::lock->read_unlock();
+	}
+
+	return res;
+}
+
+Error ResourceLoader::_claim_loading_path(const String &p_path, RES &r_cached) {
+
+	if (!loading_map_mutex) {
+		r_cached = _get_cached(p_path);
+		return OK;
+	}
+
+	Thread::ID self = Thread::get_caller_id();
+
+	while (true) {
+
+		loading_map_mutex->lock();
+
+		//loaders add the resource to the cache before it is filled, so the
+		//cache can only be trusted once no other thread is loading the path
+		Thread::ID *owner = loading_paths.getptr(p_path);
+		if (!owner) {
+			r_cached = _get_cached(p_path);
+			if (r_cached.is_null()) {
+				loading_paths[p_path] = self;
+			}
+			loading_map_mutex->unlock();
+			return OK;
+		}
+
+		//waiting for a thread that is in turn waiting for this one would never end
+		Thread::ID t = *owner;
+		while (true) {
+			if (t == self) {
+				loading_map_mutex->unlock();
+				return ERR_CYCLIC_LINK;
+			}
+			String *waiting = loading_waits.getptr(t);
+			Thread::ID *next = waiting ? loading_paths.getptr(*waiting) : NULL;
+			if (!next)
+				break;
+			t = *next;
+		}
+
+		loading_waits[self] = p_path;
+		loading_map_mutex->unlock();
+
+		_wait_a_little();
+
+		loading_map_mutex->lock();
+		loading_waits.erase(self);
+		loading_map_mutex->unlock();
+	}
+}
+
+void ResourceLoader::_release_loading_path(const String &p_path) {
+
+	if (!loading_map_mutex)
+		return;
+
+	loading_map_mutex->lock();
+	loading_paths.erase(p_path);
+	loading_map_mutex->unlock();
+}
+
+void ResourceLoader::_wait_a_little() {
+
+	//things like creating textures may need the main thread, keep it doing that while it waits
+	if (wait_callback && Thread::get_caller_id() == Thread::get_main_id()) {
+		wait_callback();
+	}
+
+	OS::get_singleton()->delay_usec(100);
+}
+
 RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
 	if (r_error)
@@ -364,30 +457,19 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 			}
 		}
 
-		//lock first if possible
-		if (ResourceCache::lock) {
-			ResourceCache::lock->read_lock();
+		//if another thread is loading it, wait for it and take the result from the cache
+		RES cached;
+		if (_claim_loading_path(local_path, cached) != OK) {
+			_remove_from_loading_map(local_path);
+			ERR_EXPLAIN("Resource: '" + local_path + "' is being loaded by a thread waiting for this one. Cyclic reference?");
+			ERR_FAIL_V(RES());
 		}
 
-		//get ptr
-		Resource **rptr = ResourceCache::resources.getptr(local_path);
-
-		if (rptr) {
-			RES res(*rptr);
-			//it is possible this resource was just freed in a thread. If so, this referencing will not work and resource is considered not cached
-			if (res.is_valid()) {
-				//referencing is fine
-				if (r_error)
-					*r_error = OK;
-				if (ResourceCache::lock) {
-					ResourceCache::lock->read_unlock();
-				}
-				_remove_from_loading_map(local_path);
-				return res;
-			}
-		}
-		if (ResourceCache::lock) {
-			ResourceCache::lock->read_unlock();
+		if (cached.is_valid()) {
+			if (r_error)
+				*r_error = OK;
+			_remove_from_loading_map(local_path);
+			return cached;
 		}
 	}
 
@@ -396,6 +478,7 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 
 	if (path == "") {
 		if (!p_no_cache) {
+			_release_loading_path(local_path);
 			_remove_from_loading_map(local_path);
 		}
 		ERR_EXPLAIN("Remapping '" + local_path + "'failed.");
@@ -407,6 +490,7 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 
 	if (res.is_null()) {
 		if (!p_no_cache) {
+			_release_loading_path(local_path);
 			_remove_from_loading_map(local_path);
 		}
 		return RES();
@@ -428,6 +512,7 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 #endif
 
 	if (!p_no_cache) {
+		_release_loading_path(local_path);
 		_remove_from_loading_map(local_path);
 	}
 
@@ -468,6 +553,300 @@ bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 	return false;
 }
 
+String ResourceLoader::_localize(const String &p_path) {
+
+	if (p_path.is_rel_path())
+		return "res://" + p_path;
+	return ProjectSettings::get_singleton()->localize_path(p_path);
+}
+
+void ResourceLoader::_queue_thread_load_task(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	ThreadLoadTask task;
+	task.type_hint = p_type_hint;
+	task.priority = p_priority;
+	task.order = thread_load_order++;
+	task.started = false;
+	task.status = THREAD_LOAD_IN_PROGRESS;
+	task.error = OK;
+	task.requests = 0;
+	task.users = 0;
+	thread_load_tasks[p_path] = task;
+
+	if (thread_load_semaphore) {
+		thread_load_semaphore->post();
+	}
+}
+
+bool ResourceLoader::_take_thread_load_task(String &r_path) {
+
+	//highest priority first, then in request order
+	const String *best = NULL;
+	const ThreadLoadTask *best_task = NULL;
+	const String *K = NULL;
+	while ((K = thread_load_tasks.next(K))) {
+
+		const ThreadLoadTask &task = thread_load_tasks[*K];
+		if (task.started)
+			continue;
+		if (!best_task || task.priority > best_task->priority || (task.priority == best_task->priority && task.order < best_task->order)) {
+			best = K;
+			best_task = &task;
+		}
+	}
+
+	if (!best)
+		return false;
+
+	thread_load_tasks[*best].started = true;
+	r_path = *best;
+	return true;
+}
+
+void ResourceLoader::_run_thread_load_task(const String &p_path) {
+
+	thread_load_mutex->lock();
+	ThreadLoadTask *task = thread_load_tasks.getptr(p_path);
+	String type_hint = task->type_hint;
+	int priority = task->priority;
+	thread_load_mutex->unlock();
+
+	//queue the dependencies as tasks of their own, so other threads load
+	//them while this one goes through the file; when this one gets to a
+	//dependency that is already being loaded it waits for it instead
+	List<String> dependencies;
+	get_dependencies(p_path, &dependencies);
+
+	thread_load_mutex->lock();
+	for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+
+		String dependency = _localize(E->get());
+		if (dependency == p_path || ResourceCache::has(dependency))
+			continue;
+
+		ThreadLoadTask *dependency_task = thread_load_tasks.getptr(dependency);
+		if (!dependency_task) {
+			_queue_thread_load_task(dependency, String(), priority + 1);
+			dependency_task = thread_load_tasks.getptr(dependency);
+		}
+		dependency_task->users++;
+		thread_load_tasks.getptr(p_path)->dependencies.push_back(dependency);
+	}
+	thread_load_mutex->unlock();
+
+	Error err = OK;
+	RES res = load(p_path, type_hint, false, &err);
+
+	thread_load_mutex->lock();
+
+	task = thread_load_tasks.getptr(p_path);
+	task->resource = res;
+	task->error = res.is_valid() ? OK : (err != OK ? err : FAILED);
+	task->status = res.is_valid() ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+
+	//dependencies no longer need to be kept alive, the resource references them now
+	Vector<String> done_dependencies = task->dependencies;
+	task->dependencies.clear();
+	for (int i = 0; i < done_dependencies.size(); i++) {
+		ThreadLoadTask *dependency = thread_load_tasks.getptr(done_dependencies[i]);
+		if (dependency) { //may have been dropped by clear_thread_load_tasks()
+			dependency->users--;
+			_release_thread_load_task(done_dependencies[i]);
+		}
+	}
+	_release_thread_load_task(p_path);
+
+	thread_load_mutex->unlock();
+}
+
+void ResourceLoader::_release_thread_load_task(const String &p_path) {
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(p_path);
+	if (task->requests > 0 || task->users > 0)
+		return;
+
+	if (task->started && task->status == THREAD_LOAD_IN_PROGRESS)
+		return; //the thread loading it releases it when done
+
+	thread_load_tasks.erase(p_path);
+}
+
+void ResourceLoader::_thread_load_worker(void *p_userdata) {
+
+	while (true) {
+
+		thread_load_semaphore->wait();
+		if (thread_load_exit)
+			break;
+
+		String path;
+		thread_load_mutex->lock();
+		bool found = _take_thread_load_task(path);
+		thread_load_mutex->unlock();
+
+		if (found) {
+			_run_thread_load_task(path);
+		}
+	}
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	String local_path = _localize(p_path);
+
+	ERR_FAIL_COND_V(!thread_load_mutex, ERR_UNAVAILABLE);
+
+	thread_load_mutex->lock();
+
+#ifndef NO_THREADS
+	if (thread_load_workers.empty() && !thread_load_exit) {
+		int count = MAX(1, OS::get_singleton()->get_processor_count() - 1);
+		for (int i = 0; i < count; i++) {
+			thread_load_workers.push_back(Thread::create(_thread_load_worker, NULL));
+		}
+	}
+#endif
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (task) {
+		task->priority = MAX(task->priority, p_priority);
+		if (task->type_hint == String()) {
+			task->type_hint = p_type_hint;
+		}
+	} else {
+		_queue_thread_load_task(local_path, p_type_hint, p_priority);
+		task = thread_load_tasks.getptr(local_path);
+	}
+	task->requests++;
+
+	bool run_now = thread_load_workers.empty() && !task->started;
+	if (run_now) {
+		task->started = true;
+	}
+
+	thread_load_mutex->unlock();
+
+	if (run_now) {
+		_run_thread_load_task(local_path);
+	}
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
+
+	String local_path = _localize(p_path);
+
+	ERR_FAIL_COND_V(!thread_load_mutex, THREAD_LOAD_INVALID_RESOURCE);
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (!task || task->requests == 0) {
+		thread_load_mutex->unlock();
+		return THREAD_LOAD_INVALID_RESOURCE;
+	}
+
+	ThreadLoadStatus status = task->status;
+
+	if (r_progress) {
+		if (status != THREAD_LOAD_IN_PROGRESS) {
+			*r_progress = 1.0;
+		} else {
+			//rough, counts the direct dependencies already loaded
+			int done = 0;
+			for (int i = 0; i < task->dependencies.size(); i++) {
+				const ThreadLoadTask *dependency = thread_load_tasks.getptr(task->dependencies[i]);
+				if (!dependency || dependency->status != THREAD_LOAD_IN_PROGRESS) {
+					done++;
+				}
+			}
+			*r_progress = float(done) / (task->dependencies.size() + 1);
+		}
+	}
+
+	thread_load_mutex->unlock();
+
+	return status;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+
+	String local_path = _localize(p_path);
+
+	if (r_error)
+		*r_error = ERR_INVALID_PARAMETER;
+
+	ERR_FAIL_COND_V(!thread_load_mutex, RES());
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask *task = thread_load_tasks.getptr(local_path);
+	if (!task || task->requests == 0) {
+		thread_load_mutex->unlock();
+		ERR_EXPLAIN("Resource: '" + local_path + "' was not requested with load_threaded_request().");
+		ERR_FAIL_V(RES());
+	}
+
+	if (!task->started) {
+		//no thread got to it yet, load it here instead of waiting
+		task->started = true;
+		thread_load_mutex->unlock();
+		_run_thread_load_task(local_path);
+		thread_load_mutex->lock();
+	}
+
+	while (thread_load_tasks.getptr(local_path)->status == THREAD_LOAD_IN_PROGRESS) {
+		thread_load_mutex->unlock();
+		_wait_a_little();
+		thread_load_mutex->lock();
+	}
+
+	task = thread_load_tasks.getptr(local_path);
+	RES res = task->resource;
+	if (r_error)
+		*r_error = task->error;
+
+	task->requests--;
+	_release_thread_load_task(local_path);
+
+	thread_load_mutex->unlock();
+
+	return res;
+}
+
+void ResourceLoader::clear_thread_load_tasks() {
+
+	if (!thread_load_mutex)
+		return;
+
+	thread_load_mutex->lock();
+	thread_load_exit = true;
+	//tasks not started yet are dropped, the ones being loaded finish
+	const String *K = NULL;
+	List<String> pending;
+	while ((K = thread_load_tasks.next(K))) {
+		if (!thread_load_tasks[*K].started) {
+			pending.push_back(*K);
+		}
+	}
+	for (List<String>::Element *E = pending.front(); E; E = E->next()) {
+		thread_load_tasks.erase(E->get());
+	}
+	thread_load_mutex->unlock();
+
+	for (int i = 0; i < thread_load_workers.size(); i++) {
+		thread_load_semaphore->post();
+	}
+	for (int i = 0; i < thread_load_workers.size(); i++) {
+		Thread::wait_to_finish(thread_load_workers[i]);
+		memdelete(thread_load_workers[i]);
+	}
+	thread_load_workers.clear();
+
+	thread_load_tasks.clear();
+}
+
 Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 
 	if (r_error)
@@ -995,25 +1374,46 @@ void ResourceLoader::remove_custom_loaders() {
 
 Mutex *ResourceLoader::loading_map_mutex = NULL;
 HashMap<ResourceLoader::LoadingMapKey, int, ResourceLoader::LoadingMapKeyHasher> ResourceLoader::loading_map;
+HashMap<String, Thread::ID> ResourceLoader::loading_paths;
+HashMap<Thread::ID, String> ResourceLoader::loading_waits;
+
+HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
+Mutex *ResourceLoader::thread_load_mutex = NULL;
+Semaphore *ResourceLoader::thread_load_semaphore = NULL;
+Vector<Thread *> ResourceLoader::thread_load_workers;
+bool ResourceLoader::thread_load_exit = false;
+uint64_t ResourceLoader::thread_load_order = 0;
 
 void ResourceLoader::initialize() {
 #ifndef NO_THREADS
 	loading_map_mutex = Mutex::create();
+	thread_load_semaphore = Semaphore::create();
 #endif
+	thread_load_mutex = Mutex::create();
+	thread_load_exit = false;
 }
 
 void ResourceLoader::finalize() {
+	clear_thread_load_tasks();
+	memdelete(thread_load_mutex);
+	thread_load_mutex = NULL;
 #ifndef NO_THREADS
+	memdelete(thread_load_semaphore);
+	thread_load_semaphore = NULL;
+
 	const LoadingMapKey *K = NULL;
 	while ((K = loading_map.next(K))) {
 		ERR_PRINTS("Exited while resource is being loaded: " + K->path);
 	}
 	loading_map.clear();
+	loading_paths.clear();
 	memdelete(loading_map_mutex);
 	loading_map_mutex = NULL;
 #endif
 }
 
+ResourceLoadWaitCallback ResourceLoader::wait_callback = NULL;
+
 ResourceLoadErrorNotify ResourceLoader::err_notify = NULL;
 void *ResourceLoader::err_notify_ud = NULL;
 
@@ -31,6 +31,7 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/resource.h"
 /**
@@ -91,9 +92,19 @@ typedef void (*DependencyErrorNotify)(void *p_ud, const String &p_loading, const
 
 typedef Error (*ResourceLoaderImport)(const String &p_path);
 typedef void (*ResourceLoadedCallback)(RES p_resource, const String &p_path);
+typedef void (*ResourceLoadWaitCallback)();
 
 class ResourceLoader {
 
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
+private:
 	enum {
 		MAX_LOADERS = 64
 	};
@@ -140,15 +151,59 @@ class ResourceLoader {
 
 	static HashMap<LoadingMapKey, int, LoadingMapKeyHasher> loading_map;
 
+	//paths being loaded by load() and the thread loading each, other threads wait for it instead of loading the path again
+	static HashMap<String, Thread::ID> loading_paths;
+	static HashMap<Thread::ID, String> loading_waits;
+
 	static bool _add_to_loading_map(const String &p_path);
 	static void _remove_from_loading_map(const String &p_path);
 	static void _remove_from_loading_map_and_thread(const String &p_path, Thread::ID p_thread);
 
+	static RES _get_cached(const String &p_path);
+	static Error _claim_loading_path(const String &p_path, RES &r_cached);
+	static void _release_loading_path(const String &p_path);
+
+	static ResourceLoadWaitCallback wait_callback;
+	static void _wait_a_little();
+
+	//background loading, see load_threaded_request()
+	struct ThreadLoadTask {
+		String type_hint;
+		int priority;
+		uint64_t order;
+		bool started;
+		ThreadLoadStatus status;
+		Error error;
+		RES resource;
+		int requests; //load_threaded_request() calls not yet matched by load_threaded_get()
+		int users; //tasks that queued this one as a dependency and are not done yet
+		Vector<String> dependencies;
+	};
+
+	static HashMap<String, ThreadLoadTask> thread_load_tasks;
+	static Mutex *thread_load_mutex;
+	static Semaphore *thread_load_semaphore;
+	static Vector<Thread *> thread_load_workers;
+	static bool thread_load_exit;
+	static uint64_t thread_load_order;
+
+	static String _localize(const String &p_path);
+	static void _queue_thread_load_task(const String &p_path, const String &p_type_hint, int p_priority);
+	static bool _take_thread_load_task(String &r_path);
+	static void _run_thread_load_task(const String &p_path);
+	static void _release_thread_load_task(const String &p_path);
+	static void _thread_load_worker(void *p_userdata);
+
 public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", int p_priority = 0);
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = NULL);
+	static RES load_threaded_get(const String &p_path, Error *r_error = NULL);
+	static void clear_thread_load_tasks();
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front = false);
 	static void remove_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader);
@@ -193,6 +248,7 @@ public:
 	static void clear_translation_remaps();
 
 	static void set_load_callback(ResourceLoadedCallback p_callback);
+	static void set_wait_callback(ResourceLoadWaitCallback p_callback) { wait_callback = p_callback; } //called on the main thread while it waits for other threads to load something
 	static ResourceLoaderImport import;
 
 	static bool add_custom_resource_format_loader(String script_path);
@@ -225,11 +225,9 @@ void StreamPeer::put_var(const Variant &p_variant, bool p_full_objects) {
 
 	int len = 0;
 	Vector<uint8_t> buf;
-	encode_variant(p_variant, NULL, len, p_full_objects);
-	buf.resize(len);
+	encode_variant(p_variant, buf, len, p_full_objects);
 	put_32(len);
-	encode_variant(p_variant, buf.ptrw(), len, p_full_objects);
-	put_data(buf.ptr(), buf.size());
+	put_data(buf.ptr(), len);
 }
 
 uint8_t StreamPeer::get_u8() {
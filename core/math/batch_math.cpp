@@ -0,0 +1,304 @@
+/*************************************************************************/
+/*  batch_math.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "batch_math.h"
+
+#include "core/math/simd.h"
+
+#define STRIDED(m_type, m_ptr, m_stride, m_index) ((m_type *)((uint8_t *)(m_ptr) + (size_t)(m_index) * (m_stride)))
+
+void BatchMath::xform_points(const Transform &p_xform, const Vector3 *p_src, Vector3 *p_dst, int p_count) {
+
+	int i = 0;
+
+#ifdef SIMD_ENABLED
+	const Basis &b = p_xform.basis;
+	const simd_float4 m00 = simd_splat(b.elements[0][0]), m01 = simd_splat(b.elements[0][1]), m02 = simd_splat(b.elements[0][2]);
+	const simd_float4 m10 = simd_splat(b.elements[1][0]), m11 = simd_splat(b.elements[1][1]), m12 = simd_splat(b.elements[1][2]);
+	const simd_float4 m20 = simd_splat(b.elements[2][0]), m21 = simd_splat(b.elements[2][1]), m22 = simd_splat(b.elements[2][2]);
+	const simd_float4 ox = simd_splat(p_xform.origin.x), oy = simd_splat(p_xform.origin.y), oz = simd_splat(p_xform.origin.z);
+
+	for (; i + 4 <= p_count; i += 4) {
+
+		simd_float4 x, y, z;
+		simd_load3x4(&p_src[i].x, x, y, z);
+
+		simd_float4 rx = simd_madd(m00, x, simd_madd(m01, y, simd_madd(m02, z, ox)));
+		simd_float4 ry = simd_madd(m10, x, simd_madd(m11, y, simd_madd(m12, z, oy)));
+		simd_float4 rz = simd_madd(m20, x, simd_madd(m21, y, simd_madd(m22, z, oz)));
+
+		simd_store3x4(&p_dst[i].x, rx, ry, rz);
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_dst[i] = p_xform.xform(p_src[i]);
+	}
+}
+
+void BatchMath::xform_vectors(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, int p_count) {
+
+	int i = 0;
+
+#ifdef SIMD_ENABLED
+	const Basis &b = p_basis;
+	const simd_float4 m00 = simd_splat(b.elements[0][0]), m01 = simd_splat(b.elements[0][1]), m02 = simd_splat(b.elements[0][2]);
+	const simd_float4 m10 = simd_splat(b.elements[1][0]), m11 = simd_splat(b.elements[1][1]), m12 = simd_splat(b.elements[1][2]);
+	const simd_float4 m20 = simd_splat(b.elements[2][0]), m21 = simd_splat(b.elements[2][1]), m22 = simd_splat(b.elements[2][2]);
+
+	for (; i + 4 <= p_count; i += 4) {
+
+		simd_float4 x, y, z;
+		simd_load3x4(&p_src[i].x, x, y, z);
+
+		simd_float4 rx = simd_madd(m00, x, simd_madd(m01, y, simd_mul(m02, z)));
+		simd_float4 ry = simd_madd(m10, x, simd_madd(m11, y, simd_mul(m12, z)));
+		simd_float4 rz = simd_madd(m20, x, simd_madd(m21, y, simd_mul(m22, z)));
+
+		simd_store3x4(&p_dst[i].x, rx, ry, rz);
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_dst[i] = p_basis.xform(p_src[i]);
+	}
+}
+
+#ifdef SIMD_ENABLED
+
+// rows of p_a * p_b, each row holding 3 basis elements and the origin component
+static _FORCE_INLINE_ void _mul_transform_rows(const Transform &p_a, const Transform &p_b, simd_float4 &r_row0, simd_float4 &r_row1, simd_float4 &r_row2) {
+
+	const Basis &a = p_a.basis;
+	const Basis &b = p_b.basis;
+
+	simd_float4 b0 = simd_set(b.elements[0][0], b.elements[0][1], b.elements[0][2], p_b.origin.x);
+	simd_float4 b1 = simd_set(b.elements[1][0], b.elements[1][1], b.elements[1][2], p_b.origin.y);
+	simd_float4 b2 = simd_set(b.elements[2][0], b.elements[2][1], b.elements[2][2], p_b.origin.z);
+
+	r_row0 = simd_madd(simd_splat(a.elements[0][0]), b0, simd_madd(simd_splat(a.elements[0][1]), b1, simd_madd(simd_splat(a.elements[0][2]), b2, simd_set(0, 0, 0, p_a.origin.x))));
+	r_row1 = simd_madd(simd_splat(a.elements[1][0]), b0, simd_madd(simd_splat(a.elements[1][1]), b1, simd_madd(simd_splat(a.elements[1][2]), b2, simd_set(0, 0, 0, p_a.origin.y))));
+	r_row2 = simd_madd(simd_splat(a.elements[2][0]), b0, simd_madd(simd_splat(a.elements[2][1]), b1, simd_madd(simd_splat(a.elements[2][2]), b2, simd_set(0, 0, 0, p_a.origin.z))));
+}
+
+#endif
+
+void BatchMath::mul_transforms(const Transform *p_a, const Transform *p_b, Transform *r_dst, int p_count, int p_stride) {
+
+	for (int i = 0; i < p_count; i++) {
+
+		const Transform &a = *STRIDED(const Transform, p_a, p_stride, i);
+		const Transform &b = *STRIDED(const Transform, p_b, p_stride, i);
+		Transform &dst = *STRIDED(Transform, r_dst, p_stride, i);
+
+#ifdef SIMD_ENABLED
+		simd_float4 r0, r1, r2;
+		_mul_transform_rows(a, b, r0, r1, r2);
+
+		float rows[12];
+		simd_store(&rows[0], r0);
+		simd_store(&rows[4], r1);
+		simd_store(&rows[8], r2);
+
+		dst.basis.elements[0] = Vector3(rows[0], rows[1], rows[2]);
+		dst.basis.elements[1] = Vector3(rows[4], rows[5], rows[6]);
+		dst.basis.elements[2] = Vector3(rows[8], rows[9], rows[10]);
+		dst.origin = Vector3(rows[3], rows[7], rows[11]);
+#else
+		dst = a * b;
+#endif
+	}
+}
+
+void BatchMath::xform_to_rows(const Transform &p_xform, const Transform *p_src, int p_src_stride, const int *p_order, float *p_dst, int p_dst_stride, int p_count) {
+
+	for (int i = 0; i < p_count; i++) {
+
+		const Transform &src = *STRIDED(const Transform, p_src, p_src_stride, p_order ? p_order[i] : i);
+
+#ifdef SIMD_ENABLED
+		simd_float4 r0, r1, r2;
+		_mul_transform_rows(p_xform, src, r0, r1, r2);
+
+		simd_store(&p_dst[0], r0);
+		simd_store(&p_dst[4], r1);
+		simd_store(&p_dst[8], r2);
+#else
+		Transform t = p_xform * src;
+		for (int j = 0; j < 3; j++) {
+			p_dst[j * 4 + 0] = t.basis.elements[j][0];
+			p_dst[j * 4 + 1] = t.basis.elements[j][1];
+			p_dst[j * 4 + 2] = t.basis.elements[j][2];
+			p_dst[j * 4 + 3] = t.origin[j];
+		}
+#endif
+		p_dst += p_dst_stride;
+	}
+}
+
+AABB BatchMath::merge_aabbs(const AABB *p_aabbs, int p_count) {
+
+	if (p_count <= 0) {
+		return AABB();
+	}
+
+	Vector3 begin = p_aabbs[0].position;
+	Vector3 end = p_aabbs[0].position + p_aabbs[0].size;
+	int i = 1;
+
+#ifdef SIMD_ENABLED
+	// the 4th lane is garbage, loading the size reads the next box so the last one is left to the scalar loop
+	simd_float4 vbegin = simd_set(begin.x, begin.y, begin.z, 0);
+	simd_float4 vend = simd_set(end.x, end.y, end.z, 0);
+
+	for (; i < p_count - 1; i++) {
+		simd_float4 pos = simd_load(&p_aabbs[i].position.x);
+		vbegin = simd_min(vbegin, pos);
+		vend = simd_max(vend, simd_add(pos, simd_load(&p_aabbs[i].size.x)));
+	}
+
+	float b[4], e[4];
+	simd_store(b, vbegin);
+	simd_store(e, vend);
+	begin = Vector3(b[0], b[1], b[2]);
+	end = Vector3(e[0], e[1], e[2]);
+#endif
+
+	for (; i < p_count; i++) {
+		const AABB &aabb = p_aabbs[i];
+		Vector3 aabb_end = aabb.position + aabb.size;
+		begin = Vector3(MIN(begin.x, aabb.position.x), MIN(begin.y, aabb.position.y), MIN(begin.z, aabb.position.z));
+		end = Vector3(MAX(end.x, aabb_end.x), MAX(end.y, aabb_end.y), MAX(end.z, aabb_end.z));
+	}
+
+	return AABB(begin, end - begin);
+}
+
+AABB BatchMath::compute_aabb(const Vector3 *p_points, int p_count) {
+
+	if (p_count <= 0) {
+		return AABB();
+	}
+
+	Vector3 begin = p_points[0];
+	Vector3 end = p_points[0];
+	int i = 0;
+
+#ifdef SIMD_ENABLED
+	if (p_count >= 4) {
+
+		simd_float4 min_x, min_y, min_z;
+		simd_load3x4(&p_points[0].x, min_x, min_y, min_z);
+		simd_float4 max_x = min_x, max_y = min_y, max_z = min_z;
+
+		for (i = 4; i + 4 <= p_count; i += 4) {
+			simd_float4 x, y, z;
+			simd_load3x4(&p_points[i].x, x, y, z);
+			min_x = simd_min(min_x, x);
+			min_y = simd_min(min_y, y);
+			min_z = simd_min(min_z, z);
+			max_x = simd_max(max_x, x);
+			max_y = simd_max(max_y, y);
+			max_z = simd_max(max_z, z);
+		}
+
+		float lanes[6][4];
+		simd_store(lanes[0], min_x);
+		simd_store(lanes[1], min_y);
+		simd_store(lanes[2], min_z);
+		simd_store(lanes[3], max_x);
+		simd_store(lanes[4], max_y);
+		simd_store(lanes[5], max_z);
+
+		for (int j = 0; j < 4; j++) {
+			begin = Vector3(MIN(begin.x, lanes[0][j]), MIN(begin.y, lanes[1][j]), MIN(begin.z, lanes[2][j]));
+			end = Vector3(MAX(end.x, lanes[3][j]), MAX(end.y, lanes[4][j]), MAX(end.z, lanes[5][j]));
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		const Vector3 &p = p_points[i];
+		begin = Vector3(MIN(begin.x, p.x), MIN(begin.y, p.y), MIN(begin.z, p.z));
+		end = Vector3(MAX(end.x, p.x), MAX(end.y, p.y), MAX(end.z, p.z));
+	}
+
+	return AABB(begin, end - begin);
+}
+
+int BatchMath::cull_aabbs(const Plane *p_planes, int p_plane_count, const AABB *p_aabbs, int p_count, uint8_t *r_inside) {
+
+	int inside_count = 0;
+	int i = 0;
+
+#ifdef SIMD_ENABLED
+	const simd_float4 half = simd_splat(0.5);
+	const simd_float4 zero = simd_splat(0);
+
+	for (; i + 4 <= p_count; i += 4) {
+
+		const AABB *a = &p_aabbs[i];
+		simd_float4 hx = simd_mul(simd_set(a[0].size.x, a[1].size.x, a[2].size.x, a[3].size.x), half);
+		simd_float4 hy = simd_mul(simd_set(a[0].size.y, a[1].size.y, a[2].size.y, a[3].size.y), half);
+		simd_float4 hz = simd_mul(simd_set(a[0].size.z, a[1].size.z, a[2].size.z, a[3].size.z), half);
+		simd_float4 cx = simd_add(simd_set(a[0].position.x, a[1].position.x, a[2].position.x, a[3].position.x), hx);
+		simd_float4 cy = simd_add(simd_set(a[0].position.y, a[1].position.y, a[2].position.y, a[3].position.y), hy);
+		simd_float4 cz = simd_add(simd_set(a[0].position.z, a[1].position.z, a[2].position.z, a[3].position.z), hz);
+
+		int outside = 0;
+		for (int j = 0; j < p_plane_count && outside != 0xF; j++) {
+
+			const Plane &p = p_planes[j];
+			simd_float4 nx = simd_splat(p.normal.x), ny = simd_splat(p.normal.y), nz = simd_splat(p.normal.z);
+
+			// distance from the plane to the box corner furthest behind it
+			simd_float4 dist = simd_madd(nx, cx, simd_madd(ny, cy, simd_mul(nz, cz)));
+			dist = simd_sub(dist, simd_madd(simd_abs(nx), hx, simd_madd(simd_abs(ny), hy, simd_mul(simd_abs(nz), hz))));
+			dist = simd_sub(dist, simd_splat(p.d));
+
+			outside |= simd_greater_mask(dist, zero);
+		}
+
+		for (int j = 0; j < 4; j++) {
+			uint8_t in = (outside & (1 << j)) ? 0 : 1;
+			r_inside[i + j] = in;
+			inside_count += in;
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		uint8_t in = p_aabbs[i].intersects_convex_shape(p_planes, p_plane_count) ? 1 : 0;
+		r_inside[i] = in;
+		inside_count += in;
+	}
+
+	return inside_count;
+}
@@ -0,0 +1,76 @@
+/*************************************************************************/
+/*  batch_math.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include "core/math/aabb.h"
+#include "core/math/plane.h"
+#include "core/math/transform.h"
+
+/**
+ * Kernels processing whole arrays of vectors, transforms and boxes at once.
+ * They use SSE or NEON when available (see simd.h) and give the same results
+ * as looping over the regular math classes.
+ */
+
+class BatchMath {
+	BatchMath();
+
+public:
+	// p_src and p_dst may be the same array
+	static void xform_points(const Transform &p_xform, const Vector3 *p_src, Vector3 *p_dst, int p_count);
+	// for normals, pass the inverse transpose of the basis and normalize afterwards
+	static void xform_vectors(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, int p_count);
+
+	/**
+	 * r_dst[i] = p_a[i] * p_b[i], with the three arrays walked with the same stride
+	 * in bytes, so they can be members of an array of structs.
+	 */
+	static void mul_transforms(const Transform *p_a, const Transform *p_b, Transform *r_dst, int p_count, int p_stride = sizeof(Transform));
+
+	/**
+	 * Writes p_xform * p_src[i] as 3 rows of 4 floats (the MultiMesh and particle buffer layout),
+	 * advancing p_dst by p_dst_stride floats. p_src is walked with a stride in bytes, or through
+	 * p_order (element indices) if not NULL.
+	 */
+	static void xform_to_rows(const Transform &p_xform, const Transform *p_src, int p_src_stride, const int *p_order, float *p_dst, int p_dst_stride, int p_count);
+
+	static AABB merge_aabbs(const AABB *p_aabbs, int p_count);
+	static AABB compute_aabb(const Vector3 *p_points, int p_count);
+
+	/**
+	 * Same test as AABB::intersects_convex_shape() for each box, r_inside gets 1 for the
+	 * boxes intersecting the convex shape and 0 for the others. Returns how many intersect.
+	 */
+	static int cull_aabbs(const Plane *p_planes, int p_plane_count, const AABB *p_aabbs, int p_count, uint8_t *r_inside);
+};
+
+#endif // BATCH_MATH_H
@@ -0,0 +1,146 @@
+/*************************************************************************/
+/*  simd.h                                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "core/math/math_defs.h"
+#include "core/typedefs.h"
+
+/**
+ * Thin wrapper over 4 wide float vectors, so batch kernels can be written once
+ * for SSE and NEON. SIMD_ENABLED is left undefined when real_t is double or
+ * neither instruction set is available, and callers must provide a scalar path.
+ */
+
+#if !defined(REAL_T_IS_DOUBLE) && !defined(NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE
+#define SIMD_ENABLED
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_NEON
+#define SIMD_ENABLED
+#endif
+#endif
+
+#if defined(SIMD_SSE)
+
+#include <emmintrin.h>
+
+typedef __m128 simd_float4;
+
+static _FORCE_INLINE_ simd_float4 simd_load(const float *p_ptr) { return _mm_loadu_ps(p_ptr); }
+static _FORCE_INLINE_ void simd_store(float *p_ptr, simd_float4 p_v) { _mm_storeu_ps(p_ptr, p_v); }
+static _FORCE_INLINE_ simd_float4 simd_splat(float p_v) { return _mm_set1_ps(p_v); }
+static _FORCE_INLINE_ simd_float4 simd_set(float p_x, float p_y, float p_z, float p_w) { return _mm_setr_ps(p_x, p_y, p_z, p_w); }
+
+static _FORCE_INLINE_ simd_float4 simd_add(simd_float4 p_a, simd_float4 p_b) { return _mm_add_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_sub(simd_float4 p_a, simd_float4 p_b) { return _mm_sub_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_mul(simd_float4 p_a, simd_float4 p_b) { return _mm_mul_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_madd(simd_float4 p_a, simd_float4 p_b, simd_float4 p_c) { return _mm_add_ps(_mm_mul_ps(p_a, p_b), p_c); }
+static _FORCE_INLINE_ simd_float4 simd_min(simd_float4 p_a, simd_float4 p_b) { return _mm_min_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_max(simd_float4 p_a, simd_float4 p_b) { return _mm_max_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_abs(simd_float4 p_a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), p_a); }
+
+// one bit per lane, set where p_a > p_b
+static _FORCE_INLINE_ int simd_greater_mask(simd_float4 p_a, simd_float4 p_b) { return _mm_movemask_ps(_mm_cmpgt_ps(p_a, p_b)); }
+
+// loads 4 packed Vector3 (12 floats) as one vector per axis
+static _FORCE_INLINE_ void simd_load3x4(const float *p_ptr, simd_float4 &r_x, simd_float4 &r_y, simd_float4 &r_z) {
+
+	simd_float4 a = _mm_loadu_ps(p_ptr); // x0 y0 z0 x1
+	simd_float4 b = _mm_loadu_ps(p_ptr + 4); // y1 z1 x2 y2
+	simd_float4 c = _mm_loadu_ps(p_ptr + 8); // z2 x3 y3 z3
+
+	r_x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	r_y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	r_z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// inverse of simd_load3x4
+static _FORCE_INLINE_ void simd_store3x4(float *p_ptr, simd_float4 p_x, simd_float4 p_y, simd_float4 p_z) {
+
+	simd_float4 a = _mm_shuffle_ps(_mm_shuffle_ps(p_x, p_y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(p_z, p_x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	simd_float4 b = _mm_shuffle_ps(_mm_shuffle_ps(p_y, p_z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(p_x, p_y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+	simd_float4 c = _mm_shuffle_ps(_mm_shuffle_ps(p_z, p_x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(p_y, p_z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+	_mm_storeu_ps(p_ptr, a);
+	_mm_storeu_ps(p_ptr + 4, b);
+	_mm_storeu_ps(p_ptr + 8, c);
+}
+
+#elif defined(SIMD_NEON)
+
+#include <arm_neon.h>
+
+typedef float32x4_t simd_float4;
+
+static _FORCE_INLINE_ simd_float4 simd_load(const float *p_ptr) { return vld1q_f32(p_ptr); }
+static _FORCE_INLINE_ void simd_store(float *p_ptr, simd_float4 p_v) { vst1q_f32(p_ptr, p_v); }
+static _FORCE_INLINE_ simd_float4 simd_splat(float p_v) { return vdupq_n_f32(p_v); }
+static _FORCE_INLINE_ simd_float4 simd_set(float p_x, float p_y, float p_z, float p_w) {
+	const float v[4] = { p_x, p_y, p_z, p_w };
+	return vld1q_f32(v);
+}
+
+static _FORCE_INLINE_ simd_float4 simd_add(simd_float4 p_a, simd_float4 p_b) { return vaddq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_sub(simd_float4 p_a, simd_float4 p_b) { return vsubq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_mul(simd_float4 p_a, simd_float4 p_b) { return vmulq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_madd(simd_float4 p_a, simd_float4 p_b, simd_float4 p_c) { return vmlaq_f32(p_c, p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_min(simd_float4 p_a, simd_float4 p_b) { return vminq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_max(simd_float4 p_a, simd_float4 p_b) { return vmaxq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_abs(simd_float4 p_a) { return vabsq_f32(p_a); }
+
+static _FORCE_INLINE_ int simd_greater_mask(simd_float4 p_a, simd_float4 p_b) {
+
+	uint32x4_t gt = vcgtq_f32(p_a, p_b);
+	return (vgetq_lane_u32(gt, 0) & 1) | (vgetq_lane_u32(gt, 1) & 2) | (vgetq_lane_u32(gt, 2) & 4) | (vgetq_lane_u32(gt, 3) & 8);
+}
+
+static _FORCE_INLINE_ void simd_load3x4(const float *p_ptr, simd_float4 &r_x, simd_float4 &r_y, simd_float4 &r_z) {
+
+	float32x4x3_t v = vld3q_f32(p_ptr);
+	r_x = v.val[0];
+	r_y = v.val[1];
+	r_z = v.val[2];
+}
+
+static _FORCE_INLINE_ void simd_store3x4(float *p_ptr, simd_float4 p_x, simd_float4 p_y, simd_float4 p_z) {
+
+	float32x4x3_t v;
+	v.val[0] = p_x;
+	v.val[1] = p_y;
+	v.val[2] = p_z;
+	vst3q_f32(p_ptr, v);
+}
+
+#endif
+
+#endif // SIMD_H
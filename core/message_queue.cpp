@@ -31,8 +31,11 @@
 #include "message_queue.h"
 
 #include "core/project_settings.h"
+#include "core/safe_refcount.h"
 #include "core/script_language.h"
 
+#define PAGE_HEADER_SIZE ((sizeof(Page) + 15) & ~15)
+
 MessageQueue *MessageQueue::singleton = NULL;
 
 MessageQueue *MessageQueue::get_singleton() {
@@ -40,13 +43,269 @@ MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+volatile uint32_t MessageQueue::last_generation = 0;
+
+MessageQueue::ThreadPageRef::~ThreadPageRef() {
+
+	//the queue is only destroyed once other threads are done with it
+	MessageQueue *queue = singleton;
+	if (!queue || queue->generation != generation || !thread_page)
+		return;
+
+	Page *page = thread_page->page;
+	if (page && atomic_compare_exchange_pointer(&thread_page->page, page, (Page *)NULL) == page) {
+		atomic_increment(&page->released); //the flushing thread frees it
+	}
+	atomic_increment(&thread_page->exited); //and this
+}
+
+MessageQueue::ThreadPage *MessageQueue::_get_thread_page() {
+
+	static thread_local ThreadPageRef ref;
+
+	if (unlikely(ref.generation != generation)) {
+
+		ThreadPage *tp = memnew(ThreadPage);
+		tp->page = NULL;
+		tp->writing = NULL;
+		tp->exited = 0;
+
+		while (true) {
+			ThreadPage *head = new_thread_pages;
+			tp->next = head;
+			if (atomic_compare_exchange_pointer(&new_thread_pages, head, tp) == head)
+				break;
+		}
+
+		ref.thread_page = tp;
+		ref.generation = generation;
+	}
+
+	return ref.thread_page;
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION)
+		size += sizeof(Variant) * p_message->args;
+	return size;
+}
+
+bool MessageQueue::_is_full(uint32_t p_size) {
+
+	if (!flushing || Thread::get_caller_id() != flush_thread)
+		return false;
+
+	if (flush_used + p_size >= buffer_size)
+		return true;
+
+	flush_used += p_size;
+	return false;
+}
+
+MessageQueue::Message *MessageQueue::_alloc_message(uint32_t p_size) {
+
+	ThreadPage *tp = _get_thread_page();
+
+	//take the page while writing, so the flushing thread can't reclaim it meanwhile
+	Page *page = tp->page;
+	if (page && atomic_compare_exchange_pointer(&tp->page, page, (Page *)NULL) != page)
+		page = NULL; //just reclaimed
+
+	if (!page || page->committed + p_size > page->size) {
+
+		if (page) {
+			atomic_increment(&page->released);
+		}
+
+		uint32_t size = MAX(uint32_t(PAGE_SIZE_KB * 1024), p_size);
+		page = (Page *)memalloc(PAGE_HEADER_SIZE + size);
+		page->size = size;
+		page->committed = 0;
+		page->read = 0;
+		page->released = 0;
+		page->flushed_committed = 0;
+
+		while (true) {
+			Page *head = new_pages;
+			page->next = head;
+			if (atomic_compare_exchange_pointer(&new_pages, head, page) == head)
+				break;
+		}
+	}
+
+	tp->writing = page;
+
+	Message *msg = memnew_placement((uint8_t *)page + PAGE_HEADER_SIZE + page->committed, Message);
+	msg->sequence = atomic_increment(&sequence);
+	return msg;
+}
+
+void MessageQueue::_commit_message(uint32_t p_size) {
+
+	ThreadPage *tp = _get_thread_page();
+	Page *page = tp->writing;
+	tp->writing = NULL;
+
+	//makes the message visible to the flushing thread, then lets it reclaim the page again
+	atomic_add(&page->committed, p_size);
+	atomic_compare_exchange_pointer(&tp->page, (Page *)NULL, page);
+}
+
+void MessageQueue::_take_new_pages() {
+
+	if (new_thread_pages) {
+		ThreadPage *list = new_thread_pages;
+		while (true) {
+			ThreadPage *prev = atomic_compare_exchange_pointer(&new_thread_pages, list, (ThreadPage *)NULL);
+			if (prev == list)
+				break;
+			list = prev;
+		}
+		while (list) {
+			ThreadPage *next = list->next;
+			list->next = thread_pages;
+			thread_pages = list;
+			list = next;
+		}
+	}
+
+	if (!new_pages)
+		return;
+
+	Page *list = new_pages;
+	while (true) {
+		Page *prev = atomic_compare_exchange_pointer(&new_pages, list, (Page *)NULL);
+		if (prev == list)
+			break;
+		list = prev;
+	}
+
+	//order doesn't matter, messages are flushed by sequence
+	Page *last = list;
+	while (last->next) {
+		last = last->next;
+	}
+
+	if (pages_last)
+		pages_last->next = list;
+	else
+		pages = list;
+	pages_last = last;
+}
+
+// wraps around, compare the distance
+static _FORCE_INLINE_ bool _sequence_before(uint32_t p_a, uint32_t p_b) {
+
+	return int32_t(p_a - p_b) < 0;
+}
+
+MessageQueue::Page *MessageQueue::_find_oldest_page(uint32_t &r_next_sequence, bool &r_has_next) {
+
+	Page *oldest = NULL;
+	uint32_t oldest_sequence = 0;
+	r_has_next = false;
+
+	for (Page *page = pages; page; page = page->next) {
+
+		if (page->read >= atomic_add(&page->committed, 0))
+			continue;
+
+		uint32_t seq = ((Message *)((uint8_t *)page + PAGE_HEADER_SIZE + page->read))->sequence;
+		if (!oldest || _sequence_before(seq, oldest_sequence)) {
+			if (oldest) {
+				r_next_sequence = oldest_sequence;
+				r_has_next = true;
+			}
+			oldest = page;
+			oldest_sequence = seq;
+		} else if (!r_has_next || _sequence_before(seq, r_next_sequence)) {
+			r_next_sequence = seq;
+			r_has_next = true;
+		}
+	}
 
-	_THREAD_SAFE_METHOD_
+	return oldest;
+}
+
+void MessageQueue::_free_message(Message *p_message) {
+
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
+void MessageQueue::_free_flushed_pages() {
+
+	//take back the pages of threads that pushed nothing since the last flush, so idle threads don't keep one
+	ThreadPage *prev_tp = NULL;
+	ThreadPage *tp = thread_pages;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	while (tp) {
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+		ThreadPage *next = tp->next;
+
+		Page *page = tp->page;
+		if (page) {
+			uint32_t committed = atomic_add(&page->committed, 0);
+			if (page->read == committed && page->flushed_committed == committed) {
+				if (atomic_compare_exchange_pointer(&tp->page, page, (Page *)NULL) == page)
+					atomic_increment(&page->released);
+			}
+			page->flushed_committed = committed;
+		}
+
+		//an exited thread gave its page back already
+		if (atomic_add(&tp->exited, 0)) {
+			if (prev_tp)
+				prev_tp->next = next;
+			else
+				thread_pages = next;
+			memdelete(tp);
+		} else {
+			prev_tp = tp;
+		}
+
+		tp = next;
+	}
+
+	Page *prev = NULL;
+	Page *page = pages;
+
+	while (page) {
+
+		Page *next = page->next;
+
+		//released is checked first, the owning thread doesn't commit after releasing
+		if (atomic_add(&page->released, 0) && page->read == atomic_add(&page->committed, 0)) {
+
+			if (prev)
+				prev->next = next;
+			else
+				pages = next;
+			if (pages_last == page)
+				pages_last = prev;
+
+			memfree(page);
+		} else {
+			prev = page;
+		}
+
+		page = next;
+	}
+}
+
+Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+
+	if (_is_full(room_needed)) {
 		String type;
 		if (ObjectDB::get_instance(p_id))
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -56,7 +315,7 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(room_needed);
 	msg->args = p_argcount;
 	msg->instance_id = p_id;
 	msg->target = p_method;
@@ -64,15 +323,14 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 	if (p_show_error)
 		msg->type |= FLAG_SHOW_ERROR;
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
 
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	_commit_message(room_needed);
+
 	return OK;
 }
 
@@ -93,11 +351,9 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
 
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (_is_full(room_needed)) {
 		String type;
 		if (ObjectDB::get_instance(p_id))
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -107,30 +363,26 @@ Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Vari
 		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(room_needed);
 	msg->args = 1;
 	msg->instance_id = p_id;
 	msg->target = p_prop;
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
+	memnew_placement((Variant *)(msg + 1), Variant(p_value));
 
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	_commit_message(room_needed);
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (_is_full(room_needed)) {
 		String type;
 		if (ObjectDB::get_instance(p_id))
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -140,14 +392,14 @@ Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(room_needed);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_id = p_id;
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit_message(room_needed);
 
 	return OK;
 }
@@ -168,60 +420,70 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 
 void MessageQueue::statistics() {
 
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return; //only the flushing thread can safely walk the pages
+	}
+
+	_take_new_pages();
+
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<StringName, int> call_count;
 	int null_count = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	for (Page *page = pages; page; page = page->next) {
 
-		Object *target = ObjectDB::get_instance(message->instance_id);
+		uint8_t *data = (uint8_t *)page + PAGE_HEADER_SIZE;
+		uint32_t committed = atomic_add(&page->committed, 0);
+		uint32_t read_pos = page->read;
 
-		if (target != NULL) {
+		while (read_pos < committed) {
+			Message *message = (Message *)&data[read_pos];
 
-			switch (message->type & FLAG_MASK) {
+			Object *target = ObjectDB::get_instance(message->instance_id);
 
-				case TYPE_CALL: {
+			if (target != NULL) {
 
-					if (!call_count.has(message->target))
-						call_count[message->target] = 0;
+				switch (message->type & FLAG_MASK) {
 
-					call_count[message->target]++;
+					case TYPE_CALL: {
 
-				} break;
-				case TYPE_NOTIFICATION: {
+						if (!call_count.has(message->target))
+							call_count[message->target] = 0;
 
-					if (!notify_count.has(message->notification))
-						notify_count[message->notification] = 0;
+						call_count[message->target]++;
 
-					notify_count[message->notification]++;
+					} break;
+					case TYPE_NOTIFICATION: {
 
-				} break;
-				case TYPE_SET: {
+						if (!notify_count.has(message->notification))
+							notify_count[message->notification] = 0;
 
-					if (!set_count.has(message->target))
-						set_count[message->target] = 0;
+						notify_count[message->notification]++;
 
-					set_count[message->target]++;
+					} break;
+					case TYPE_SET: {
 
-				} break;
-			}
+						if (!set_count.has(message->target))
+							set_count[message->target] = 0;
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+						set_count[message->target]++;
 
-			null_count++;
-		}
+					} break;
+				}
+
+			} else {
+				//object was deleted
+				print_line("Object was deleted while awaiting a callback");
+
+				null_count++;
+			}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+			read_pos += _get_message_size(message);
+		}
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(get_buffer_usage()));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -237,6 +499,22 @@ void MessageQueue::statistics() {
 	}
 }
 
+int MessageQueue::get_buffer_usage() const {
+
+	uint32_t used = 0;
+
+	for (Page *page = pages; page; page = page->next) {
+		used += atomic_add(&page->committed, 0) - page->read;
+	}
+
+	//not taken by the flushing thread yet, but never freed before that either
+	for (Page *page = new_pages; page; page = page->next) {
+		used += atomic_add(&page->committed, 0);
+	}
+
+	return used;
+}
+
 int MessageQueue::get_max_buffer_usage() const {
 
 	return buffer_max_used;
@@ -262,78 +540,75 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 
 void MessageQueue::flush() {
 
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+	uint32_t used = get_buffer_usage();
+	if (used > buffer_max_used) {
+		buffer_max_used = used;
 	}
 
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
 	ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	flush_used = 0;
+	flush_thread = Thread::get_caller_id();
 	flushing = true;
 
-	while (read_pos < buffer_end) {
+	//keep going until nothing new shows up, so a call can re-add itself to the message queue
+	while (true) {
 
-		//lock on each iteration, so a call can re-add itself to the message queue
+		_take_new_pages();
 
-		Message *message = (Message *)&buffer[read_pos];
+		uint32_t next_sequence = 0;
+		bool has_next = false;
+		Page *page = _find_oldest_page(next_sequence, has_next);
+		if (!page)
+			break;
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			advance += sizeof(Variant) * message->args;
+		uint8_t *data = (uint8_t *)page + PAGE_HEADER_SIZE;
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		//run the messages of this page until another page has an older one
+		do {
 
-		_THREAD_SAFE_UNLOCK_
+			Message *message = (Message *)&data[page->read];
 
-		Object *target = ObjectDB::get_instance(message->instance_id);
+			//pre-advance so this function is reentrant
+			page->read += _get_message_size(message);
 
-		if (target != NULL) {
+			Object *target = ObjectDB::get_instance(message->instance_id);
 
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
+			if (target != NULL) {
 
-					Variant *args = (Variant *)(message + 1);
+				switch (message->type & FLAG_MASK) {
+					case TYPE_CALL: {
 
-					// messages don't expect a return value
+						Variant *args = (Variant *)(message + 1);
 
-					_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
+						// messages don't expect a return value
 
-				} break;
-				case TYPE_NOTIFICATION: {
+						_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-					// messages don't expect a return value
-					target->notification(message->notification);
+					} break;
+					case TYPE_NOTIFICATION: {
 
-				} break;
-				case TYPE_SET: {
+						// messages don't expect a return value
+						target->notification(message->notification);
 
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->target, *arg);
+					} break;
+					case TYPE_SET: {
 
-				} break;
-			}
-		}
+						Variant *arg = (Variant *)(message + 1);
+						// messages don't expect a return value
+						target->set(message->target, *arg);
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+					} break;
+				}
 			}
-		}
 
-		message->~Message();
+			_free_message(message);
 
-		_THREAD_SAFE_LOCK_
+		} while (page->read < atomic_add(&page->committed, 0) && (!has_next || _sequence_before(((Message *)&data[page->read])->sequence, next_sequence)));
 	}
 
-	buffer_end = 0; // reset buffer
+	_free_flushed_pages();
+
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
 }
 
 bool MessageQueue::is_flushing() const {
@@ -347,34 +622,47 @@ MessageQueue::MessageQueue() {
 	singleton = this;
 	flushing = false;
 
-	buffer_end = 0;
+	new_pages = NULL;
+	pages = NULL;
+	pages_last = NULL;
+	new_thread_pages = NULL;
+	thread_pages = NULL;
+	sequence = 0;
+	generation = atomic_increment(&last_generation); //threads registered with an earlier queue register again
 	buffer_max_used = 0;
+	flush_used = 0;
+	flush_thread = 0;
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "0,2048,1,or_greater"));
 	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
 MessageQueue::~MessageQueue() {
 
-	uint32_t read_pos = 0;
+	_take_new_pages();
 
-	while (read_pos < buffer_end) {
+	while (pages) {
 
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++)
-				args[i].~Variant();
+		Page *page = pages;
+		uint8_t *data = (uint8_t *)page + PAGE_HEADER_SIZE;
+
+		while (page->read < page->committed) {
+
+			Message *message = (Message *)&data[page->read];
+			page->read += _get_message_size(message);
+			_free_message(message);
 		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+		pages = page->next;
+		memfree(page);
+	}
+
+	//pages are all freed above, and threads check the generation before using these again
+	while (thread_pages) {
+		ThreadPage *tp = thread_pages;
+		thread_pages = tp->next;
+		memdelete(tp);
 	}
 
 	singleton = NULL;
-	memdelete_arr(buffer);
 }
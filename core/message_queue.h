@@ -32,15 +32,29 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object.h"
-#include "core/os/thread_safe.h"
+#include "core/os/thread.h"
+
+/**
+ * Queue of deferred calls, notifications and property sets, flushed by the main thread.
+ *
+ * Each thread writes its messages to pages of its own, so pushing never waits on other
+ * threads. A page is linked to the queue once, with a lock free push, when it's started;
+ * each message is then published by advancing the page's committed size. Pages are
+ * allocated as needed and freed once flushed, so the queue only runs out of room when
+ * calls keep being deferred while it's flushed. Only the main thread may flush.
+ *
+ * Every message takes a number from one global sequence, and flushing always runs the
+ * oldest pending message of all pages, so calls keep the order they were pushed in
+ * across threads. The page a thread writes to is registered with the queue, which frees
+ * it once it stayed empty for a whole flush, and with the queue itself.
+ */
 
 class MessageQueue {
 
-	_THREAD_SAFE_CLASS_
-
 	enum {
 
-		DEFAULT_QUEUE_SIZE_KB = 1024
+		DEFAULT_QUEUE_SIZE_KB = 1024,
+		PAGE_SIZE_KB = 64
 	};
 
 	enum {
@@ -56,6 +70,7 @@ class MessageQueue {
 
 		ObjectID instance_id;
 		StringName target;
+		uint32_t sequence;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -63,11 +78,65 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end;
+	struct Page {
+
+		Page *next;
+		uint32_t size;
+		uint32_t committed; // size of the complete messages, only written by the thread owning the page
+		uint32_t read; // only used by the flushing thread
+		uint32_t released; // set once the owning thread moved on to another page
+		uint32_t flushed_committed; // committed size seen by the last flush, only used by the flushing thread
+	};
+
+	// owned by the queue, one per thread that pushed to it
+	struct ThreadPage {
+
+		ThreadPage *next;
+		Page *volatile page; // taken by the owning thread while it writes a message, or reclaimed by the flushing thread
+		Page *writing; // only used by the owning thread
+		uint32_t exited;
+	};
+
+	// per thread, the registration is only valid for the queue of the same generation
+	struct ThreadPageRef {
+
+		ThreadPage *thread_page;
+		uint32_t generation;
+
+		ThreadPageRef() {
+			thread_page = NULL;
+			generation = 0;
+		}
+		~ThreadPageRef();
+	};
+
+	Page *volatile new_pages; // pushed last first
+	Page *pages; // taken from new_pages by the flushing thread
+	Page *pages_last;
+
+	ThreadPage *volatile new_thread_pages; // registered last first
+	ThreadPage *thread_pages; // taken from new_thread_pages by the flushing thread
+
+	volatile uint32_t sequence;
+	uint32_t generation;
+	static volatile uint32_t last_generation;
+
 	uint32_t buffer_max_used;
+	uint32_t flush_used; // queued by the flushing thread since the flush started, limited to buffer_size to stop calls that keep deferring themselves
+	Thread::ID flush_thread;
 	uint32_t buffer_size;
 
+	ThreadPage *_get_thread_page();
+
+	_FORCE_INLINE_ static uint32_t _get_message_size(const Message *p_message);
+	_FORCE_INLINE_ bool _is_full(uint32_t p_size);
+	Message *_alloc_message(uint32_t p_size);
+	void _commit_message(uint32_t p_size);
+	void _take_new_pages();
+	Page *_find_oldest_page(uint32_t &r_next_sequence, bool &r_has_next);
+	void _free_message(Message *p_message);
+	void _free_flushed_pages();
+
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
@@ -91,6 +160,7 @@ public:
 
 	bool is_flushing() const;
 
+	int get_buffer_usage() const;
 	int get_max_buffer_usage() const;
 
 	MessageQueue();
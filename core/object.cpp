@@ -36,6 +36,7 @@
 #include "core/os/os.h"
 #include "core/print_string.h"
 #include "core/resource.h"
+#include "core/safe_refcount.h"
 #include "core/script_language.h"
 #include "core/translation.h"
 
@@ -376,6 +377,7 @@ Object::Connection::Connection(const Variant &p_variant) {
 		method = d["method"];
 	if (d.has("flags"))
 		flags = d["flags"];
+	serial = 0;
 	if (d.has("binds"))
 		binds = d["binds"];
 }
@@ -1191,21 +1193,21 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
 	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
+	//this only takes a reference, the slots are copied only if they are modified while emitting.
 	VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
 
 	int ssize = slot_map.size();
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
+	const Variant **bind_mem = NULL;
 
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
 
-		const Connection &c = slot_map.getv(i).conn;
+		const Signal::Slot &slot = slot_map.getv(i);
+		const Connection &c = slot.conn;
 
 		Object *target;
 #ifdef DEBUG_ENABLED
@@ -1220,24 +1222,39 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 		if (c.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
+			if (!bind_mem) {
+				// allocated once on the stack, big enough for the remaining slots
+				int max_binds = 0;
+				for (int j = i; j < ssize; j++) {
+					max_binds = MAX(max_binds, slot_map.getv(j).conn.binds.size());
+				}
+				bind_mem = (const Variant **)alloca(sizeof(Variant *) * (p_argcount + max_binds));
+			}
 
 			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
+				bind_mem[j] = p_args[j];
 			}
 			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+				bind_mem[p_argcount + j] = &c.binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_mem;
+			argc = p_argcount + c.binds.size();
 		}
 
 		if (c.flags & CONNECT_DEFERRED) {
 			MessageQueue::get_singleton()->push_call(target->get_instance_id(), c.method, args, argc, true);
 		} else {
 			Variant::CallError ce;
-			target->call(c.method, args, argc, ce);
+			if (slot.method && !target->script_instance) {
+				// same as Object::call() does for objects without script, minus the method lookup
+#ifdef DEBUG_ENABLED
+				_ObjectDebugLock target_lock(target);
+#endif
+				slot.method->call(target, args, argc, ce);
+			} else {
+				target->call(c.method, args, argc, ce);
+			}
 
 			if (ce.error != Variant::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
@@ -1270,6 +1287,9 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
+	// let go of the slots first, or disconnecting would copy them all
+	slot_map = VMap<Signal::Target, Signal::Slot>();
+
 	while (!disconnect_data.empty()) {
 
 		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
@@ -1497,9 +1517,11 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 	conn.method = p_to_method;
 	conn.signal = p_signal;
 	conn.flags = p_flags;
+	conn.serial = next_connection_serial();
 	conn.binds = p_binds;
 	slot.conn = conn;
 	slot.cE = p_to_object->connections.push_back(conn);
+	slot.method = ClassDB::get_method(p_to_object->get_class_name(), p_to_method);
 	if (p_flags & CONNECT_REFERENCE_COUNTED) {
 		slot.reference_count = 1;
 	}
@@ -1509,6 +1531,18 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 	return OK;
 }
 
+uint64_t Object::connection_serial = 0;
+
+uint64_t Object::get_connection_serial() {
+
+	return connection_serial;
+}
+
+uint64_t Object::next_connection_serial() {
+
+	return atomic_increment(&connection_serial);
+}
+
 bool Object::is_connected(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method) const {
 
 	ERR_FAIL_NULL_V(p_to_object, false);
@@ -2034,16 +2068,44 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
+ObjectDB::ObjectSlot *volatile ObjectDB::slot_chunks[ObjectDB::SLOT_CHUNK_MAX] = {};
+uint32_t ObjectDB::slot_count = 0;
+uint32_t ObjectDB::free_slot = 0;
+uint32_t ObjectDB::object_count = 0;
+uint64_t ObjectDB::validator_counter = 0;
 HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
 ObjectID ObjectDB::add_instance(Object *p_object) {
 
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
 	rw_lock->write_lock();
-	ObjectID instance_id = ++instance_counter;
-	instances[instance_id] = p_object;
+
+	uint32_t slot;
+	if (free_slot) {
+		// free slots are linked by index + 1, so zero ends the list
+		slot = free_slot - 1;
+		free_slot = slot_chunks[slot >> SLOT_CHUNK_BITS][slot & SLOT_CHUNK_MASK].next_free;
+	} else {
+		if (slot_count == (1 << SLOT_BITS)) {
+			rw_lock->write_unlock();
+			ERR_EXPLAIN("ObjectDB is full, too many objects exist at the same time.");
+			CRASH_NOW();
+		}
+		slot = slot_count++;
+		if (!slot_chunks[slot >> SLOT_CHUNK_BITS]) {
+			ObjectSlot *chunk = memnew_arr(ObjectSlot, SLOT_CHUNK_SIZE);
+			zeromem(chunk, sizeof(ObjectSlot) * SLOT_CHUNK_SIZE);
+			atomic_store_release(&slot_chunks[slot >> SLOT_CHUNK_BITS], chunk);
+		}
+	}
+
+	ObjectSlot &s = slot_chunks[slot >> SLOT_CHUNK_BITS][slot & SLOT_CHUNK_MASK];
+	ObjectID instance_id = (++validator_counter << SLOT_BITS) | slot;
+
+	// publish the object before the id that makes it visible to get_instance()
+	atomic_store_release(&s.object, p_object);
+	atomic_store_release(&s.id, instance_id);
+	object_count++;
 	instance_checks[p_object] = instance_id;
 
 	rw_lock->write_unlock();
@@ -2053,32 +2115,38 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 
 void ObjectDB::remove_instance(Object *p_object) {
 
+	ObjectID instance_id = p_object->get_instance_id();
+	uint32_t slot = instance_id & SLOT_MASK;
+
 	rw_lock->write_lock();
 
-	instances.erase(p_object->get_instance_id());
+	ObjectSlot *chunk = slot_chunks[slot >> SLOT_CHUNK_BITS];
+	if (!chunk || chunk[slot & SLOT_CHUNK_MASK].id != instance_id) {
+		rw_lock->write_unlock();
+		ERR_FAIL();
+	}
+
+	// hide the id before dropping the object, lookups check it on both sides
+	ObjectSlot &s = chunk[slot & SLOT_CHUNK_MASK];
+	atomic_store_release(&s.id, (ObjectID)0);
+	atomic_store_release(&s.object, (Object *)NULL);
+	s.next_free = free_slot;
+	free_slot = slot + 1;
+	object_count--;
 	instance_checks.erase(p_object);
 
 	rw_lock->write_unlock();
 }
-Object *ObjectDB::get_instance(ObjectID p_instance_id) {
-
-	rw_lock->read_lock();
-	Object **obj = instances.getptr(p_instance_id);
-	rw_lock->read_unlock();
-
-	if (!obj)
-		return NULL;
-	return *obj;
-}
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
 
 	rw_lock->read_lock();
 
-	const ObjectID *K = NULL;
-	while ((K = instances.next(K))) {
+	for (uint32_t i = 0; i < slot_count; i++) {
 
-		p_func(instances[*K]);
+		const ObjectSlot &s = slot_chunks[i >> SLOT_CHUNK_BITS][i & SLOT_CHUNK_MASK];
+		if (s.id)
+			p_func(s.object);
 	}
 
 	rw_lock->read_unlock();
@@ -2090,7 +2158,7 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 int ObjectDB::get_object_count() {
 
 	rw_lock->read_lock();
-	int count = instances.size();
+	int count = object_count;
 	rw_lock->read_unlock();
 
 	return count;
@@ -2106,23 +2174,34 @@ void ObjectDB::setup() {
 void ObjectDB::cleanup() {
 
 	rw_lock->write_lock();
-	if (instances.size()) {
+	if (object_count) {
 
 		WARN_PRINT("ObjectDB Instances still exist!");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			const ObjectID *K = NULL;
-			while ((K = instances.next(K))) {
+			for (uint32_t i = 0; i < slot_count; i++) {
+
+				const ObjectSlot &s = slot_chunks[i >> SLOT_CHUNK_BITS][i & SLOT_CHUNK_MASK];
+				if (!s.id)
+					continue;
 
 				String node_name;
-				if (instances[*K]->is_class("Node"))
-					node_name = " - Node name: " + String(instances[*K]->call("get_name"));
-				if (instances[*K]->is_class("Resource"))
-					node_name = " - Resource name: " + String(instances[*K]->call("get_name")) + " Path: " + String(instances[*K]->call("get_path"));
-				print_line("Leaked instance: " + String(instances[*K]->get_class()) + ":" + itos(*K) + node_name);
+				if (s.object->is_class("Node"))
+					node_name = " - Node name: " + String(s.object->call("get_name"));
+				if (s.object->is_class("Resource"))
+					node_name = " - Resource name: " + String(s.object->call("get_name")) + " Path: " + String(s.object->call("get_path"));
+				print_line("Leaked instance: " + String(s.object->get_class()) + ":" + itos(s.id) + node_name);
 			}
 		}
 	}
-	instances.clear();
+	for (int i = 0; i < SLOT_CHUNK_MAX; i++) {
+		if (slot_chunks[i]) {
+			memdelete_arr(slot_chunks[i]);
+			slot_chunks[i] = NULL;
+		}
+	}
+	slot_count = 0;
+	free_slot = 0;
+	object_count = 0;
 	instance_checks.clear();
 	rw_lock->write_unlock();
 	memdelete(rw_lock);
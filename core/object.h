@@ -35,6 +35,7 @@
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/rw_lock.h"
+#include "core/safe_refcount.h"
 #include "core/set.h"
 #include "core/variant.h"
 #include "core/vmap.h"
@@ -385,6 +386,7 @@ public:                                                        \
 private:
 
 class ScriptInstance;
+class MethodBind;
 typedef uint64_t ObjectID;
 
 class Object {
@@ -404,6 +406,7 @@ public:
 		Object *target;
 		StringName method;
 		uint32_t flags;
+		uint64_t serial; // order the connection was made in, see get_connection_serial()
 		Vector<Variant> binds;
 		bool operator<(const Connection &p_conn) const;
 
@@ -412,6 +415,7 @@ public:
 			source = NULL;
 			target = NULL;
 			flags = 0;
+			serial = 0;
 		}
 		Connection(const Variant &p_variant);
 	};
@@ -448,7 +452,11 @@ private:
 			int reference_count;
 			Connection conn;
 			List<Connection>::Element *cE;
-			Slot() { reference_count = 0; }
+			MethodBind *method; // native method of the target, if any, to skip the lookup by name
+			Slot() {
+				reference_count = 0;
+				method = NULL;
+			}
 		};
 
 		MethodInfo user;
@@ -466,6 +474,7 @@ private:
 	int _predelete_ok;
 	Set<Object *> change_receptors;
 	ObjectID _instance_id;
+	static uint64_t connection_serial;
 	bool _predelete();
 	void _postinitialize();
 	bool _can_translate;
@@ -702,6 +711,10 @@ public:
 	void disconnect(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method);
 	bool is_connected(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method) const;
 
+	// increases with every connection made, anything with a higher serial was made later. Node groups use it too
+	static uint64_t get_connection_serial();
+	static uint64_t next_connection_serial();
+
 	void call_deferred(const StringName &p_method, VARIANT_ARG_LIST);
 	void set_deferred(const StringName &p_property, const Variant &p_value);
 
@@ -760,10 +773,34 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<ObjectID, Object *> instances;
+	enum {
+		SLOT_BITS = 24,
+		SLOT_MASK = (1 << SLOT_BITS) - 1,
+		SLOT_CHUNK_BITS = 12,
+		SLOT_CHUNK_SIZE = 1 << SLOT_CHUNK_BITS,
+		SLOT_CHUNK_MASK = SLOT_CHUNK_SIZE - 1,
+		SLOT_CHUNK_MAX = 1 << (SLOT_BITS - SLOT_CHUNK_BITS),
+	};
+
+	// An ObjectID is a slot index in the low SLOT_BITS and a validator
+	// above it, so a stale ID never matches a slot that has been reused.
+	struct ObjectSlot {
+
+		volatile ObjectID id; // 0 while the slot is free
+		Object *volatile object;
+		uint32_t next_free;
+	};
+
+	// Chunks are allocated on demand and never moved or freed before
+	// cleanup(), so lookups can index them without taking the lock.
+	static ObjectSlot *volatile slot_chunks[SLOT_CHUNK_MAX];
+	static uint32_t slot_count;
+	static uint32_t free_slot;
+	static uint32_t object_count;
+	static uint64_t validator_counter;
+
 	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
 
-	static ObjectID instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
@@ -777,7 +814,22 @@ class ObjectDB {
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(ObjectID p_instance_id);
+	_FORCE_INLINE_ static Object *get_instance(ObjectID p_instance_id) {
+
+		uint32_t slot = p_instance_id & SLOT_MASK;
+		ObjectSlot *chunk = atomic_load_acquire(&slot_chunks[slot >> SLOT_CHUNK_BITS]);
+		if (unlikely(!chunk || p_instance_id == 0))
+			return NULL;
+
+		const ObjectSlot &s = chunk[slot & SLOT_CHUNK_MASK];
+		if (atomic_load_acquire(&s.id) != p_instance_id)
+			return NULL;
+		Object *object = atomic_load_acquire(&s.object);
+		// the slot may have been freed and reused while reading it
+		if (unlikely(atomic_load_acquire(&s.id) != p_instance_id))
+			return NULL;
+		return object;
+	}
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
 
@@ -113,6 +113,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_direct(int p_length) const { return NULL; } ///< pointer to the next p_length bytes if they are already in memory (advancing past them), NULL if get_buffer() must be used
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -149,6 +150,9 @@ public:
 
 	virtual bool file_exists(const String &p_name) = 0; ///< return true if a file exists
 
+	virtual const uint8_t *map_contents() { return NULL; } ///< map the whole file read only, valid until the file is closed, NULL if not supported
+	virtual void prefetch(uint64_t p_offset, uint64_t p_length) {} ///< hint that this range will be read soon
+
 	virtual Error reopen(const String &p_path, int p_mode_flags); ///< does not change the AccessType
 
 	static FileAccess *create(AccessType p_access); /// Create a file access (for the current platform) this is the only portable way of accessing files.
@@ -1204,6 +1204,9 @@ ProjectSettings::ProjectSettings() {
 	Compression::gzip_level = GLOBAL_DEF("compression/formats/gzip/compression_level", Z_DEFAULT_COMPRESSION);
 	custom_prop_info["compression/formats/gzip/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/gzip/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
 
+	GLOBAL_DEF("compression/pck/mode", 0);
+	custom_prop_info["compression/pck/mode"] = PropertyInfo(Variant::INT, "compression/pck/mode", PROPERTY_HINT_ENUM, "None,Zstd,Zstd with Dictionary");
+
 	// Would ideally be defined in an Android-specific file, but then it doesn't appear in the docs
 	GLOBAL_DEF("android/modules", "");
 
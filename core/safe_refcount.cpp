@@ -166,4 +166,24 @@ uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val) {
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val) {
 	return _atomic_exchange_if_greater_impl(pw, val);
 }
+
+void *atomic_compare_exchange_pointer(void *volatile *pw, void *p_expected, void *p_new) {
+	return InterlockedCompareExchangePointer(pw, p_new, p_expected);
+}
+
+uint64_t atomic_load_acquire(const volatile uint64_t *pw) {
+	return InterlockedCompareExchange64((LONGLONG volatile *)pw, 0, 0);
+}
+
+void atomic_store_release(volatile uint64_t *pw, uint64_t val) {
+	InterlockedExchange64((LONGLONG volatile *)pw, val);
+}
+
+void *atomic_load_acquire(void *const volatile *pw) {
+	return InterlockedCompareExchangePointer((void *volatile *)pw, NULL, NULL);
+}
+
+void atomic_store_release(void *volatile *pw, void *val) {
+	InterlockedExchangePointer(pw, val);
+}
 #endif
@@ -93,6 +93,28 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	return *pw;
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T *atomic_compare_exchange_pointer(T *volatile *pw, T *p_expected, T *p_new) {
+
+	T *tmp = *pw;
+	if (tmp == p_expected)
+		*pw = p_new;
+
+	return tmp;
+}
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(const volatile T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	*pw = val;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -148,6 +170,26 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	}
 }
 
+// Returns the previous value, the exchange happened if it equals p_expected.
+template <class T>
+static _ALWAYS_INLINE_ T *atomic_compare_exchange_pointer(T *volatile *pw, T *p_expected, T *p_new) {
+
+	return __sync_val_compare_and_swap(pw, p_expected, p_new);
+}
+
+// Ordered load and store, for values read by lock free readers.
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(const volatile T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	__atomic_store_n(pw, (T)val, __ATOMIC_RELEASE);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -165,6 +207,31 @@ uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
 
+void *atomic_compare_exchange_pointer(void *volatile *pw, void *p_expected, void *p_new);
+
+uint64_t atomic_load_acquire(const volatile uint64_t *pw);
+void atomic_store_release(volatile uint64_t *pw, uint64_t val);
+void *atomic_load_acquire(void *const volatile *pw);
+void atomic_store_release(void *volatile *pw, void *val);
+
+template <class T>
+static _ALWAYS_INLINE_ T *atomic_compare_exchange_pointer(T *volatile *pw, T *p_expected, T *p_new) {
+
+	return (T *)atomic_compare_exchange_pointer((void *volatile *)pw, (void *)p_expected, (void *)p_new);
+}
+
+template <class T>
+static _ALWAYS_INLINE_ T *atomic_load_acquire(T *const volatile *pw) {
+
+	return (T *)atomic_load_acquire((void *const volatile *)pw);
+}
+
+template <class T>
+static _ALWAYS_INLINE_ void atomic_store_release(T *volatile *pw, T *val) {
+
+	atomic_store_release((void *volatile *)pw, (void *)val);
+}
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
@@ -134,6 +134,42 @@ T *_nullptr() {
 #define CLAMP(m_a, m_min, m_max) (((m_a) < (m_min)) ? (m_min) : (((m_a) > (m_max)) ? m_max : m_a))
 #endif
 
+/** Generic move/forward templates (avoids depending on <utility>) */
+template <class T>
+struct __RemoveReference {
+	typedef T Type;
+};
+template <class T>
+struct __RemoveReference<T &> {
+	typedef T Type;
+};
+template <class T>
+struct __RemoveReference<T &&> {
+	typedef T Type;
+};
+
+#ifndef MOVE
+
+#define MOVE(m_x) __move_tmpl(m_x)
+template <class T>
+inline typename __RemoveReference<T>::Type &&__move_tmpl(T &&x) {
+
+	return static_cast<typename __RemoveReference<T>::Type &&>(x);
+}
+
+#endif //move
+
+#ifndef FORWARD
+
+#define FORWARD(m_type, m_x) __forward_tmpl<m_type>(m_x)
+template <class T>
+inline T &&__forward_tmpl(typename __RemoveReference<T>::Type &x) {
+
+	return static_cast<T &&>(x);
+}
+
+#endif //forward
+
 /** Generic swap template */
 #ifndef SWAP
 
@@ -141,9 +177,9 @@ T *_nullptr() {
 template <class T>
 inline void __swap_tmpl(T &x, T &y) {
 
-	T aux = x;
-	x = y;
-	y = aux;
+	T aux = MOVE(x);
+	x = MOVE(y);
+	y = MOVE(aux);
 }
 
 #endif //swap
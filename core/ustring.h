@@ -97,10 +97,16 @@ public:
 
 	_FORCE_INLINE_ CharString() {}
 	_FORCE_INLINE_ CharString(const CharString &p_str) { _cowdata._ref(p_str._cowdata); }
-	_FORCE_INLINE_ CharString operator=(const CharString &p_str) {
+	_FORCE_INLINE_ CharString &operator=(const CharString &p_str) {
 		_cowdata._ref(p_str._cowdata);
 		return *this;
 	}
+	_FORCE_INLINE_ CharString(CharString &&p_str) :
+			_cowdata(MOVE(p_str._cowdata)) {}
+	_FORCE_INLINE_ CharString &operator=(CharString &&p_str) {
+		_cowdata._steal(p_str._cowdata);
+		return *this;
+	}
 	_FORCE_INLINE_ CharString(const char *p_cstr) { copy_from(p_cstr); }
 
 	CharString &operator=(const char *p_cstr);
@@ -350,10 +356,16 @@ public:
 
 	_FORCE_INLINE_ String() {}
 	_FORCE_INLINE_ String(const String &p_str) { _cowdata._ref(p_str._cowdata); }
-	String operator=(const String &p_str) {
+	_FORCE_INLINE_ String &operator=(const String &p_str) {
 		_cowdata._ref(p_str._cowdata);
 		return *this;
 	}
+	_FORCE_INLINE_ String(String &&p_str) :
+			_cowdata(MOVE(p_str._cowdata)) {}
+	_FORCE_INLINE_ String &operator=(String &&p_str) {
+		_cowdata._steal(p_str._cowdata);
+		return *this;
+	}
 
 	String(const char *p_str);
 	String(const CharType *p_str, int p_clip_to_len = -1);
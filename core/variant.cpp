@@ -1583,7 +1583,7 @@ String Variant::stringify(List<const void *> &stack) const {
 				if (i)
 					str += ", ";
 
-				str += arr[i].stringify(stack);
+				str += arr.get_value(i).stringify(stack);
 			}
 
 			str += "]";
@@ -2006,7 +2006,7 @@ Variant::operator Vector<Variant>() const {
 	to.resize(len);
 	for (int i = 0; i < len; i++) {
 
-		to.write[i] = from[i];
+		to.write[i] = from.get_value(i);
 	}
 	return to;
 }
@@ -2221,6 +2221,12 @@ Variant::Variant(const String &p_string) {
 	memnew_placement(_data._mem, String(p_string));
 }
 
+Variant::Variant(String &&p_string) {
+
+	type = STRING;
+	memnew_placement(_data._mem, String(MOVE(p_string)));
+}
+
 Variant::Variant(const char *const p_cstring) {
 
 	type = STRING;
@@ -2322,12 +2328,24 @@ Variant::Variant(const Dictionary &p_dictionary) {
 	memnew_placement(_data._mem, (Dictionary)(p_dictionary));
 }
 
+Variant::Variant(Dictionary &&p_dictionary) {
+
+	type = DICTIONARY;
+	memnew_placement(_data._mem, Dictionary(MOVE(p_dictionary)));
+}
+
 Variant::Variant(const Array &p_array) {
 
 	type = ARRAY;
 	memnew_placement(_data._mem, Array(p_array));
 }
 
+Variant::Variant(Array &&p_array) {
+
+	type = ARRAY;
+	memnew_placement(_data._mem, Array(MOVE(p_array)));
+}
+
 Variant::Variant(const PoolVector<Plane> &p_array) {
 
 	type = ARRAY;
@@ -2682,6 +2700,21 @@ Variant::Variant(const IP_Address &p_address) {
 	memnew_placement(_data._mem, String(p_address));
 }
 
+void Variant::operator=(Variant &&p_variant) {
+
+	if (unlikely(this == &p_variant))
+		return;
+
+	// keep the old value alive until the new one is stolen, p_variant may live inside it
+	Variant old;
+	old.type = type;
+	old._data = _data;
+
+	type = p_variant.type;
+	_data = p_variant._data;
+	p_variant.type = NIL;
+}
+
 Variant::Variant(const Variant &p_variant) {
 
 	type = NIL;
@@ -3103,7 +3136,7 @@ bool Variant::hash_compare(const Variant &p_variant) const {
 				return false;
 
 			for (int i = 0; i < l.size(); ++i) {
-				if (!l[i].hash_compare(r[i]))
+				if (!l.get_value(i).hash_compare(r.get_value(i)))
 					return false;
 			}
 
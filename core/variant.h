@@ -253,6 +253,7 @@ public:
 	Variant(float p_float);
 	Variant(double p_double);
 	Variant(const String &p_string);
+	Variant(String &&p_string);
 	Variant(const StringName &p_string);
 	Variant(const char *const p_cstring);
 	Variant(const CharType *p_wstring);
@@ -271,8 +272,10 @@ public:
 	Variant(const RID &p_rid);
 	Variant(const Object *p_object);
 	Variant(const Dictionary &p_dictionary);
+	Variant(Dictionary &&p_dictionary);
 
 	Variant(const Array &p_array);
+	Variant(Array &&p_array);
 	Variant(const PoolVector<Plane> &p_array); // helper
 	Variant(const PoolVector<uint8_t> &p_raw_array);
 	Variant(const PoolVector<int> &p_int_array);
@@ -416,7 +419,14 @@ public:
 	static void construct_from_string(const String &p_string, Variant &r_value, ObjectConstruct p_obj_construct = NULL, void *p_construct_ud = NULL);
 
 	void operator=(const Variant &p_variant); // only this is enough for all the other types
+	void operator=(Variant &&p_variant);
 	Variant(const Variant &p_variant);
+	_FORCE_INLINE_ Variant(Variant &&p_variant) {
+		// all the types stored in _data can be relocated bitwise
+		type = p_variant.type;
+		_data = p_variant._data;
+		p_variant.type = NIL;
+	}
 	_FORCE_INLINE_ Variant() { type = NIL; }
 	_FORCE_INLINE_ ~Variant() {
 		if (type != Variant::NIL) clear();
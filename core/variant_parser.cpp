@@ -37,7 +37,27 @@
 
 CharType VariantParser::StreamFile::get_char() {
 
-	return f->get_8();
+	if (!readahead)
+		return f->get_8();
+
+	if (buffer_pos == buffer_size) {
+
+		// one call to the file for every block instead of one for every character
+		if (eof)
+			return 0;
+		if (buffer.empty())
+			buffer.resize(READAHEAD_SIZE);
+
+		buffer_pos = 0;
+		buffer_size = f->get_buffer(buffer.ptrw(), READAHEAD_SIZE);
+		if (buffer_size <= 0) {
+			buffer_size = 0;
+			eof = true;
+			return 0;
+		}
+	}
+
+	return buffer.ptr()[buffer_pos++];
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
@@ -46,7 +66,9 @@ bool VariantParser::StreamFile::is_utf8() const {
 }
 bool VariantParser::StreamFile::is_eof() const {
 
-	return f->eof_reached();
+	if (!readahead)
+		return f->eof_reached();
+	return eof;
 }
 
 CharType VariantParser::StreamString::get_char() {
@@ -440,6 +462,153 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	return OK;
 }
 
+// Constructors and packed arrays are lists of numbers, millions of them in
+// meshes and tile maps, so they are read straight from the stream here
+// rather than through get_token() and a Variant for each.
+
+static CharType _skip_blanks(VariantParser::Stream *p_stream, int &line) {
+
+	while (true) {
+
+		CharType c;
+		if (p_stream->saved) {
+			c = p_stream->saved;
+			p_stream->saved = 0;
+		} else {
+			c = p_stream->get_char();
+			if (p_stream->is_eof())
+				return 0;
+		}
+
+		if (c == '\n') {
+			line++;
+		} else if (c == ';') {
+			// comment until the end of the line, like get_token() skips them
+			while (true) {
+				c = p_stream->get_char();
+				if (p_stream->is_eof())
+					return 0;
+				if (c == '\n')
+					break;
+			}
+			line++;
+		} else if (c > 32 || c == 0) {
+			return c;
+		}
+	}
+}
+
+static bool _parse_number(VariantParser::Stream *p_stream, CharType c, double &r_real, int64_t &r_int, bool &r_is_float) {
+
+	// same syntax as numbers in get_token()
+	enum {
+		MAX_LENGTH = 64,
+		MAX_EXACT_DIGITS = 15, // as many as a double holds exactly
+	};
+
+	static const double powers_of_ten[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	CharType str[MAX_LENGTH + 1];
+	int len = 0;
+
+	bool negative = false;
+	if (c == '-') {
+		negative = true;
+		str[len++] = c;
+		c = p_stream->get_char();
+	}
+
+	if (c < '0' || c > '9')
+		return false;
+
+	uint64_t mantissa = 0;
+	int digits = 0; // significant digits in mantissa
+	int exponent = 0;
+	bool exact = true;
+	r_is_float = false;
+
+	for (; c >= '0' && c <= '9'; c = p_stream->get_char()) {
+		if (len < MAX_LENGTH)
+			str[len++] = c;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (c - '0');
+			if (mantissa)
+				digits++;
+		} else {
+			exponent++;
+			exact = false;
+		}
+	}
+
+	if (c == '.') {
+		r_is_float = true;
+		if (len < MAX_LENGTH)
+			str[len++] = c;
+		for (c = p_stream->get_char(); c >= '0' && c <= '9'; c = p_stream->get_char()) {
+			if (len < MAX_LENGTH)
+				str[len++] = c;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (c - '0');
+				if (mantissa)
+					digits++;
+				exponent--;
+			} else {
+				exact = false;
+			}
+		}
+	}
+
+	if (c == 'e') {
+		r_is_float = true;
+		if (len < MAX_LENGTH)
+			str[len++] = c;
+		c = p_stream->get_char();
+
+		bool exp_negative = false;
+		if (c == '-' || c == '+') {
+			exp_negative = c == '-';
+			if (len < MAX_LENGTH)
+				str[len++] = c;
+			c = p_stream->get_char();
+		}
+
+		int exp = 0;
+		for (; c >= '0' && c <= '9'; c = p_stream->get_char()) {
+			if (len < MAX_LENGTH)
+				str[len++] = c;
+			if (exp < 10000)
+				exp = exp * 10 + (c - '0');
+		}
+		exponent += exp_negative ? -exp : exp;
+	}
+
+	p_stream->saved = c;
+	str[len] = 0;
+
+	if (!r_is_float) {
+		if (digits <= 18) {
+			r_int = negative ? -int64_t(mantissa) : int64_t(mantissa);
+		} else {
+			r_int = String::to_int(str);
+		}
+		return true;
+	}
+
+	if (exact && len < MAX_LENGTH && digits <= MAX_EXACT_DIGITS && exponent >= -22 && exponent <= 22) {
+		// both the mantissa and the power of ten are exact, so is the result after rounding once
+		r_real = exponent < 0 ? double(mantissa) / powers_of_ten[-exponent] : double(mantissa) * powers_of_ten[exponent];
+		if (negative)
+			r_real = -r_real;
+	} else {
+		r_real = String::to_double(str);
+	}
+
+	return true;
+}
+
 template <class T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 
@@ -453,27 +622,33 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 	bool first = true;
 	while (true) {
 
+		CharType c = _skip_blanks(p_stream, line);
+
 		if (!first) {
-			get_token(p_stream, token, line, r_err_str);
-			if (token.type == TK_COMMA) {
-				//do none
-			} else if (token.type == TK_PARENTHESIS_CLOSE) {
+			if (c == ')') {
 				break;
-			} else {
+			} else if (c != ',') {
 				r_err_str = "Expected ',' or ')' in constructor";
 				return ERR_PARSE_ERROR;
 			}
+			c = _skip_blanks(p_stream, line);
+		} else if (c == ')') {
+			break;
 		}
-		get_token(p_stream, token, line, r_err_str);
 
-		if (first && token.type == TK_PARENTHESIS_CLOSE) {
-			break;
-		} else if (token.type != TK_NUMBER) {
+		double real = 0;
+		int64_t integer = 0;
+		bool is_float = false;
+		if (!_parse_number(p_stream, c, real, integer, is_float)) {
 			r_err_str = "Expected float in constructor";
 			return ERR_PARSE_ERROR;
 		}
 
-		r_construct.push_back(token.value);
+		if (is_float) {
+			r_construct.push_back(T(real));
+		} else {
+			r_construct.push_back(T(integer));
+		}
 		first = false;
 	}
 
@@ -53,12 +53,29 @@ public:
 	struct StreamFile : public Stream {
 
 		FileAccess *f;
+		bool readahead; // read f in large blocks, its position is then past what was parsed
 
 		virtual CharType get_char();
 		virtual bool is_utf8() const;
 		virtual bool is_eof() const;
 
-		StreamFile() { f = NULL; }
+		StreamFile() {
+			f = NULL;
+			readahead = true;
+			buffer_pos = 0;
+			buffer_size = 0;
+			eof = false;
+		}
+
+	private:
+		enum {
+			READAHEAD_SIZE = 64 * 1024
+		};
+
+		Vector<uint8_t> buffer;
+		int buffer_pos;
+		int buffer_size;
+		bool eof;
 	};
 
 	struct StreamString : public Stream {
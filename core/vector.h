@@ -64,6 +64,9 @@ private:
 
 public:
 	bool push_back(const T &p_elem);
+	bool push_back(T &&p_elem);
+	template <class... P>
+	bool emplace_back(P &&... p_args);
 
 	void remove(int p_index) { _cowdata.remove(p_index); }
 	void erase(const T &p_val) {
@@ -80,10 +83,14 @@ public:
 	_FORCE_INLINE_ T get(int p_index) { return _cowdata.get(p_index); }
 	_FORCE_INLINE_ const T get(int p_index) const { return _cowdata.get(p_index); }
 	_FORCE_INLINE_ void set(int p_index, const T &p_elem) { _cowdata.set(p_index, p_elem); }
+	_FORCE_INLINE_ void set(int p_index, T &&p_elem) { _cowdata.set(p_index, MOVE(p_elem)); }
 	_FORCE_INLINE_ int size() const { return _cowdata.size(); }
 	Error resize(int p_size) { return _cowdata.resize(p_size); }
 	_FORCE_INLINE_ const T &operator[](int p_index) const { return _cowdata.get(p_index); }
 	Error insert(int p_pos, const T &p_val) { return _cowdata.insert(p_pos, p_val); }
+	Error insert(int p_pos, T &&p_val) { return _cowdata.insert(p_pos, MOVE(p_val)); }
+	template <class... P>
+	Error emplace(int p_pos, P &&... p_args) { return _cowdata.emplace(p_pos, FORWARD(P, p_args)...); }
 	int find(const T &p_val, int p_from = 0) const { return _cowdata.find(p_val, p_from); }
 
 	void append_array(const Vector<T> &p_other);
@@ -122,6 +129,12 @@ public:
 		_cowdata._ref(p_from._cowdata);
 		return *this;
 	}
+	_FORCE_INLINE_ Vector(Vector &&p_from) :
+			_cowdata(MOVE(p_from._cowdata)) {}
+	inline Vector &operator=(Vector &&p_from) {
+		_cowdata._steal(p_from._cowdata);
+		return *this;
+	}
 
 	_FORCE_INLINE_ ~Vector() {}
 };
@@ -156,4 +169,24 @@ bool Vector<T>::push_back(const T &p_elem) {
 	return false;
 }
 
+template <class T>
+bool Vector<T>::push_back(T &&p_elem) {
+
+	Error err = resize(size() + 1);
+	ERR_FAIL_COND_V(err, true)
+	set(size() - 1, MOVE(p_elem));
+
+	return false;
+}
+
+template <class T>
+template <class... P>
+bool Vector<T>::emplace_back(P &&... p_args) {
+
+	Error err = _cowdata.emplace(size(), FORWARD(P, p_args)...);
+	ERR_FAIL_COND_V(err, true)
+
+	return false;
+}
+
 #endif
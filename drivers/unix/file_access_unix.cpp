@@ -39,6 +39,8 @@
 #include <sys/types.h>
 
 #if defined(UNIX_ENABLED)
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -66,6 +68,14 @@ void FileAccessUnix::check_errors() const {
 
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_len);
+		mapped = NULL;
+		mapped_len = 0;
+	}
+#endif
+
 	if (f)
 		fclose(f);
 	f = NULL;
@@ -126,6 +136,14 @@ void FileAccessUnix::close() {
 	if (!f)
 		return;
 
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_len);
+		mapped = NULL;
+		mapped_len = 0;
+	}
+#endif
+
 	fclose(f);
 	f = NULL;
 
@@ -326,9 +344,57 @@ FileAccess *FileAccessUnix::create_libc() {
 
 CloseNotificationFunc FileAccessUnix::close_notification_func = NULL;
 
+const uint8_t *FileAccessUnix::map_contents() {
+
+	ERR_FAIL_COND_V(!f, NULL);
+	ERR_FAIL_COND_V(flags != READ, NULL);
+
+#if defined(UNIX_ENABLED)
+	if (mapped)
+		return mapped;
+
+	size_t len = get_len();
+	if (len == 0)
+		return NULL;
+
+	void *data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED)
+		return NULL; // callers fall back to reading the file
+
+	mapped = (uint8_t *)data;
+	mapped_len = len;
+	return mapped;
+#else
+	return NULL;
+#endif
+}
+
+void FileAccessUnix::prefetch(uint64_t p_offset, uint64_t p_length) {
+
+	ERR_FAIL_COND(!f);
+
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		if (p_offset >= mapped_len)
+			return;
+		uint64_t page = sysconf(_SC_PAGESIZE);
+		uint64_t from = p_offset & ~(page - 1);
+		uint64_t to = MIN(p_offset + p_length, (uint64_t)mapped_len);
+		madvise(mapped + from, to - from, MADV_WILLNEED);
+	}
+#if defined(POSIX_FADV_WILLNEED)
+	else {
+		posix_fadvise(fileno(f), p_offset, p_length, POSIX_FADV_WILLNEED);
+	}
+#endif
+#endif
+}
+
 FileAccessUnix::FileAccessUnix() :
 		f(NULL),
 		flags(0),
+		mapped(NULL),
+		mapped_len(0),
 		last_error(OK) {
 }
 
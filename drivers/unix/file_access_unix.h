@@ -48,6 +48,8 @@ class FileAccessUnix : public FileAccess {
 
 	FILE *f;
 	int flags;
+	uint8_t *mapped;
+	size_t mapped_len;
 	void check_errors() const;
 	mutable Error last_error;
 	String save_path;
@@ -84,6 +86,9 @@ public:
 
 	virtual bool file_exists(const String &p_path); ///< return true if a file exists
 
+	virtual const uint8_t *map_contents();
+	virtual void prefetch(uint64_t p_offset, uint64_t p_length);
+
 	virtual uint64_t _get_modified_time(const String &p_file);
 	virtual uint32_t _get_unix_permissions(const String &p_file);
 	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
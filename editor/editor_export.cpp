@@ -31,6 +31,8 @@
 #include "editor_export.h"
 
 #include "core/io/config_file.h"
+#include "core/io/file_access_pack.h"
+#include "core/io/pck_packer.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/io/zip_io.h"
@@ -950,25 +952,32 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		header_size += 16; // md5
 	}
 
-	size_t header_padding = _get_pad(PCK_PADDING, header_size);
+	// flat index of the files, so mounting the pack doesn't need to go through the entries above
 
+	uint64_t strings_size = 0;
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
+		strings_size += pd.file_ofs[i].path_utf8.length();
+	}
 
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		uint32_t pad = _get_pad(4, string_len);
-		;
-		f->store_32(string_len + pad);
-		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (uint32_t j = 0; j < pad; j++) {
-			f->store_8(0);
-		}
+	size_t index_pos = header_size + _get_pad(PackedData::INDEX_ALIGNMENT, header_size);
+	header_size = index_pos + PackedData::get_index_size(pd.file_ofs.size(), strings_size);
 
-		f->store_64(pd.file_ofs[i].ofs + header_padding + header_size);
-		f->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
-		f->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
+	size_t header_padding = _get_pad(PCK_PADDING, header_size);
+
+	Vector<PackedData::IndexedFile> indexed_files;
+	indexed_files.resize(pd.file_ofs.size());
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+
+		PackedData::IndexedFile &indexed = indexed_files.write[i];
+		indexed.path = pd.file_ofs[i].path_utf8;
+		indexed.size = pd.file_ofs[i].size;
+		copymem(indexed.md5, pd.file_ofs[i].md5.ptr(), 16);
 	}
 
-	for (uint32_t j = 0; j < header_padding; j++) {
+	// the file entries and the index are written after the data, when the offsets of compressed files are known
+
+	size_t entries_pos = f->get_position();
+	for (size_t j = entries_pos; j < header_size + header_padding; j++) {
 		f->store_8(0);
 	}
 
@@ -980,19 +989,112 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		ERR_FAIL_COND_V(!ftmp, ERR_CANT_CREATE)
 	}
 
-	const int bufsize = 16384;
-	uint8_t buf[bufsize];
+	int compression = GLOBAL_GET("compression/pck/mode");
+	Vector<uint8_t> dictionary;
+	size_t dictionary_pos = 0;
 
-	while (true) {
+	if (compression == PCKPacker::COMPRESSION_NONE) {
 
-		int got = ftmp->get_buffer(buf, bufsize);
-		if (got <= 0)
-			break;
-		f->store_buffer(buf, got);
+		for (int i = 0; i < pd.file_ofs.size(); i++) {
+			indexed_files.write[i].offset = pd.file_ofs[i].ofs + header_padding + header_size;
+		}
+
+		const int bufsize = 16384;
+		uint8_t buf[bufsize];
+
+		while (true) {
+
+			int got = ftmp->get_buffer(buf, bufsize);
+			if (got <= 0)
+				break;
+			f->store_buffer(buf, got);
+		}
+
+	} else {
+
+		if (compression == PCKPacker::COMPRESSION_ZSTD_DICTIONARY) {
+
+			Vector<Vector<uint8_t> > samples;
+			int sampled = 0;
+			for (int i = 0; i < pd.file_ofs.size() && sampled < PackedData::DICTIONARY_MAX_SAMPLES; i++) {
+
+				Vector<uint8_t> sample;
+				sample.resize(MIN(pd.file_ofs[i].size, (uint64_t)PackedData::DICTIONARY_SAMPLE_SIZE));
+				ftmp->seek(pd.file_ofs[i].ofs);
+				ftmp->get_buffer(sample.ptrw(), sample.size());
+				sampled += sample.size();
+				samples.push_back(sample);
+			}
+
+			dictionary = PackedData::make_dictionary(samples);
+			if (dictionary.size()) {
+				dictionary_pos = f->get_position();
+				f->store_buffer(dictionary.ptr(), dictionary.size());
+				for (int j = _get_pad(PCK_PADDING, dictionary.size()); j > 0; j--) {
+					f->store_8(0);
+				}
+			}
+		}
+
+		// the dictionary is digested and the context set up once for all the files
+		Compression::ZstdContext *zstd_context = Compression::zstd_create_context();
+		Compression::ZstdDictionary *zstd_dictionary = dictionary.size() ? Compression::zstd_create_dictionary(dictionary.ptr(), dictionary.size(), true) : NULL;
+
+		for (int i = 0; i < pd.file_ofs.size(); i++) {
+
+			indexed_files.write[i].offset = f->get_position();
+			ftmp->seek(pd.file_ofs[i].ofs);
+			uint64_t stored = PackedData::store_chunked(f, ftmp, pd.file_ofs[i].size, zstd_context, zstd_dictionary);
+			for (int j = _get_pad(PCK_PADDING, stored); j > 0; j--) {
+				f->store_8(0);
+			}
+		}
+
+		Compression::zstd_free_dictionary(zstd_dictionary);
+		Compression::zstd_free_context(zstd_context);
 	}
 
 	memdelete(ftmp);
 
+	size_t end_pos = f->get_position();
+
+	if (compression != PCKPacker::COMPRESSION_NONE) {
+		f->seek(4);
+		f->store_32(PackedData::PACK_VERSION_CHUNKED);
+	}
+
+	f->seek(5 * 4); // first reserved words
+	f->store_64(index_pos);
+	f->store_32(compression != PCKPacker::COMPRESSION_NONE ? PackedData::PACK_FLAG_CHUNKED_ZSTD : 0);
+	f->store_64(dictionary_pos);
+	f->store_32(dictionary.size());
+	f->seek(entries_pos);
+
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+
+		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
+		uint32_t pad = _get_pad(4, string_len);
+		;
+		f->store_32(string_len + pad);
+		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
+		for (uint32_t j = 0; j < pad; j++) {
+			f->store_8(0);
+		}
+
+		f->store_64(indexed_files[i].offset);
+		f->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
+		f->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
+	}
+
+	for (uint64_t j = f->get_position(); j < index_pos; j++) {
+		f->store_8(0);
+	}
+
+	Vector<uint8_t> index = PackedData::make_index(indexed_files);
+	f->store_buffer(index.ptr(), index.size());
+
+	f->seek(end_pos);
+
 	f->store_32(0x43504447); //GDPK
 	memdelete(f);
 
@@ -36,6 +36,7 @@
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
+#include "core/safe_refcount.h"
 #include "core/variant_parser.h"
 #include "editor_node.h"
 #include "editor_resource_preview.h"
@@ -43,7 +44,7 @@
 
 EditorFileSystem *EditorFileSystem::singleton = NULL;
 //the name is the version, to keep compatibility with different versions of Godot
-#define CACHE_FILE_NAME "filesystem_cache6"
+#define CACHE_FILE_NAME "filesystem_cache7"
 
 void EditorFileSystemDirectory::sort_files() {
 
@@ -241,7 +242,7 @@ void EditorFileSystem::_scan_filesystem() {
 
 			} else {
 				Vector<String> split = l.split("::");
-				ERR_CONTINUE(split.size() != 8);
+				ERR_CONTINUE(split.size() != 9);
 				String name = split[0];
 				String file;
 
@@ -267,6 +268,11 @@ void EditorFileSystem::_scan_filesystem() {
 					}
 				}
 
+				String import_files = split[8].strip_edges();
+				if (import_files.length()) {
+					fc.import_files = import_files.split("<>");
+				}
+
 				file_cache[name] = fc;
 			}
 		}
@@ -294,21 +300,33 @@ void EditorFileSystem::_scan_filesystem() {
 
 	EditorProgressBG scan_progress("efs", "ScanFS", 1000);
 
+	//first half of the progress is listing the directories, second half is checking the files against the cache
+	ScanProgress list_progress;
+	list_progress.low = 0;
+	list_progress.hi = 0.5;
+	list_progress.progress = &scan_progress;
+
 	ScanProgress sp;
-	sp.low = 0;
+	sp.low = 0.5;
 	sp.hi = 1;
 	sp.progress = &scan_progress;
 
 	new_filesystem = memnew(EditorFileSystemDirectory);
 	new_filesystem->parent = NULL;
 
-	DirAccess *d = DirAccess::create(DirAccess::ACCESS_RESOURCES);
-	d->change_dir("res://");
-	_scan_new_dir(new_filesystem, d, sp);
+	uint64_t scan_begin = OS::get_singleton()->get_ticks_usec();
+
+	EditorFileSystemScanner::Dir *scan = scanner.scan("res://", _scan_progress, &list_progress);
+
+	uint64_t scan_listed = OS::get_singleton()->get_ticks_usec();
+
+	_scan_new_dir(new_filesystem, scan, sp);
+	memdelete(scan);
 
 	file_cache.clear(); //clear caches, no longer needed
 
-	memdelete(d);
+	uint64_t scan_end = OS::get_singleton()->get_ticks_usec();
+	print_verbose("EditorFileSystem: Scanned project in " + itos((scan_end - scan_begin) / 1000) + " msec (" + itos((scan_listed - scan_begin) / 1000) + " msec listing directories, " + itos((scan_end - scan_listed) / 1000) + " msec checking files).");
 
 	if (!first_scan) {
 		//on the first scan this is done from the main thread after re-importing
@@ -341,7 +359,40 @@ void EditorFileSystem::_thread_func(void *_userdata) {
 	sd->_scan_filesystem();
 }
 
-bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_imported_files) {
+void EditorFileSystem::_scan_progress(void *p_userdata, int p_current, int p_total) {
+
+	const ScanProgress *sp = (const ScanProgress *)p_userdata;
+	sp->update(p_current, p_total);
+}
+
+void EditorFileSystem::_watch_dirs(EditorFileSystemDirectory *p_dir) {
+
+	scanner.watch_dir(p_dir->get_path());
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+		_watch_dirs(p_dir->subdirs[i]);
+	}
+}
+
+void EditorFileSystem::_start_watching() {
+
+	//the whole tree was just scanned, anything changing in it from now on is reported to scan_changes()
+	scanner.stop_watching();
+	if (!scanner.start_watching())
+		return;
+
+	scanner.watch_removals("res://.import"); //imported files going missing must be noticed too
+	_watch_dirs(filesystem);
+}
+
+void EditorFileSystem::_update_import_settings_hash() {
+
+	String hash = ResourceFormatImporter::get_singleton()->get_import_settings_hash();
+	//on the first scan the hash stored with the filesystem cache is used instead, see revalidate_import_files
+	import_settings_changed = !first_scan && hash != import_settings_hash;
+	import_settings_hash = hash;
+}
+
+bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_imported_files, Vector<String> *r_import_files) {
 
 	if (!reimport_on_missing_imported_files && p_only_imported_files)
 		return false;
@@ -460,6 +511,13 @@ bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_impo
 		}
 	}
 
+	if (r_import_files) {
+		r_import_files->clear();
+		for (List<String>::Element *E = to_check.front(); E; E = E->next()) {
+			r_import_files->push_back(E->get());
+		}
+	}
+
 	//check source md5 matching
 	if (!p_only_imported_files) {
 
@@ -487,6 +545,32 @@ bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_impo
 	return false; //nothing changed
 }
 
+// Same as _test_for_reimport(p_path, true), for a file whose .import file has
+// not been modified since p_file->import_files was read from it. Only the
+// imported files need to exist then, unless the import settings changed.
+bool EditorFileSystem::_test_imported_files(const String &p_path, EditorFileSystemDirectory::FileInfo *p_file) {
+
+	if (!reimport_on_missing_imported_files)
+		return false;
+
+	if (p_file->import_files.empty() || import_settings_changed) {
+		return _test_for_reimport(p_path, true, &p_file->import_files);
+	}
+
+	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_path);
+	if (!FileAccess::exists(base_path + ".md5")) {
+		return true;
+	}
+
+	for (int i = 0; i < p_file->import_files.size(); i++) {
+		if (!FileAccess::exists(p_file->import_files[i])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool EditorFileSystem::_update_scan_actions() {
 
 	sources_changed.clear();
@@ -519,11 +603,14 @@ bool EditorFileSystem::_update_scan_actions() {
 					ia.dir->subdirs.insert(idx, ia.new_dir);
 				}
 
+				_watch_dirs(ia.new_dir);
+
 				fs_changed = true;
 			} break;
 			case ItemAction::ACTION_DIR_REMOVE: {
 
 				ERR_CONTINUE(!ia.dir->parent);
+				scanner.unwatch_dir(ia.dir->get_path());
 				ia.dir->parent->subdirs.erase(ia.dir);
 				memdelete(ia.dir);
 				fs_changed = true;
@@ -562,7 +649,7 @@ bool EditorFileSystem::_update_scan_actions() {
 				int idx = ia.dir->find_file_index(ia.file);
 				ERR_CONTINUE(idx == -1);
 				String full_path = ia.dir->get_file_path(idx);
-				if (_test_for_reimport(full_path, false)) {
+				if (_test_for_reimport(full_path, false, &ia.dir->files[idx]->import_files)) {
 					//must reimport
 					reimports.push_back(full_path);
 				} else {
@@ -614,6 +701,7 @@ void EditorFileSystem::scan() {
 		return;
 
 	_update_extensions();
+	_update_import_settings_hash();
 
 	abort_scan = false;
 	if (!use_threads) {
@@ -625,6 +713,7 @@ void EditorFileSystem::scan() {
 		//file_type_cache.clear();
 		filesystem = new_filesystem;
 		new_filesystem = NULL;
+		_start_watching();
 		_update_scan_actions();
 		scanning = false;
 		emit_signal("filesystem_changed");
@@ -661,112 +750,63 @@ EditorFileSystem::ScanProgress EditorFileSystem::ScanProgress::get_sub(int p_cur
 	return sp;
 }
 
-void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess *da, const ScanProgress &p_progress) {
-
-	List<String> dirs;
-	List<String> files;
-
-	String cd = da->get_current_dir();
-
-	p_dir->modified_time = FileAccess::get_modified_time(cd);
-
-	da->list_dir_begin();
-	while (true) {
+void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, const EditorFileSystemScanner::Dir *p_scan, const ScanProgress &p_progress) {
 
-		bool isdir;
-		String f = da->get_next(&isdir);
-		if (f == "")
-			break;
+	String cd = p_scan->path;
 
-		if (isdir) {
+	p_dir->modified_time = p_scan->modified_time;
 
-			if (f.begins_with(".")) //ignore hidden and . / ..
-				continue;
-
-			if (FileAccess::exists(cd.plus_file(f).plus_file("project.godot"))) // skip if another project inside this
-				continue;
-			if (FileAccess::exists(cd.plus_file(f).plus_file(".gdignore"))) // skip if another project inside this
-				continue;
-
-			dirs.push_back(f);
-
-		} else {
-
-			files.push_back(f);
-		}
-	}
-
-	da->list_dir_end();
-
-	dirs.sort_custom<NaturalNoCaseComparator>();
-	files.sort_custom<NaturalNoCaseComparator>();
-
-	int total = dirs.size() + files.size();
+	int total = p_scan->subdirs.size() + p_scan->files.size();
 	int idx = 0;
 
-	for (List<String>::Element *E = dirs.front(); E; E = E->next(), idx++) {
-
-		if (da->change_dir(E->get()) == OK) {
+	for (int i = 0; i < p_scan->subdirs.size(); i++, idx++) {
 
-			String d = da->get_current_dir();
-
-			if (d == cd || !d.begins_with(cd)) {
-				da->change_dir(cd); //avoid recursion
-			} else {
+		EditorFileSystemDirectory *efd = memnew(EditorFileSystemDirectory);
 
-				EditorFileSystemDirectory *efd = memnew(EditorFileSystemDirectory);
+		efd->parent = p_dir;
+		efd->name = p_scan->subdirs[i]->name;
 
-				efd->parent = p_dir;
-				efd->name = E->get();
+		_scan_new_dir(efd, p_scan->subdirs[i], p_progress.get_sub(idx, total));
 
-				_scan_new_dir(efd, da, p_progress.get_sub(idx, total));
+		int idx2 = 0;
+		for (int j = 0; j < p_dir->subdirs.size(); j++) {
 
-				int idx2 = 0;
-				for (int i = 0; i < p_dir->subdirs.size(); i++) {
-
-					if (efd->name < p_dir->subdirs[i]->name)
-						break;
-					idx2++;
-				}
-				if (idx2 == p_dir->subdirs.size()) {
-					p_dir->subdirs.push_back(efd);
-				} else {
-					p_dir->subdirs.insert(idx2, efd);
-				}
-
-				da->change_dir("..");
-			}
+			if (efd->name < p_dir->subdirs[j]->name)
+				break;
+			idx2++;
+		}
+		if (idx2 == p_dir->subdirs.size()) {
+			p_dir->subdirs.push_back(efd);
 		} else {
-			ERR_PRINTS("Cannot go into subdir: " + E->get());
+			p_dir->subdirs.insert(idx2, efd);
 		}
 
 		p_progress.update(idx, total);
 	}
 
-	for (List<String>::Element *E = files.front(); E; E = E->next(), idx++) {
+	for (int i = 0; i < p_scan->files.size(); i++, idx++) {
 
-		String ext = E->get().get_extension().to_lower();
-		if (!valid_extensions.has(ext)) {
-			continue; //invalid
-		}
+		const EditorFileSystemScanner::File &file = p_scan->files[i];
 
 		EditorFileSystemDirectory::FileInfo *fi = memnew(EditorFileSystemDirectory::FileInfo);
-		fi->file = E->get();
+		fi->file = file.name;
 
 		String path = cd.plus_file(fi->file);
 
 		FileCache *fc = file_cache.getptr(path);
-		uint64_t mt = FileAccess::get_modified_time(path);
+		uint64_t mt = file.modified_time;
 
-		if (import_extensions.has(ext)) {
+		if (file.imported) {
 
 			//is imported
-			uint64_t import_mt = 0;
-			if (FileAccess::exists(path + ".import")) {
-				import_mt = FileAccess::get_modified_time(path + ".import");
+			uint64_t import_mt = file.import_modified_time;
+
+			bool cached = fc && fc->modification_time == mt && fc->import_modification_time == import_mt;
+			if (cached) {
+				fi->import_files = fc->import_files;
 			}
 
-			if (fc && fc->modification_time == mt && fc->import_modification_time == import_mt && !_test_for_reimport(path, true)) {
+			if (cached && !_test_imported_files(path, fi)) {
 
 				fi->type = fc->type;
 				fi->deps = fc->deps;
@@ -783,7 +823,7 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 					ItemAction ia;
 					ia.action = ItemAction::ACTION_FILE_TEST_REIMPORT;
 					ia.dir = p_dir;
-					ia.file = E->get();
+					ia.file = file.name;
 					scan_actions.push_back(ia);
 				}
 
@@ -801,12 +841,13 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 				fi->script_class_name = _get_global_script_class(fi->type, path, &fi->script_class_extends, &fi->script_class_icon_path);
 				fi->modified_time = 0;
 				fi->import_modified_time = 0;
+				fi->import_files.clear();
 				fi->import_valid = ResourceLoader::is_import_valid(path);
 
 				ItemAction ia;
 				ia.action = ItemAction::ACTION_FILE_TEST_REIMPORT;
 				ia.dir = p_dir;
-				ia.file = E->get();
+				ia.file = file.name;
 				scan_actions.push_back(ia);
 			}
 		} else {
@@ -839,10 +880,19 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 
 void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress) {
 
-	uint64_t current_mtime = FileAccess::get_modified_time(p_dir->get_path());
+	String cd = p_dir->get_path();
+
+	if (scan_changed_dirs_only && !scan_changed_dirs.has(cd)) {
+		//nothing happened in here, only subdirectories can have changed
+		for (int i = 0; i < p_dir->subdirs.size(); i++) {
+			_scan_fs_changes(p_dir->get_subdir(i), p_progress);
+		}
+		return;
+	}
+
+	uint64_t current_mtime = FileAccess::get_modified_time(cd);
 
 	bool updated_dir = false;
-	String cd = p_dir->get_path();
 
 	if (current_mtime != p_dir->modified_time || using_fat32_or_exfat) {
 
@@ -892,10 +942,9 @@ void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const
 
 					efd->parent = p_dir;
 					efd->name = f;
-					DirAccess *d = DirAccess::create(DirAccess::ACCESS_RESOURCES);
-					d->change_dir(cd.plus_file(f));
-					_scan_new_dir(efd, d, p_progress.get_sub(1, 1));
-					memdelete(d);
+					EditorFileSystemScanner::Dir *scan = scanner.scan(cd.plus_file(f));
+					_scan_new_dir(efd, scan, p_progress.get_sub(1, 1));
+					memdelete(scan);
 
 					ItemAction ia;
 					ia.action = ItemAction::ACTION_DIR_ADD;
@@ -985,7 +1034,7 @@ void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const
 				uint64_t import_mt = FileAccess::get_modified_time(path + ".import");
 				if (import_mt != p_dir->files[i]->import_modified_time) {
 					reimport = true;
-				} else if (_test_for_reimport(path, true)) {
+				} else if (_test_imported_files(path, p_dir->files[i])) {
 					reimport = true;
 				}
 			}
@@ -1067,10 +1116,20 @@ void EditorFileSystem::scan_changes() {
 		return;
 
 	_update_extensions();
+	_update_import_settings_hash();
 	sources_changed.clear();
 	scanning_changes = true;
 	scanning_changes_done = false;
 
+	//with the directories watched only the ones that reported changes need to be checked,
+	//unless changed import settings can invalidate any imported file
+	scan_changed_dirs.clear();
+	scan_changed_dirs_only = scanner.get_changed_dirs(&scan_changed_dirs) && !import_settings_changed;
+	scanner.watch_removals("res://.import"); //in case it was lost, this scan checks everything then
+	if (scan_changed_dirs_only) {
+		print_verbose("EditorFileSystem: Checking " + itos(scan_changed_dirs.size()) + " changed directories.");
+	}
+
 	abort_scan = false;
 
 	if (!use_threads) {
@@ -1122,6 +1181,8 @@ void EditorFileSystem::_notification(int p_what) {
 				set_process(false);
 			}
 
+			scanner.stop_watching();
+
 			if (filesystem)
 				memdelete(filesystem);
 			if (new_filesystem)
@@ -1162,6 +1223,7 @@ void EditorFileSystem::_notification(int p_what) {
 					Thread::wait_to_finish(thread);
 					memdelete(thread);
 					thread = NULL;
+					_start_watching();
 					_update_scan_actions();
 					emit_signal("filesystem_changed");
 					emit_signal("sources_changed", sources_changed.size() > 0);
@@ -1207,6 +1269,14 @@ void EditorFileSystem::_save_filesystem_cache(EditorFileSystemDirectory *p_dir,
 			s += p_dir->files[i]->deps[j];
 		}
 
+		s += "::";
+		for (int j = 0; j < p_dir->files[i]->import_files.size(); j++) {
+
+			if (j > 0)
+				s += "<>";
+			s += p_dir->files[i]->import_files[j];
+		}
+
 		p_file->store_line(s);
 	}
 
@@ -1684,6 +1754,7 @@ Error EditorFileSystem::_reimport_group(const String &p_group_file, const Vector
 		//update modified times, to avoid reimport
 		fs->files[cpos]->modified_time = FileAccess::get_modified_time(file);
 		fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(file + ".import");
+		fs->files[cpos]->import_files = dest_paths;
 		fs->files[cpos]->deps = _get_dependencies(file);
 		fs->files[cpos]->type = importer->get_resource_type();
 		fs->files[cpos]->import_valid = err == OK;
@@ -1708,12 +1779,7 @@ Error EditorFileSystem::_reimport_group(const String &p_group_file, const Vector
 	return err;
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
-
-	EditorFileSystemDirectory *fs = NULL;
-	int cpos = -1;
-	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND(!found);
+void EditorFileSystem::_reimport_file(const String &p_file, ImportResult *r_result) {
 
 	//try to obtain existing params
 
@@ -1739,7 +1805,9 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 
 	} else {
+		import_mutex->lock();
 		late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
+		import_mutex->unlock();
 	}
 
 	Ref<ResourceImporter> importer;
@@ -1806,6 +1874,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	}
 
 	Vector<String> dest_paths;
+	Vector<String> import_files; //as read back by _test_for_reimport(), variant paths are escaped in the file
 
 	if (err == OK) {
 
@@ -1819,11 +1888,13 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 
 				f->store_line("path." + E->get() + "=\"" + path + "\"");
 				dest_paths.push_back(path);
+				import_files.push_back(base_path + "." + E->get() + "." + importer->get_save_extension());
 			}
 		} else {
 			String path = base_path + "." + importer->get_save_extension();
 			f->store_line("path=\"" + path + "\"");
 			dest_paths.push_back(path);
+			import_files.push_back(path);
 		}
 
 	} else {
@@ -1844,6 +1915,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		for (List<String>::Element *E = gen_files.front(); E; E = E->next()) {
 			genf.push_back(E->get());
 			dest_paths.push_back(E->get());
+			import_files.push_back(E->get());
 		}
 
 		String value;
@@ -1889,27 +1961,59 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	memdelete(md5s);
 
 	//update modified times, to avoid reimport
-	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
-	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
-	fs->files[cpos]->deps = _get_dependencies(p_file);
-	fs->files[cpos]->type = importer->get_resource_type();
-	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_file);
+	ImportResult result;
+	result.path = p_file;
+	result.valid = true;
+	result.modified_time = FileAccess::get_modified_time(p_file);
+	result.import_modified_time = FileAccess::get_modified_time(p_file + ".import");
+	result.import_files = import_files;
+	result.deps = _get_dependencies(p_file);
+	result.type = importer->get_resource_type();
+	result.import_valid = ResourceLoader::is_import_valid(p_file);
+
+	if (r_result) {
+		//importing in a thread, the main thread applies it later
+		*r_result = result;
+	} else {
+		_apply_import_result(result);
+	}
+}
+
+void EditorFileSystem::_apply_import_result(const ImportResult &p_result) {
+
+	if (!p_result.valid) {
+		return; //import failed before anything could be updated
+	}
+
+	const String &file = p_result.path;
+
+	EditorFileSystemDirectory *fs = NULL;
+	int cpos = -1;
+	bool found = _find_file(file, &fs, cpos);
+	ERR_FAIL_COND(!found);
+
+	fs->files[cpos]->modified_time = p_result.modified_time;
+	fs->files[cpos]->import_modified_time = p_result.import_modified_time;
+	fs->files[cpos]->import_files = p_result.import_files;
+	fs->files[cpos]->deps = p_result.deps;
+	fs->files[cpos]->type = p_result.type;
+	fs->files[cpos]->import_valid = p_result.import_valid;
 
 	//if file is currently up, maybe the source it was loaded from changed, so import math must be updated for it
 	//to reload properly
-	if (ResourceCache::has(p_file)) {
+	if (ResourceCache::has(file)) {
 
-		Resource *r = ResourceCache::get(p_file);
+		Resource *r = ResourceCache::get(file);
 
 		if (r->get_import_path() != String()) {
 
-			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(p_file);
+			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(file);
 			r->set_import_path(dst_path);
 			r->set_import_last_modified_time(0);
 		}
 	}
 
-	EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
+	EditorResourcePreview::get_singleton()->check_for_invalidation(file);
 }
 
 void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, Map<String, Vector<String> > &group_files, Set<String> &groups_to_reimport) {
@@ -1930,6 +2034,64 @@ void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, Map<Str
 	}
 }
 
+void EditorFileSystem::_reimport_thread(void *p_userdata) {
+
+	ImportThreadData *data = (ImportThreadData *)p_userdata;
+
+	while (true) {
+		uint32_t index = atomic_increment(&data->index) - 1;
+		if (index >= data->count)
+			break;
+		data->efs->_reimport_file(data->files[index].path, &data->results[index]);
+		atomic_increment(&data->done);
+	}
+}
+
+void EditorFileSystem::_reimport_threaded(const ImportFile *p_files, int p_count, int p_from, EditorProgress &p_progress) {
+
+	ImportThreadData data;
+	data.efs = this;
+	data.files = p_files;
+	data.count = p_count;
+	data.index = 0;
+	data.done = 0;
+
+	//workers only import, the filesystem and loaded resources are updated here, as the editor keeps running in
+	//progress steps meanwhile
+	Vector<ImportResult> results;
+	results.resize(p_count);
+	data.results = results.ptrw();
+
+	Vector<Thread *> threads;
+	threads.resize(MIN(OS::get_singleton()->get_processor_count(), p_count));
+
+	for (int i = 0; i < threads.size(); i++) {
+		threads.write[i] = Thread::create(_reimport_thread, &data);
+	}
+
+	//report progress from this thread while the workers import
+	int reported = -1;
+	while (true) {
+		int done = atomic_add(&data.done, 0);
+		if (done != reported) {
+			reported = done;
+			p_progress.step(p_files[MIN(done, p_count - 1)].path.get_file(), p_from + done);
+		}
+		if (done == p_count)
+			break;
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	for (int i = 0; i < p_count; i++) {
+		_apply_import_result(results[i]);
+	}
+}
+
 void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	{ //check that .import folder exists
@@ -1967,7 +2129,7 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 			//it's a regular file
 			ImportFile ifile;
 			ifile.path = p_files[i];
-			ifile.order = ResourceFormatImporter::get_singleton()->get_import_order(p_files[i]);
+			ResourceFormatImporter::get_singleton()->get_import_order_threads_and_importer(p_files[i], ifile.order, ifile.threaded, ifile.importer);
 			files.push_back(ifile);
 		}
 
@@ -1982,9 +2144,21 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	files.sort();
 
+	//files are sorted by importer within the same order, so runs of a thread safe importer can be imported in parallel
+	int from = 0;
 	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
-		_reimport_file(files[i].path);
+
+		if (i + 1 < files.size() && files[i].threaded && use_threads && files[i + 1].order == files[i].order && files[i + 1].importer == files[i].importer) {
+			continue; //keep extending the run
+		}
+
+		if (i > from) {
+			_reimport_threaded(files.ptr() + from, i - from + 1, from, pr);
+		} else {
+			pr.step(files[i].path.get_file(), i);
+			_reimport_file(files[i].path);
+		}
+		from = i + 1;
 	}
 
 	//reimport groups
@@ -2114,6 +2288,8 @@ void EditorFileSystem::_update_extensions() {
 
 		import_extensions.insert(E->get());
 	}
+
+	scanner.set_extensions(valid_extensions, import_extensions);
 }
 
 EditorFileSystem::EditorFileSystem() {
@@ -2129,6 +2305,7 @@ EditorFileSystem::EditorFileSystem() {
 	scanning = false;
 	importing = false;
 	use_threads = true;
+	import_mutex = Mutex::create();
 	thread_sources = NULL;
 	new_filesystem = NULL;
 
@@ -2148,7 +2325,11 @@ EditorFileSystem::EditorFileSystem() {
 	update_script_classes_queued = false;
 	first_scan = true;
 	revalidate_import_files = false;
+	scan_changed_dirs_only = false;
+	import_settings_changed = false;
 }
 
 EditorFileSystem::~EditorFileSystem() {
+
+	memdelete(import_mutex);
 }
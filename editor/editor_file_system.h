@@ -35,9 +35,11 @@
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/set.h"
+#include "editor_file_system_scanner.h"
 #include "scene/main/node.h"
 class FileAccess;
 
+struct EditorProgress;
 struct EditorProgressBG;
 class EditorFileSystemDirectory : public Object {
 
@@ -57,6 +59,7 @@ class EditorFileSystemDirectory : public Object {
 		uint64_t import_modified_time;
 		bool import_valid;
 		String import_group_file;
+		Vector<String> import_files; //files the .import file points to, checked instead of parsing it while unmodified
 		Vector<String> deps;
 		bool verified; //used for checking changes
 		String script_class_name;
@@ -169,6 +172,7 @@ class EditorFileSystem : public Node {
 		Vector<String> deps;
 		bool import_valid;
 		String import_group_file;
+		Vector<String> import_files;
 		String script_class_name;
 		String script_class_extends;
 		String script_class_icon_path;
@@ -192,12 +196,23 @@ class EditorFileSystem : public Node {
 
 	void _scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress);
 
+	EditorFileSystemScanner scanner;
+	Set<String> scan_changed_dirs;
+	bool scan_changed_dirs_only; //only directories reported by the scanner are checked for changes
+	String import_settings_hash;
+	bool import_settings_changed;
+
+	static void _scan_progress(void *p_userdata, int p_current, int p_total);
+	void _watch_dirs(EditorFileSystemDirectory *p_dir);
+	void _start_watching();
+	void _update_import_settings_hash();
+
 	void _delete_internal_files(String p_file);
 
 	Set<String> valid_extensions;
 	Set<String> import_extensions;
 
-	void _scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess *da, const ScanProgress &p_progress);
+	void _scan_new_dir(EditorFileSystemDirectory *p_dir, const EditorFileSystemScanner::Dir *p_scan, const ScanProgress &p_progress);
 
 	Thread *thread_sources;
 	bool scanning_changes;
@@ -212,10 +227,30 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
-	void _reimport_file(const String &p_file);
+	// what importing a file found out, applied to the filesystem and loaded resources by _apply_import_result()
+	struct ImportResult {
+		String path;
+		bool valid;
+		uint64_t modified_time;
+		uint64_t import_modified_time;
+		Vector<String> import_files;
+		Vector<String> deps;
+		String type;
+		bool import_valid;
+		ImportResult() {
+			valid = false;
+			modified_time = 0;
+			import_modified_time = 0;
+			import_valid = false;
+		}
+	};
+
+	void _reimport_file(const String &p_file, ImportResult *r_result = NULL);
+	void _apply_import_result(const ImportResult &p_result);
 	Error _reimport_group(const String &p_group_file, const Vector<String> &p_files);
 
-	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
+	bool _test_for_reimport(const String &p_path, bool p_only_imported_files, Vector<String> *r_import_files = NULL);
+	bool _test_imported_files(const String &p_path, EditorFileSystemDirectory::FileInfo *p_file);
 
 	bool reimport_on_missing_imported_files;
 
@@ -223,12 +258,27 @@ class EditorFileSystem : public Node {
 
 	struct ImportFile {
 		String path;
+		String importer;
+		bool threaded;
 		int order;
 		bool operator<(const ImportFile &p_if) const {
-			return order < p_if.order;
+			return order == p_if.order ? (importer < p_if.importer) : (order < p_if.order);
 		}
 	};
 
+	struct ImportThreadData {
+		EditorFileSystem *efs;
+		const ImportFile *files;
+		uint32_t count;
+		uint32_t index; //next file to be taken by a thread
+		uint32_t done;
+		ImportResult *results; //one per file, applied by the main thread once the workers are done
+	};
+
+	Mutex *import_mutex;
+	static void _reimport_thread(void *p_userdata);
+	void _reimport_threaded(const ImportFile *p_files, int p_count, int p_from, EditorProgress &p_progress);
+
 	void _scan_script_classes(EditorFileSystemDirectory *p_dir);
 	volatile bool update_script_classes_queued;
 	void _queue_update_script_classes();
@@ -0,0 +1,375 @@
+/*************************************************************************/
+/*  editor_file_system_scanner.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "editor_file_system_scanner.h"
+
+#include "core/os/file_access.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define WATCH_DIR_EVENTS (IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO)
+#define WATCH_REMOVAL_EVENTS (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+EditorFileSystemScanner::Dir::Dir() {
+
+	modified_time = 0;
+}
+
+EditorFileSystemScanner::Dir::~Dir() {
+
+	for (int i = 0; i < subdirs.size(); i++) {
+		memdelete(subdirs[i]);
+	}
+}
+
+void EditorFileSystemScanner::set_extensions(const Set<String> &p_extensions, const Set<String> &p_import_extensions) {
+
+	extensions = p_extensions;
+	import_extensions = p_import_extensions;
+}
+
+void EditorFileSystemScanner::_scan_dir(uint32_t p_index, Dir **p_dirs) {
+
+	Dir *dir = p_dirs[p_index];
+
+	DirAccess *da = DirAccess::create(access);
+	if (da->change_dir(dir->path) != OK) {
+		ERR_PRINTS("Cannot go into subdir: " + dir->path);
+		memdelete(da);
+		return;
+	}
+
+	List<String> dirs;
+	List<String> files;
+
+	String cd = da->get_current_dir();
+
+	dir->path = cd;
+	dir->modified_time = FileAccess::get_modified_time(cd);
+
+	da->list_dir_begin();
+	while (true) {
+
+		bool isdir;
+		String f = da->get_next(&isdir);
+		if (f == "")
+			break;
+
+		if (isdir) {
+
+			if (f.begins_with(".")) //ignore hidden and . / ..
+				continue;
+
+			if (FileAccess::exists(cd.plus_file(f).plus_file("project.godot"))) // skip if another project inside this
+				continue;
+			if (FileAccess::exists(cd.plus_file(f).plus_file(".gdignore"))) // skip if another project inside this
+				continue;
+
+			dirs.push_back(f);
+
+		} else if (extensions.has(f.get_extension().to_lower())) {
+
+			files.push_back(f);
+		}
+	}
+
+	da->list_dir_end();
+
+	dirs.sort_custom<NaturalNoCaseComparator>();
+	files.sort_custom<NaturalNoCaseComparator>();
+
+	for (List<String>::Element *E = dirs.front(); E; E = E->next()) {
+
+		if (da->change_dir(E->get()) == OK) {
+
+			String d = da->get_current_dir();
+
+			if (d != cd && d.begins_with(cd)) { //avoid recursion
+
+				Dir *subdir = memnew(Dir);
+				subdir->name = E->get();
+				subdir->path = d;
+				dir->subdirs.push_back(subdir);
+			}
+
+			da->change_dir(cd);
+		} else {
+			ERR_PRINTS("Cannot go into subdir: " + E->get());
+		}
+	}
+
+	memdelete(da);
+
+	dir->files.resize(files.size());
+	int idx = 0;
+	for (List<String>::Element *E = files.front(); E; E = E->next(), idx++) {
+
+		File &file = dir->files.write[idx];
+		file.name = E->get();
+
+		String path = cd.plus_file(file.name);
+
+		file.modified_time = FileAccess::get_modified_time(path);
+		file.import_modified_time = 0;
+		file.imported = import_extensions.has(file.name.get_extension().to_lower());
+
+		if (file.imported && FileAccess::exists(path + ".import")) {
+			file.import_modified_time = FileAccess::get_modified_time(path + ".import");
+		}
+	}
+}
+
+// Returns the tree under p_path, one level at a time. The progress callback is
+// called before each level with the directories listed so far and the ones
+// known to exist.
+EditorFileSystemScanner::Dir *EditorFileSystemScanner::scan(const String &p_path, ProgressFunc p_progress, void *p_userdata) {
+
+	Dir *root = memnew(Dir);
+	root->path = p_path;
+
+	Vector<Dir *> level;
+	level.push_back(root);
+	int listed = 0;
+
+	while (level.size()) {
+
+		if (p_progress) {
+			p_progress(p_userdata, listed, listed + level.size());
+		}
+
+		if (use_threads && level.size() > 1) {
+			thread_process_array(level.size(), this, &EditorFileSystemScanner::_scan_dir, level.ptrw());
+		} else {
+			for (int i = 0; i < level.size(); i++) {
+				_scan_dir(i, level.ptrw());
+			}
+		}
+
+		listed += level.size();
+
+		Vector<Dir *> next;
+		for (int i = 0; i < level.size(); i++) {
+			for (int j = 0; j < level[i]->subdirs.size(); j++) {
+				next.push_back(level[i]->subdirs[j]);
+			}
+		}
+		level = next;
+	}
+
+	return root;
+}
+
+String EditorFileSystemScanner::_get_os_path(const String &p_path) const {
+
+	if (access == DirAccess::ACCESS_RESOURCES) {
+		return ProjectSettings::get_singleton()->globalize_path(p_path);
+	}
+	return p_path;
+}
+
+bool EditorFileSystemScanner::start_watching() {
+
+#ifdef __linux__
+	if (watch_fd != -1)
+		return true;
+
+	watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	changes_lost = false;
+	removals_lost = false;
+	return watch_fd != -1;
+#else
+	return false;
+#endif
+}
+
+void EditorFileSystemScanner::stop_watching() {
+
+#ifdef __linux__
+	if (watch_fd != -1) {
+		close(watch_fd);
+	}
+#endif
+	watch_fd = -1;
+	removal_watch = -1;
+	removals_lost = false;
+	watched_dirs.clear();
+	changed_dirs.clear();
+}
+
+// Watches for files being added, removed or modified in p_path, which is
+// returned as is from get_changed_dirs(). Anything could have happened to a
+// directory before it was watched, so it is reported as changed once.
+void EditorFileSystemScanner::watch_dir(const String &p_path) {
+
+#ifdef __linux__
+	if (watch_fd == -1)
+		return;
+
+	int wd = inotify_add_watch(watch_fd, _get_os_path(p_path).utf8().get_data(), WATCH_DIR_EVENTS | IN_ONLYDIR);
+	if (wd == -1) {
+		if (errno == ENOENT) {
+			return; // already gone, the parent directory reports it
+		}
+		WARN_PRINTS("Cannot watch directory for changes, checking all files instead (raise fs.inotify.max_user_watches if the project is large): " + p_path);
+		stop_watching();
+		return;
+	}
+
+	// A moved directory keeps its watch descriptor, so the path can change.
+	const String *path = watched_dirs.getptr(wd);
+	if (!path || *path != p_path) {
+		watched_dirs[wd] = p_path;
+		changed_dirs.insert(p_path);
+	}
+#endif
+}
+
+// Stops watching p_path and the directories below it, once they are no
+// longer part of the scanned tree.
+void EditorFileSystemScanner::unwatch_dir(const String &p_path) {
+
+#ifdef __linux__
+	if (watch_fd == -1)
+		return;
+
+	String prefix = p_path.ends_with("/") ? p_path : p_path + "/";
+	List<int> unwatched;
+	const int *wd = NULL;
+	while ((wd = watched_dirs.next(wd))) {
+		const String &path = watched_dirs[*wd];
+		if (path == p_path || path.begins_with(prefix)) {
+			unwatched.push_back(*wd);
+		}
+	}
+
+	for (List<int>::Element *E = unwatched.front(); E; E = E->next()) {
+		inotify_rm_watch(watch_fd, E->get()); // fails if the directory is already gone, which removed the watch too
+		watched_dirs.erase(E->get());
+	}
+#endif
+}
+
+// Any file removed from p_path makes get_changed_dirs() report lost changes,
+// for directories whose contents the watched tree depends on. While this
+// watch is missing, get_changed_dirs() keeps reporting lost changes, call
+// this again to restore it.
+void EditorFileSystemScanner::watch_removals(const String &p_path) {
+
+#ifdef __linux__
+	if (watch_fd == -1 || removal_watch != -1)
+		return;
+
+	removal_watch = inotify_add_watch(watch_fd, _get_os_path(p_path).utf8().get_data(), WATCH_REMOVAL_EVENTS | IN_ONLYDIR);
+	removals_lost = removal_watch == -1;
+#endif
+}
+
+void EditorFileSystemScanner::_read_events() {
+
+#ifdef __linux__
+	char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	while (true) {
+
+		ssize_t len = read(watch_fd, buffer, sizeof(buffer));
+		if (len <= 0) {
+			break; // EAGAIN, nothing left to read
+		}
+
+		const char *ptr = buffer;
+		while (ptr < buffer + len) {
+
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				changes_lost = true;
+			} else if (event->wd == removal_watch) {
+				if (event->mask & IN_IGNORED) {
+					removal_watch = -1;
+					removals_lost = true;
+				}
+				// files are saved to a .tmp file first, which is then moved in place
+				if (!(event->mask & IN_MOVED_FROM) || !event->len || !String(event->name).ends_with(".tmp")) {
+					changes_lost = true;
+				}
+			} else if (event->mask & IN_IGNORED) {
+				watched_dirs.erase(event->wd); // directory deleted, its parent reports it
+			} else {
+				const String *path = watched_dirs.getptr(event->wd);
+				if (path) {
+					changed_dirs.insert(*path);
+				}
+			}
+		}
+	}
+#endif
+}
+
+// Adds the directories that changed since the last call to r_dirs. Returns
+// false if not watching or if events were lost, everything has to be checked
+// then.
+bool EditorFileSystemScanner::get_changed_dirs(Set<String> *r_dirs) {
+
+	if (watch_fd == -1)
+		return false;
+
+	_read_events();
+
+	for (Set<String>::Element *E = changed_dirs.front(); E; E = E->next()) {
+		r_dirs->insert(E->get());
+	}
+	changed_dirs.clear();
+
+	bool complete = !changes_lost && !removals_lost && watch_fd != -1;
+	changes_lost = false;
+	return complete;
+}
+
+EditorFileSystemScanner::EditorFileSystemScanner(DirAccess::AccessType p_access) {
+
+	access = p_access;
+	use_threads = true;
+	watch_fd = -1;
+	removal_watch = -1;
+	changes_lost = false;
+	removals_lost = false;
+}
+
+EditorFileSystemScanner::~EditorFileSystemScanner() {
+
+	stop_watching();
+}
@@ -0,0 +1,102 @@
+/*************************************************************************/
+/*  editor_file_system_scanner.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef EDITOR_FILE_SYSTEM_SCANNER_H
+#define EDITOR_FILE_SYSTEM_SCANNER_H
+
+#include "core/hash_map.h"
+#include "core/os/dir_access.h"
+#include "core/set.h"
+#include "core/vector.h"
+
+// Lists a directory tree with the modification times of the files the editor
+// knows about. All directories of a level are listed at once over several
+// threads, on large projects the time goes into waiting on the disk.
+// On Linux the listed directories can be watched with inotify afterwards, so
+// rescans only have to look at the directories that reported a change.
+class EditorFileSystemScanner {
+public:
+	struct File {
+		String name;
+		uint64_t modified_time;
+		uint64_t import_modified_time; // 0 if there is no .import file
+		bool imported;
+	};
+
+	struct Dir {
+		String name;
+		String path;
+		uint64_t modified_time;
+		Vector<Dir *> subdirs;
+		Vector<File> files;
+
+		Dir();
+		~Dir();
+	};
+
+	typedef void (*ProgressFunc)(void *p_userdata, int p_current, int p_total);
+
+private:
+	DirAccess::AccessType access;
+	bool use_threads;
+	Set<String> extensions;
+	Set<String> import_extensions;
+
+	void _scan_dir(uint32_t p_index, Dir **p_dirs);
+
+	int watch_fd;
+	int removal_watch;
+	HashMap<int, String> watched_dirs;
+	Set<String> changed_dirs;
+	bool changes_lost;
+	bool removals_lost; // the removal watch is missing, until watch_removals() succeeds again
+
+	String _get_os_path(const String &p_path) const;
+	void _read_events();
+
+public:
+	void set_extensions(const Set<String> &p_extensions, const Set<String> &p_import_extensions);
+	void set_use_threads(bool p_enable) { use_threads = p_enable; }
+
+	Dir *scan(const String &p_path, ProgressFunc p_progress = NULL, void *p_userdata = NULL);
+
+	bool start_watching();
+	void stop_watching();
+	bool is_watching() const { return watch_fd != -1; }
+	void watch_dir(const String &p_path);
+	void unwatch_dir(const String &p_path);
+	void watch_removals(const String &p_path);
+	bool get_changed_dirs(Set<String> *r_dirs);
+
+	EditorFileSystemScanner(DirAccess::AccessType p_access = DirAccess::ACCESS_RESOURCES);
+	~EditorFileSystemScanner();
+};
+
+#endif // EDITOR_FILE_SYSTEM_SCANNER_H
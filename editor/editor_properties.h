@@ -571,7 +571,7 @@ class EditorPropertyResource : public EditorProperty {
 
 	void _sub_inspector_property_keyed(const String &p_property, const Variant &p_value, bool);
 	void _sub_inspector_resource_selected(const RES &p_resource, const String &p_property);
-	void _sub_inspector_object_id_selected(int p_id);
+	void _sub_inspector_object_id_selected(ObjectID p_id);
 
 	void _button_draw();
 	Variant get_drag_data_fw(const Point2 &p_point, Control *p_from);
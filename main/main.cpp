@@ -30,6 +30,7 @@
 
 #include "main.h"
 
+#include "core/arena_allocator.h"
 #include "core/input_map.h"
 #include "core/io/file_access_network.h"
 #include "core/io/file_access_pack.h"
@@ -165,6 +166,12 @@ static String get_full_version_string() {
 	return String(VERSION_FULL_BUILD) + hash;
 }
 
+// Resources loaded in other threads push their visual server calls to the
+// main thread, keep processing them while it waits for those loads.
+static void _resource_loader_wait() {
+	VisualServer::get_singleton()->sync();
+}
+
 // FIXME: Could maybe be moved to PhysicsServerManager and Physics2DServerManager directly
 // to have less code in main.cpp.
 void initialize_physics() {
@@ -1151,6 +1158,8 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	Color clear = GLOBAL_DEF("rendering/environment/default_clear_color", Color(0.3, 0.3, 0.3));
 	VisualServer::get_singleton()->set_default_clear_color(clear);
 
+	ResourceLoader::set_wait_callback(_resource_loader_wait);
+
 	if (show_logo) { //boot logo!
 		String boot_logo_path = GLOBAL_DEF("application/boot_splash/image", String());
 		bool boot_logo_scale = GLOBAL_DEF("application/boot_splash/fullsize", true);
@@ -1848,6 +1857,9 @@ bool Main::iteration() {
 
 	iterating++;
 
+	// everything allocated from the frame arena during this iteration is released at the end
+	ArenaAllocator::Mark frame_mark = FrameAllocator::begin_frame();
+
 	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -1977,6 +1989,8 @@ bool Main::iteration() {
 		frames = 0;
 	}
 
+	FrameAllocator::end_frame(frame_mark);
+
 	iterating--;
 
 	if (fixed_fps != -1)
@@ -2026,6 +2040,8 @@ void Main::cleanup() {
 
 	ERR_FAIL_COND(!_start_success);
 
+	ResourceLoader::clear_thread_load_tasks();
+	ResourceLoader::set_wait_callback(NULL);
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
@@ -30,6 +30,7 @@
 
 #include "performance.h"
 
+#include "core/arena_allocator.h"
 #include "core/message_queue.h"
 #include "core/os/os.h"
 #include "scene/main/node.h"
@@ -74,6 +75,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ARENA_MAX);
+	BIND_ENUM_CONSTANT(MEMORY_MESSAGE_BUFFER_USAGE);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -120,6 +123,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"memory/frame_arena_max",
+		"memory/msg_buf_usage",
 
 	};
 
@@ -158,6 +163,8 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY: return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_FRAME_ARENA_MAX: return FrameAllocator::get_max_frame_usage();
+		case MEMORY_MESSAGE_BUFFER_USAGE: return MessageQueue::get_singleton()->get_buffer_usage();
 
 		default: {
 		}
@@ -200,6 +207,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
@@ -81,6 +81,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_FRAME_ARENA_MAX,
+		MEMORY_MESSAGE_BUFFER_USAGE,
 		MONITOR_MAX
 	};
 
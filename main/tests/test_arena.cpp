@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  test_arena.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_arena.h"
+
+#include "core/arena_allocator.h"
+#include "core/map.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "test_macros.h"
+
+namespace TestArena {
+
+bool test_alloc() {
+
+	OS::get_singleton()->print("\n\nTest 1: Alignment and rewinding\n");
+
+	ArenaAllocator arena(1024);
+
+	uint8_t *a = (uint8_t *)arena.alloc(3);
+	uint8_t *b = (uint8_t *)arena.alloc(8, 8);
+	CHECK(a && b);
+	CHECK(((uintptr_t)a & 15) == 0);
+	CHECK(((uintptr_t)b & 7) == 0);
+	CHECK(b >= a + 3);
+	CHECK(arena.get_used() >= 11);
+
+	ArenaAllocator::Mark mark = arena.get_mark();
+	size_t used = arena.get_used();
+	void *c = arena.alloc(100);
+	arena.rewind(mark);
+	CHECK(arena.get_used() == used);
+	CHECK(arena.alloc(100) == c); // the same memory is handed out again
+
+	arena.reset();
+	CHECK(arena.get_used() == 0);
+	CHECK(arena.alloc(3) == a);
+
+	return true;
+}
+
+bool test_chunks() {
+
+	OS::get_singleton()->print("\n\nTest 2: Growing past a chunk and merging on reset\n");
+
+	ArenaAllocator arena(1024);
+
+	ArenaAllocator::Mark mark = arena.get_mark();
+	for (int i = 0; i < 10; i++) {
+		uint8_t *p = (uint8_t *)arena.alloc(512);
+		CHECK(p);
+		p[0] = i;
+		p[511] = i; // the whole block is usable
+	}
+	void *big = arena.alloc(4096); // larger than a chunk
+	CHECK(big);
+	CHECK(arena.get_capacity() > 1024);
+	CHECK(arena.get_peak() >= 10 * 512 + 4096);
+
+	arena.rewind(mark);
+	CHECK(arena.get_used() == 0);
+
+	// rewinding to the start merged the chunks, so one chunk now fits everything
+	for (int i = 0; i < 10; i++) {
+		arena.alloc(512);
+	}
+	arena.alloc(4096);
+	size_t capacity = arena.get_capacity();
+	CHECK(capacity >= 10 * 512 + 4096);
+
+	arena.reset();
+	for (int i = 0; i < 10; i++) {
+		arena.alloc(512);
+	}
+	arena.alloc(4096);
+	CHECK(arena.get_capacity() == capacity);
+
+	return true;
+}
+
+bool test_frame_allocator() {
+
+	OS::get_singleton()->print("\n\nTest 3: Frame allocator in a Map\n");
+
+	ArenaAllocator::Mark frame = FrameAllocator::begin_frame();
+	size_t used = FrameAllocator::get_arena()->get_used();
+
+	{
+		Map<int, int, Comparator<int>, FrameAllocator> map;
+		for (int i = 0; i < 1000; i++) {
+			map[i] = i * 2;
+		}
+		CHECK(map.size() == 1000);
+		CHECK(map[500] == 1000);
+		CHECK(FrameAllocator::get_arena()->get_used() > used);
+	}
+
+	FrameAllocator::end_frame(frame);
+	CHECK(FrameAllocator::get_arena()->get_used() == used);
+	CHECK(FrameAllocator::get_last_frame_usage() > 1000 * sizeof(int) * 2);
+	CHECK(FrameAllocator::get_max_frame_usage() >= FrameAllocator::get_last_frame_usage());
+
+	return true;
+}
+
+static void _fill_frame_map(void *p_used) {
+
+	Map<int, int, Comparator<int>, FrameAllocator> map;
+	for (int i = 0; i < 1000; i++) {
+		map[i] = i;
+	}
+	*(size_t *)p_used = FrameAllocator::get_arena()->get_used();
+}
+
+bool test_frame_allocator_heap() {
+
+	OS::get_singleton()->print("\n\nTest 4: Frame allocator outside a frame or the main thread\n");
+
+	size_t used = FrameAllocator::get_arena()->get_used();
+	size_t used_after = 0;
+	_fill_frame_map(&used_after);
+	CHECK(used_after == used);
+
+	ArenaAllocator::Mark frame = FrameAllocator::begin_frame();
+	Thread *thread = Thread::create(_fill_frame_map, &used_after);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	CHECK(used_after == used);
+	FrameAllocator::end_frame(frame);
+
+	return true;
+}
+
+TestFunc test_funcs[] = {
+
+	test_alloc,
+	test_chunks,
+	test_frame_allocator,
+	test_frame_allocator_heap,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+} // namespace TestArena
@@ -0,0 +1,430 @@
+/*************************************************************************/
+/*  test_import.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_import.h"
+
+#ifdef TOOLS_ENABLED
+
+#include "core/io/resource_importer.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "editor/editor_file_system.h"
+#include "editor/editor_file_system_scanner.h"
+#include "scene/main/scene_tree.h"
+#include "test_macros.h"
+
+namespace TestImport {
+
+// Reimports a synthetic asset set through EditorFileSystem::reimport_files(),
+// which spreads importers that return true from can_import_threaded() over
+// all cores. This needs the editor, run it as "godot -e --path <project>
+// --test import", the assets are created in a folder of that project.
+
+static void _make_wav(const String &p_path, int p_samples, float p_freq) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	f->store_string("RIFF");
+	f->store_32(36 + p_samples * 2);
+	f->store_string("WAVE");
+	f->store_string("fmt ");
+	f->store_32(16);
+	f->store_16(1); // PCM
+	f->store_16(1); // mono
+	f->store_32(44100);
+	f->store_32(44100 * 2);
+	f->store_16(2);
+	f->store_16(16);
+	f->store_string("data");
+	f->store_32(p_samples * 2);
+	for (int i = 0; i < p_samples; i++) {
+		f->store_16(int16_t(Math::sin(i * p_freq * Math_PI * 2.0 / 44100.0) * 16000));
+	}
+
+	memdelete(f);
+}
+
+static void _make_csv(const String &p_path, int p_rows) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	f->store_line("keys,en,es,de");
+	for (int i = 0; i < p_rows; i++) {
+		f->store_line("KEY_" + itos(i) + ",text " + itos(i) + ",texto " + itos(i) + ",Text " + itos(i));
+	}
+
+	memdelete(f);
+}
+
+static void _make_png(const String &p_path, int p_size, int p_seed) {
+
+	Ref<Image> img;
+	img.instance();
+	img->create(p_size, p_size, false, Image::FORMAT_RGBA8);
+	img->lock();
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			img->set_pixel(x, y, Color(float((x + p_seed) % p_size) / p_size, float(y) / p_size, float((x ^ y) & 0xFF) / 255.0, 1.0));
+		}
+	}
+	img->unlock();
+	img->save_png(p_path);
+}
+
+static bool _benchmark_compression(const Ref<Image> &p_image, Image::CompressMode p_mode, const char *p_name) {
+
+	Ref<Image> image = p_image->duplicate();
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Error err = image->compress(p_mode, Image::COMPRESS_SOURCE_GENERIC, 0.7);
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - t;
+
+	if (err != OK) {
+		OS::get_singleton()->print("\t%s: compressor not available\n", p_name);
+		return true;
+	}
+
+	OS::get_singleton()->print("\t%s: %ix%i with mipmaps in %i msec on %i cores\n", p_name, image->get_width(), image->get_height(), int(time / 1000), OS::get_singleton()->get_processor_count());
+	return image->is_compressed() && image->has_mipmaps() && image->get_width() == p_image->get_width();
+}
+
+enum {
+	ASSET_COUNT = 64,
+	CSV_ROWS = 2000
+};
+
+static String asset_dir = "res://godot_test_import";
+static Vector<String> sources;
+static Vector<String> translations;
+
+static void _create_assets() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	da->make_dir_recursive(asset_dir);
+	memdelete(da);
+
+	for (int i = 0; i < ASSET_COUNT; i++) {
+		String base = asset_dir.plus_file("asset_" + itos(i));
+		_make_wav(base + ".wav", 44100, 220 + i * 10);
+		sources.push_back(base + ".wav");
+		_make_csv(base + ".csv", CSV_ROWS);
+		sources.push_back(base + ".csv");
+		translations.push_back(base + ".es.translation");
+		_make_png(base + ".png", 512, i);
+		sources.push_back(base + ".png");
+	}
+}
+
+static bool _is_imported(EditorFileSystem *p_efs, const String &p_path) {
+
+	EditorFileSystemDirectory *dir = p_efs->get_filesystem_path(p_path.get_base_dir());
+	int idx = dir ? dir->find_file_index(p_path.get_file()) : -1;
+	return idx != -1 && dir->get_file_import_is_valid(idx);
+}
+
+bool test_compression() {
+
+	// VRAM compression splits blocks and mipmaps over all cores, run this
+	// under taskset or similar to compare against fewer cores
+	OS::get_singleton()->print("\n\nTest 1: VRAM compression of a 2048x2048 texture\n");
+
+	Ref<Image> image;
+	image.instance();
+	image->create(2048, 2048, false, Image::FORMAT_RGBA8);
+	image->lock();
+	for (int y = 0; y < 2048; y++) {
+		for (int x = 0; x < 2048; x++) {
+			image->set_pixel(x, y, Color(float(x) / 2048, float(y) / 2048, float((x ^ y) & 0xFF) / 255.0, float((x + y) & 0xFF) / 255.0));
+		}
+	}
+	image->unlock();
+	image->generate_mipmaps();
+
+	CHECK(_benchmark_compression(image, Image::COMPRESS_S3TC, "s3tc"));
+	CHECK(_benchmark_compression(image, Image::COMPRESS_ETC, "etc"));
+	CHECK(_benchmark_compression(image, Image::COMPRESS_ETC2, "etc2"));
+	CHECK(_benchmark_compression(image, Image::COMPRESS_BPTC, "bptc"));
+
+	return true;
+}
+
+// Lists a synthetic project the way EditorFileSystem does on startup, then
+// looks for a single modified file by checking every file, as scan_changes()
+// does without inotify, and by asking the scanner which directories changed.
+
+static void _count_scanned(const EditorFileSystemScanner::Dir *p_dir, int &r_dirs, int &r_files) {
+
+	r_dirs++;
+	r_files += p_dir->files.size();
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+		_count_scanned(p_dir->subdirs[i], r_dirs, r_files);
+	}
+}
+
+static void _check_scanned(const EditorFileSystemScanner::Dir *p_dir) {
+
+	FileAccess::get_modified_time(p_dir->path);
+	for (int i = 0; i < p_dir->files.size(); i++) {
+		String path = p_dir->path.plus_file(p_dir->files[i].name);
+		FileAccess::get_modified_time(path);
+		if (p_dir->files[i].imported && FileAccess::exists(path + ".import")) {
+			FileAccess::get_modified_time(path + ".import");
+		}
+	}
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+		_check_scanned(p_dir->subdirs[i]);
+	}
+}
+
+static void _watch_scanned(EditorFileSystemScanner &p_scanner, const EditorFileSystemScanner::Dir *p_dir) {
+
+	p_scanner.watch_dir(p_dir->path);
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+		_watch_scanned(p_scanner, p_dir->subdirs[i]);
+	}
+}
+
+bool test_scan() {
+
+	OS::get_singleton()->print("\n\nTest 2: Scanning a synthetic project tree\n");
+
+	String root = OS::get_singleton()->get_cache_path().plus_file("godot_test_import_scan");
+	const int dirs = 20; // dirs * dirs leaf directories
+	const int files = 25; // per leaf directory, half of them imported
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	for (int i = 0; i < dirs; i++) {
+		for (int j = 0; j < dirs; j++) {
+			String dir = root.plus_file("dir_" + itos(i)).plus_file("dir_" + itos(j));
+			da->make_dir_recursive(dir);
+			for (int k = 0; k < files; k++) {
+				String path = dir.plus_file("file_" + itos(k) + (k & 1 ? ".tres" : ".png"));
+				FileAccessRef f = FileAccess::open(path, FileAccess::WRITE);
+				f->store_line(path);
+				if (!(k & 1)) {
+					FileAccessRef fi = FileAccess::open(path + ".import", FileAccess::WRITE);
+					fi->store_line("[remap]");
+				}
+			}
+		}
+	}
+	memdelete(da);
+
+	Set<String> extensions;
+	extensions.insert("png");
+	extensions.insert("tres");
+	Set<String> import_extensions;
+	import_extensions.insert("png");
+
+	EditorFileSystemScanner scanner(DirAccess::ACCESS_FILESYSTEM);
+	scanner.set_extensions(extensions, import_extensions);
+
+	scanner.set_use_threads(false);
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	EditorFileSystemScanner::Dir *scan = scanner.scan(root);
+	uint64_t serial_time = OS::get_singleton()->get_ticks_usec() - t;
+	memdelete(scan);
+
+	scanner.set_use_threads(true);
+	t = OS::get_singleton()->get_ticks_usec();
+	scan = scanner.scan(root);
+	uint64_t threaded_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	int scanned_dirs = 0;
+	int scanned_files = 0;
+	_count_scanned(scan, scanned_dirs, scanned_files);
+
+	OS::get_singleton()->print("\tlisting: %i directories, %i files, %i msec serial, %i msec on %i threads\n", scanned_dirs, scanned_files, int(serial_time / 1000), int(threaded_time / 1000), OS::get_singleton()->get_processor_count());
+
+	CHECK(scanned_dirs == 1 + dirs + dirs * dirs && scanned_files == dirs * dirs * files);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	_check_scanned(scan);
+	uint64_t check_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	if (scanner.start_watching()) {
+
+		_watch_scanned(scanner, scan);
+
+		Set<String> changed;
+		scanner.get_changed_dirs(&changed); // newly watched directories are reported once
+
+		const EditorFileSystemScanner::Dir *modified = scan->subdirs[dirs / 2]->subdirs[dirs / 3];
+		{
+			FileAccessRef f = FileAccess::open(modified->path.plus_file(modified->files[1].name), FileAccess::WRITE);
+			f->store_line("modified");
+		}
+
+		t = OS::get_singleton()->get_ticks_usec();
+		changed.clear();
+		bool complete = scanner.get_changed_dirs(&changed);
+		uint64_t watch_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("\tchanges: %i usec checking every file, %i usec with inotify\n", int(check_time), int(watch_time));
+
+		CHECK(complete && changed.size() == 1 && changed.has(modified->path));
+
+		// directories dropped from the tree are no longer reported
+		scanner.unwatch_dir(scan->subdirs[dirs / 2]->path);
+		{
+			FileAccessRef f = FileAccess::open(modified->path.plus_file(modified->files[1].name), FileAccess::WRITE);
+			f->store_line("modified again");
+		}
+
+		changed.clear();
+		complete = scanner.get_changed_dirs(&changed);
+		CHECK(complete && changed.size() == 0);
+
+		// losing the removal watch reports lost changes until it is watched again
+		String removals = root.plus_file("removals");
+		da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+		da->make_dir(removals);
+		scanner.watch_removals(removals);
+		da->remove(removals);
+
+		bool lost = !scanner.get_changed_dirs(&changed);
+		bool still_lost = !scanner.get_changed_dirs(&changed);
+		da->make_dir(removals);
+		scanner.watch_removals(removals);
+		bool restored = scanner.get_changed_dirs(&changed);
+		da->remove(removals);
+		memdelete(da);
+
+		CHECK(lost && still_lost && restored);
+
+		scanner.stop_watching();
+	} else {
+		OS::get_singleton()->print("\tchanges: %i usec checking every file, watching is not supported here\n", int(check_time));
+	}
+
+	memdelete(scan);
+	return true;
+}
+
+bool test_reimport() {
+
+	OS::get_singleton()->print("\n\nTest 3: Reimporting a synthetic asset set in %s\n", asset_dir.utf8().get_data());
+
+	EditorFileSystem *efs = EditorFileSystem::get_singleton();
+	if (!efs) {
+		OS::get_singleton()->print("\treimport: needs the editor, run with -e --path <project>\n");
+		return true;
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	efs->reimport_files(sources);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\treimport: %i files in %i msec on %i threads\n", sources.size(), int(t / 1000), OS::get_singleton()->get_processor_count());
+
+	int imported = 0;
+	for (int i = 0; i < sources.size(); i++) {
+		if (_is_imported(efs, sources[i]))
+			imported++;
+	}
+
+	// translations are saved by the importer, which must let the file system know about them
+	int known_translations = 0;
+	for (int i = 0; i < translations.size(); i++) {
+		if (efs->get_file_type(translations[i]) != String())
+			known_translations++;
+	}
+
+	DirAccess *da = DirAccess::open(asset_dir);
+	if (da) {
+		da->erase_contents_recursive();
+		memdelete(da);
+	}
+	da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	da->remove(asset_dir);
+	memdelete(da);
+
+	CHECK(imported == sources.size());
+	CHECK(known_translations == translations.size());
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_compression,
+	test_scan,
+	test_reimport,
+	0
+
+};
+
+// creates the assets once the editor is done scanning, then runs the tests
+class TestMainLoop : public SceneTree {
+
+	bool assets_created;
+
+public:
+	virtual void init() {
+
+		SceneTree::init();
+
+		assets_created = false;
+	}
+
+	virtual bool idle(float p_time) {
+
+		bool ret = SceneTree::idle(p_time);
+
+		EditorFileSystem *efs = EditorFileSystem::get_singleton();
+		if (efs) {
+			// wait for the scans, the one that finds the new assets imports them once
+			if (efs->is_scanning() || efs->is_importing())
+				return ret;
+
+			if (!assets_created) {
+				_create_assets();
+				assets_created = true;
+				efs->scan_changes();
+				return ret;
+			}
+		}
+
+		run_test_funcs(test_funcs);
+		return true;
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(TestMainLoop);
+}
+}
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,276 @@
+/*************************************************************************/
+/*  test_json.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_json.h"
+
+#include "core/io/json.h"
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "test_macros.h"
+
+namespace TestJSON {
+
+static Variant _parse(const String &p_json, Error *r_err = NULL, String *r_err_str = NULL, int *r_err_line = NULL) {
+
+	Variant ret;
+	String err_str;
+	int err_line;
+	Error err = JSON::parse(p_json, ret, err_str, err_line);
+	if (r_err)
+		*r_err = err;
+	if (r_err_str)
+		*r_err_str = err_str;
+	if (r_err_line)
+		*r_err_line = err_line;
+	return ret;
+}
+
+bool test_print_parse() {
+
+	OS::get_singleton()->print("\n\nTest 1: Printing and parsing\n");
+
+	Dictionary d;
+	Array a;
+	a.push_back(1);
+	a.push_back(2.5);
+	a.push_back("x\"y\\z\n\t\b\f\r");
+	d["array"] = a;
+	d["null"] = Variant();
+	d["true"] = true;
+	d["unicode"] = String::utf8("\xc3\xa9t\xc3\xa9");
+	d["empty"] = Dictionary();
+
+	String text = JSON::print(d);
+	CHECK(text == String::utf8("{\"array\":[1,2.5,\"x\\\"y\\\\z\\n\\t\\b\\f\\r\"],\"empty\":{},\"null\":null,\"true\":true,\"unicode\":\"\xc3\xa9t\xc3\xa9\"}"));
+	CHECK(JSON::print(d, "\t") == String::utf8("{\n\t\"array\": [\n\t\t1,\n\t\t2.5,\n\t\t\"x\\\"y\\\\z\\n\\t\\b\\f\\r\"\n\t],\n\t\"empty\": {\n\n\t},\n\t\"null\": null,\n\t\"true\": true,\n\t\"unicode\": \"\xc3\xa9t\xc3\xa9\"\n}"));
+
+	CHECK(JSON::print("\v") == "\"\\v\"");
+
+	Error err;
+	Dictionary parsed = _parse(text, &err);
+	CHECK(err == OK);
+	CHECK(JSON::print(parsed) == text);
+	CHECK(String(Array(parsed["array"])[2]) == String(a[2]));
+
+	CHECK(String(_parse("\"\\u00e9\\u00C9\\/\"")) == String::utf8("\xc3\xa9\xc3\x89/"));
+	CHECK(_parse(" [ true , false , null , -0.5e1 ] ") == _parse("[true,false,null,-5]"));
+
+	// repeated keys share one String, values stay independent
+	Array objects = _parse("[{\"key\":\"a\"},{\"key\":\"b\"},{\"k\\u0065y\":\"c\"}]");
+	CHECK(objects.size() == 3);
+	CHECK(String(Dictionary(objects[1])["key"]) == "b");
+	CHECK(String(Dictionary(objects[2])["key"]) == "c");
+
+	return true;
+}
+
+bool test_errors() {
+
+	OS::get_singleton()->print("\n\nTest 2: Parse errors\n");
+
+	static const char *texts[] = {
+		"", "Expected value, got EOF.",
+		"[1 2]", "Expected ','",
+		"{\"a\" 1}", "Expected ':'",
+		"{1:2}", "Expected key",
+		"{\"a\":1 \"b\":2}", "Expected '}' or ','",
+		"{\"a\":}", "Expected value, got '}'.",
+		"[truth]", "Expected 'true','false' or 'null', got 'truth'.",
+		"[\n\"abc", "Unterminated String",
+		"\"\\u12g4\"", "Malformed hex constant in string",
+		"[\n\n#]", "Unexpected character.",
+		NULL
+	};
+
+	for (int i = 0; texts[i]; i += 2) {
+
+		Error err;
+		String err_str;
+		_parse(texts[i], &err, &err_str);
+		CHECK(err == ERR_PARSE_ERROR);
+		CHECK(err_str == texts[i + 1]);
+	}
+
+	int line;
+	_parse("[\n1,\n\"a\nb\",\n#]", NULL, NULL, &line);
+	CHECK(line == 4);
+
+	return true;
+}
+
+bool test_numbers() {
+
+	OS::get_singleton()->print("\n\nTest 3: Numbers\n");
+
+	// must convert exactly as String::to_double() does
+	uint64_t seed = 7;
+	for (int i = 0; i < 100000; i++) {
+
+		uint32_t r = Math::rand_from_seed(&seed);
+		double v = (double(r) / 0xFFFFFFFF - 0.5) * Math::pow(10.0, double(int(r % 60) - 30));
+		String text = i % 3 ? rtoss(v) : String::num_scientific(v);
+		if (i % 5 == 0)
+			text = itos(int64_t(r) * (i % 2 ? -1 : 1));
+
+		Variant parsed = _parse(text);
+		CHECK(parsed.get_type() == Variant::REAL);
+		CHECK(double(parsed) == text.to_double());
+	}
+
+	CHECK(double(_parse("123456789012345678901234")) == String("123456789012345678901234").to_double());
+	CHECK(double(_parse("1.5E+3")) == 1500.0);
+	CHECK(double(_parse("2e-2")) == 0.02);
+	CHECK(double(_parse("-0")) == 0.0);
+
+	return true;
+}
+
+class CountingHandler : public JSON::Handler {
+
+public:
+	int objects;
+	int arrays;
+	int keys;
+	int values;
+	int stop_at;
+
+	virtual Error begin_object() {
+		objects++;
+		return OK;
+	}
+	virtual Error key(const String &p_key) {
+		keys++;
+		return OK;
+	}
+	virtual Error begin_array() {
+		arrays++;
+		return OK;
+	}
+	virtual Error value(const Variant &p_value) {
+		values++;
+		return values == stop_at ? ERR_SKIP : OK;
+	}
+
+	CountingHandler() {
+		objects = 0;
+		arrays = 0;
+		keys = 0;
+		values = 0;
+		stop_at = -1;
+	}
+};
+
+bool test_handler() {
+
+	OS::get_singleton()->print("\n\nTest 4: Parsing with a handler\n");
+
+	String text = "{\"a\":[1,2,{\"b\":\"c\"}],\"d\":[],\"e\":null}";
+	String err_str;
+	int line;
+
+	CountingHandler counter;
+	CHECK(JSON::parse(text, &counter, err_str, line) == OK);
+	CHECK(counter.objects == 2 && counter.arrays == 2 && counter.keys == 4 && counter.values == 4);
+
+	CountingHandler stopper;
+	stopper.stop_at = 2;
+	CHECK(JSON::parse(text, &stopper, err_str, line) == ERR_SKIP);
+	CHECK(stopper.values == 2 && stopper.objects == 1);
+
+	return true;
+}
+
+bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 5: Large payload\n");
+
+	// the shape of a server response listing players
+	const int count = 50000;
+	Array players;
+	uint64_t seed = 11;
+	for (int i = 0; i < count; i++) {
+
+		Dictionary player;
+		player["id"] = i;
+		player["name"] = "player_" + itos(i);
+		Array position;
+		for (int j = 0; j < 3; j++)
+			position.push_back((double(Math::rand_from_seed(&seed) % 200000) - 100000.0) / 64.0);
+		player["position"] = position;
+		player["score"] = Math::rand_from_seed(&seed) / 3.0;
+		player["online"] = i % 3 == 0;
+		player["status"] = i % 7 ? Variant() : Variant("away\nback \"soon\"");
+		players.push_back(player);
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	String text = JSON::print(players);
+	uint64_t print_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+
+	Error err;
+	t = OS::get_singleton()->get_ticks_usec();
+	Array parsed = _parse(text, &err);
+	uint64_t parse_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+	CHECK(err == OK);
+	CHECK(parsed.size() == count);
+	CHECK(JSON::print(parsed) == text);
+
+	CountingHandler counter;
+	String err_str;
+	int line;
+	t = OS::get_singleton()->get_ticks_usec();
+	CHECK(JSON::parse(text, &counter, err_str, line) == OK);
+	uint64_t handler_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+	CHECK(counter.objects == count);
+
+	double mb = text.length() / (1024.0 * 1024.0);
+	OS::get_singleton()->print("\t%.1f MB, print %.1f MB/s, parse %.1f MB/s, parse with handler %.1f MB/s\n", mb, mb / (print_time / 1000000.0), mb / (parse_time / 1000000.0), mb / (handler_time / 1000000.0));
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_print_parse,
+	test_errors,
+	test_numbers,
+	test_handler,
+	test_benchmark,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+} // namespace TestJSON
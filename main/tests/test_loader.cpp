@@ -0,0 +1,216 @@
+/*************************************************************************/
+/*  test_loader.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_loader.h"
+
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/translation.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+#include "test_macros.h"
+
+namespace TestLoader {
+
+// Saves a scene referencing many large external resources and loads it
+// with ResourceLoader::load() and with the background loading API, which
+// spreads the external resources over the loading threads.
+
+struct SharedLoad {
+
+	String path;
+	RES result;
+};
+
+static void _load_shared(void *p_userdata) {
+
+	SharedLoad *load = (SharedLoad *)p_userdata;
+	load->result = ResourceLoader::load(load->path);
+}
+
+static bool _check_scene(Node *p_root, int p_count, int p_messages) {
+
+	if (!p_root || p_root->get_child_count() != p_count)
+		return false;
+
+	for (int i = 0; i < p_count; i++) {
+		Ref<Translation> tr = p_root->get_child(i)->get_meta("translation");
+		if (tr.is_null() || tr->get_message_count() != p_messages)
+			return false;
+	}
+	return true;
+}
+
+enum {
+	RESOURCE_COUNT = 48,
+	MESSAGE_COUNT = 2000
+};
+
+static String test_dir;
+static String scene_path;
+
+// saved once, by the first test that needs it
+static String _get_scene_path() {
+
+	if (scene_path != String())
+		return scene_path;
+
+	test_dir = OS::get_singleton()->get_cache_path().plus_file("godot_test_loader");
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(test_dir);
+	memdelete(da);
+
+	OS::get_singleton()->print("\n\nSaving a scene with %i external resources in %s\n", int(RESOURCE_COUNT), test_dir.utf8().get_data());
+
+	Node *root = memnew(Node);
+	root->set_name("Root");
+
+	for (int i = 0; i < RESOURCE_COUNT; i++) {
+
+		Ref<Translation> tr;
+		tr.instance();
+		tr->set_locale("en");
+		for (int j = 0; j < MESSAGE_COUNT; j++) {
+			tr->add_message("KEY_" + itos(i) + "_" + itos(j), "text " + itos(j) + " for resource " + itos(i));
+		}
+		String path = test_dir.plus_file("translation_" + itos(i) + ".res");
+		ResourceSaver::save(path, tr);
+		tr->set_path(path);
+
+		Node *child = memnew(Node);
+		child->set_name("Child" + itos(i));
+		child->set_meta("translation", tr);
+		root->add_child(child);
+		child->set_owner(root);
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	scene->pack(root);
+	ResourceSaver::save(test_dir.plus_file("scene.scn"), scene);
+	memdelete(root);
+
+	scene_path = test_dir.plus_file("scene.scn");
+	return scene_path;
+}
+
+bool test_load() {
+
+	String path = _get_scene_path();
+
+	OS::get_singleton()->print("\n\nTest 1: Loading the scene with load()\n");
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Ref<PackedScene> scene = ResourceLoader::load(path);
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i msec\n", int(time / 1000));
+
+	CHECK(scene.is_valid());
+	Node *instance = scene->instance();
+	bool loaded = _check_scene(instance, RESOURCE_COUNT, MESSAGE_COUNT);
+	if (instance)
+		memdelete(instance);
+	CHECK(loaded);
+
+	return true;
+}
+
+bool test_load_threaded() {
+
+	String path = _get_scene_path();
+
+	OS::get_singleton()->print("\n\nTest 2: Loading the scene with load_threaded_request()\n");
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	ResourceLoader::load_threaded_request(path);
+	while (ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	Ref<PackedScene> scene = ResourceLoader::load_threaded_get(path);
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i msec on %i cores\n", int(time / 1000), OS::get_singleton()->get_processor_count());
+
+	CHECK(scene.is_valid());
+	Node *instance = scene->instance();
+	bool loaded = _check_scene(instance, RESOURCE_COUNT, MESSAGE_COUNT);
+	if (instance)
+		memdelete(instance);
+	CHECK(loaded);
+
+	return true;
+}
+
+bool test_load_shared() {
+
+	_get_scene_path();
+
+	OS::get_singleton()->print("\n\nTest 3: Loading the same resource from several threads at once\n");
+
+	// threads loading the same path at once get the same resource, loaded once
+	SharedLoad loads[4];
+	Thread *threads[4];
+	for (int i = 0; i < 4; i++) {
+		loads[i].path = test_dir.plus_file("translation_0.res");
+		threads[i] = Thread::create(_load_shared, &loads[i]);
+	}
+	for (int i = 0; i < 4; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		Ref<Translation> tr = loads[i].result;
+		CHECK(tr.is_valid() && tr == loads[0].result && tr->get_message_count() == MESSAGE_COUNT);
+	}
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_load,
+	test_load_threaded,
+	test_load_shared,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+}
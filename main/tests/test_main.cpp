@@ -33,17 +33,27 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_arena.h"
 #include "test_astar.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
+#ifdef TOOLS_ENABLED
+#include "test_import.h"
+#endif
+#include "test_json.h"
+#include "test_loader.h"
 #include "test_math.h"
+#include "test_object.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
+#include "test_pack.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
+#include "test_process.h"
 #include "test_render.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_variant.h"
 
 const char **tests_get_names() {
 
@@ -62,6 +72,16 @@ const char **tests_get_names() {
 		"gd_bytecode",
 		"ordered_hash_map",
 		"astar",
+		"variant",
+		"object",
+		"process",
+		"pack",
+		"loader",
+		"json",
+		"arena",
+#ifdef TOOLS_ENABLED
+		"import",
+#endif
 		NULL
 	};
 
@@ -142,6 +162,48 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "variant") {
+
+		return TestVariant::test();
+	}
+
+	if (p_test == "object") {
+
+		return TestObject::test();
+	}
+
+	if (p_test == "process") {
+
+		return TestProcess::test();
+	}
+
+	if (p_test == "pack") {
+
+		return TestPack::test();
+	}
+
+	if (p_test == "loader") {
+
+		return TestLoader::test();
+	}
+
+	if (p_test == "json") {
+
+		return TestJSON::test();
+	}
+
+	if (p_test == "arena") {
+
+		return TestArena::test();
+	}
+
+#ifdef TOOLS_ENABLED
+	if (p_test == "import") {
+
+		return TestImport::test();
+	}
+#endif
+
 	print_line("Unknown test: " + p_test);
 	return NULL;
 }
@@ -31,6 +31,7 @@
 #include "test_math.h"
 
 #include "core/math/basis.h"
+#include "core/math/batch_math.h"
 #include "core/math/camera_matrix.h"
 #include "core/math/math_funcs.h"
 #include "core/math/transform.h"
@@ -402,8 +403,96 @@ uint32_t ihash3(uint32_t a) {
 	return a;
 }
 
+void test_batch_math() {
+
+	const int count = 100003; // not a multiple of 4, so the scalar tails run too
+	Vector<Vector3> points;
+	Vector<AABB> aabbs;
+	points.resize(count);
+	aabbs.resize(count);
+	for (int i = 0; i < count; i++) {
+		points.write[i] = Vector3(Math::random(-100.0, 100.0), Math::random(-100.0, 100.0), Math::random(-100.0, 100.0));
+		aabbs.write[i] = AABB(points[i], Vector3(Math::random(0.0, 5.0), Math::random(0.0, 5.0), Math::random(0.0, 5.0)));
+	}
+
+	Transform xform(Basis(Vector3(0.3, 1, 0.2).normalized(), 0.7).scaled(Vector3(1, 2, 3)), Vector3(5, -3, 2));
+	Vector<Vector3> result;
+	result.resize(count);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		result.write[i] = xform.xform(points[i]);
+	}
+	uint64_t scalar_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	BatchMath::xform_points(xform, points.ptr(), points.ptrw(), count);
+	uint64_t batch_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	bool ok = true;
+	for (int i = 0; i < count; i++) {
+		ok = ok && points[i].distance_to(result[i]) < CMP_EPSILON * 1000;
+	}
+	print_line("BatchMath::xform_points " + String(ok ? "OK" : "FAILED") + ", scalar " + itos(scalar_time) + " usec, batch " + itos(batch_time) + " usec");
+
+	Transform a = xform;
+	Transform b(Basis(Vector3(1, 0, 0), 1.2), Vector3(1, 2, 3));
+	Transform r;
+	BatchMath::mul_transforms(&a, &b, &r, 1);
+	Transform expected = a * b;
+	ok = r.basis.is_equal_approx(r.basis, expected.basis) && r.origin.distance_to(expected.origin) < CMP_EPSILON * 100;
+	float rows[12];
+	BatchMath::xform_to_rows(a, &b, 0, NULL, rows, 12, 1);
+	ok = ok && Math::is_equal_approx(rows[1], expected.basis.elements[0][1]) && Math::is_equal_approx(rows[7], expected.origin.y);
+	print_line("BatchMath::mul_transforms/xform_to_rows " + String(ok ? "OK" : "FAILED"));
+
+	AABB merged = aabbs[0];
+	AABB bounds = AABB(points[0], Vector3());
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 1; i < count; i++) {
+		merged.merge_with(aabbs[i]);
+		bounds.expand_to(points[i]);
+	}
+	scalar_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	AABB batch_merged = BatchMath::merge_aabbs(aabbs.ptr(), count);
+	AABB batch_bounds = BatchMath::compute_aabb(points.ptr(), count);
+	batch_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	// the scalar versions accumulate rounding errors in size, compare loosely
+	ok = merged.position.distance_to(batch_merged.position) < 0.001 && merged.size.distance_to(batch_merged.size) < 0.001;
+	ok = ok && bounds.position.distance_to(batch_bounds.position) < 0.001 && bounds.size.distance_to(batch_bounds.size) < 0.001;
+	print_line("BatchMath::merge_aabbs/compute_aabb " + String(ok ? "OK" : "FAILED") + ", scalar " + itos(scalar_time) + " usec, batch " + itos(batch_time) + " usec");
+
+	CameraMatrix cm;
+	cm.set_perspective(60, 1.5, 0.1, 80);
+	Vector<Plane> planes = cm.get_projection_planes(Transform(Basis(), Vector3(0, 0, 20)));
+	Vector<uint8_t> inside;
+	inside.resize(count);
+
+	int scalar_inside = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		scalar_inside += aabbs[i].intersects_convex_shape(planes.ptr(), planes.size()) ? 1 : 0;
+	}
+	scalar_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	int batch_inside = BatchMath::cull_aabbs(planes.ptr(), planes.size(), aabbs.ptr(), count, inside.ptrw());
+	batch_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	ok = scalar_inside == batch_inside;
+	for (int i = 0; i < count && ok; i++) {
+		ok = (inside[i] != 0) == aabbs[i].intersects_convex_shape(planes.ptr(), planes.size());
+	}
+	print_line("BatchMath::cull_aabbs " + String(ok ? "OK" : "FAILED") + " (" + itos(batch_inside) + " visible), scalar " + itos(scalar_time) + " usec, batch " + itos(batch_time) + " usec");
+}
+
 MainLoop *test() {
 
+	test_batch_math();
+
 	{
 		float r = 1;
 		float g = 0.5;
@@ -0,0 +1,347 @@
+/*************************************************************************/
+/*  test_object.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_object.h"
+
+#include "core/message_queue.h"
+#include "core/object.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "test_macros.h"
+
+namespace TestObject {
+
+bool test_signal_binds() {
+
+	OS::get_singleton()->print("\n\nTest 1: Signal arguments and binds\n");
+
+	Object *emitter = memnew(Object);
+	Object *target = memnew(Object);
+	emitter->add_user_signal(MethodInfo("with_arg", PropertyInfo(Variant::STRING, "name")));
+
+	Vector<Variant> binds;
+	binds.push_back(42);
+	emitter->connect("with_arg", target, "set_meta", binds);
+	emitter->emit_signal("with_arg", "answer");
+	CHECK(int(target->get_meta("answer")) == 42);
+
+	// two binds, the buffer must grow
+	Object *target2 = memnew(Object);
+	emitter->add_user_signal(MethodInfo("no_arg"));
+	binds.clear();
+	binds.push_back("key");
+	binds.push_back("value");
+	emitter->connect("no_arg", target, "set_meta", binds);
+	emitter->connect("no_arg", target2, "set_meta", binds);
+	emitter->emit_signal("no_arg");
+	CHECK(String(target->get_meta("key")) == "value" && String(target2->get_meta("key")) == "value");
+
+	memdelete(emitter);
+	memdelete(target);
+	memdelete(target2);
+
+	return true;
+}
+
+bool test_signal_oneshot() {
+
+	OS::get_singleton()->print("\n\nTest 2: One shot connections\n");
+
+	Object *emitter = memnew(Object);
+	Object *target = memnew(Object);
+	emitter->add_user_signal(MethodInfo("fired"));
+
+	Vector<Variant> binds;
+	binds.push_back("count");
+	binds.push_back(1);
+	emitter->connect("fired", target, "set_meta", binds, Object::CONNECT_ONESHOT);
+	CHECK(emitter->is_connected("fired", target, "set_meta"));
+
+	emitter->emit_signal("fired");
+	CHECK(!emitter->is_connected("fired", target, "set_meta"));
+	CHECK(int(target->get_meta("count")) == 1);
+
+	target->set_meta("count", 0);
+	emitter->emit_signal("fired");
+	CHECK(int(target->get_meta("count")) == 0);
+
+	memdelete(emitter);
+	memdelete(target);
+
+	return true;
+}
+
+bool test_signal_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 3: Signal emission cost vs. connection count\n");
+
+	const int emissions = 10000;
+	const int counts[] = { 1, 10, 100 };
+
+	for (int c = 0; c < 3; c++) {
+
+		Object *emitter = memnew(Object);
+		emitter->add_user_signal(MethodInfo("plain"));
+		emitter->add_user_signal(MethodInfo("bound"));
+
+		Vector<Object *> targets;
+		Vector<Variant> binds;
+		binds.push_back("meta");
+		for (int i = 0; i < counts[c]; i++) {
+			Object *target = memnew(Object);
+			emitter->connect("plain", target, "get_instance_id");
+			emitter->connect("bound", target, "has_meta", binds);
+			targets.push_back(target);
+		}
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < emissions; i++) {
+			emitter->emit_signal("plain");
+		}
+		uint64_t plain_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < emissions; i++) {
+			emitter->emit_signal("bound");
+		}
+		uint64_t bound_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("\t%i connections: %i nsec per emission, %i nsec with binds\n", counts[c], int(plain_time * 1000 / emissions), int(bound_time * 1000 / emissions));
+
+		memdelete(emitter);
+		for (int i = 0; i < targets.size(); i++) {
+			memdelete(targets[i]);
+		}
+	}
+
+	return true;
+}
+
+struct DeferredPushData {
+
+	ObjectID target;
+	int index;
+	int calls;
+	String meta;
+};
+
+static void _push_deferred_calls(void *p_userdata) {
+
+	DeferredPushData *data = (DeferredPushData *)p_userdata;
+	StringName method = "set_meta";
+	Variant meta = data->meta.empty() ? "thread_" + itos(data->index) : data->meta;
+	Variant value;
+	const Variant *args[2] = { &meta, &value };
+
+	for (int i = 0; i < data->calls; i++) {
+		value = i;
+		MessageQueue::get_singleton()->push_call(data->target, method, args, 2);
+	}
+}
+
+bool test_deferred_threads() {
+
+	OS::get_singleton()->print("\n\nTest 4: Deferred calls from several threads\n");
+
+	const int thread_count = 4;
+	const int calls = 5000;
+
+	Object *target = memnew(Object);
+	StringName method = "set_meta";
+	Variant meta = "main";
+	Variant value;
+	const Variant *args[2] = { &meta, &value };
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < calls; i++) {
+		value = i;
+		MessageQueue::get_singleton()->push_call(target->get_instance_id(), method, args, 2);
+	}
+	uint64_t push_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	CHECK(MessageQueue::get_singleton()->get_buffer_usage() > 0);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	MessageQueue::get_singleton()->flush();
+	uint64_t flush_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	CHECK(MessageQueue::get_singleton()->get_buffer_usage() == 0);
+	CHECK(int(target->get_meta("main")) == calls - 1);
+
+	OS::get_singleton()->print("\t%i nsec per push, %i nsec per flushed call\n", int(push_time * 1000 / calls), int(flush_time * 1000 / calls));
+
+	DeferredPushData data[thread_count];
+	Thread *threads[thread_count];
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < thread_count; i++) {
+		data[i].target = target->get_instance_id();
+		data[i].index = i;
+		data[i].calls = calls;
+		threads[i] = Thread::create(_push_deferred_calls, &data[i]);
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	push_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	MessageQueue::get_singleton()->flush();
+
+	// calls from each thread keep their order, so the last value pushed wins
+	for (int i = 0; i < thread_count; i++) {
+		CHECK(int(target->get_meta("thread_" + itos(i))) == calls - 1);
+	}
+
+	// calls from different threads keep the order they were pushed in too
+	value = 0;
+	meta = "order";
+	MessageQueue::get_singleton()->push_call(target->get_instance_id(), method, args, 2);
+	data[0].meta = "order";
+	data[0].calls = 2;
+	threads[0] = Thread::create(_push_deferred_calls, &data[0]);
+	Thread::wait_to_finish(threads[0]);
+	memdelete(threads[0]);
+	value = 2;
+	MessageQueue::get_singleton()->push_call(target->get_instance_id(), method, args, 2);
+	MessageQueue::get_singleton()->flush();
+	CHECK(int(target->get_meta("order")) == 2);
+	CHECK(MessageQueue::get_singleton()->get_buffer_usage() == 0);
+
+	OS::get_singleton()->print("\t%i threads pushed %i calls each in %i usec\n", thread_count, calls, int(push_time));
+
+	memdelete(target);
+
+	return true;
+}
+
+struct LookupData {
+
+	const ObjectID *ids;
+	int count;
+	int passes;
+	int found;
+};
+
+static void _lookup_instances(void *p_userdata) {
+
+	LookupData *data = (LookupData *)p_userdata;
+	data->found = 0;
+
+	for (int i = 0; i < data->passes; i++) {
+		for (int j = 0; j < data->count; j++) {
+			if (ObjectDB::get_instance(data->ids[j]))
+				data->found++;
+		}
+	}
+}
+
+bool test_instance_lookup() {
+
+	OS::get_singleton()->print("\n\nTest 5: ObjectDB lookups from several threads\n");
+
+	const int thread_count = 4;
+	const int count = 10000;
+	const int passes = 100;
+
+	Vector<Object *> objects;
+	Vector<ObjectID> ids;
+	for (int i = 0; i < count; i++) {
+		objects.push_back(memnew(Object));
+		ids.push_back(objects[i]->get_instance_id());
+		CHECK(ObjectDB::get_instance(ids[i]) == objects[i]);
+	}
+
+	// a freed slot is reused, but never under the same id
+	ObjectID stale = ids[0];
+	memdelete(objects[0]);
+	CHECK(ObjectDB::get_instance(stale) == NULL);
+	objects.write[0] = memnew(Object);
+	ids.write[0] = objects[0]->get_instance_id();
+	CHECK(ids[0] != stale);
+	CHECK(ObjectDB::get_instance(stale) == NULL);
+	CHECK(ObjectDB::get_instance(ids[0]) == objects[0]);
+	CHECK(ObjectDB::get_instance(0) == NULL);
+
+	LookupData data[thread_count];
+	Thread *threads[thread_count];
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < thread_count; i++) {
+		data[i].ids = ids.ptr();
+		data[i].count = count;
+		data[i].passes = passes;
+		threads[i] = Thread::create(_lookup_instances, &data[i]);
+	}
+
+	// keep creating and freeing objects while the threads look up the others
+	for (int i = 0; i < count; i++) {
+		memdelete(memnew(Object));
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	uint64_t lookup_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	for (int i = 0; i < thread_count; i++) {
+		CHECK(data[i].found == count * passes);
+	}
+
+	OS::get_singleton()->print("\t%i threads did %i lookups each in %i usec\n", thread_count, count * passes, int(lookup_time));
+
+	for (int i = 0; i < count; i++) {
+		memdelete(objects[i]);
+		CHECK(ObjectDB::get_instance(ids[i]) == NULL);
+	}
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_signal_binds,
+	test_signal_oneshot,
+	test_signal_benchmark,
+	test_deferred_threads,
+	test_instance_lookup,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+} // namespace TestObject
@@ -0,0 +1,467 @@
+/*************************************************************************/
+/*  test_pack.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_pack.h"
+
+#include "core/hashfuncs.h"
+#include "core/io/file_access_pack.h"
+#include "core/io/pck_packer.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/math/math_funcs.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/translation.h"
+#include "test_macros.h"
+
+namespace TestPack {
+
+// Packs a set of loose files with PCKPacker, mounts the pack and reads
+// everything back through it, comparing contents and time against the
+// loose files. Pack sizes and file counts can be raised to profile startup
+// and load times of large projects.
+
+static String _get_test_dir() {
+
+	String dir = OS::get_singleton()->get_cache_path().plus_file("godot_test_pack");
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(dir);
+	memdelete(da);
+	return dir;
+}
+
+static uint32_t _read_all(const Vector<String> &p_paths, Vector<uint8_t> &r_buffer) {
+
+	uint32_t hash = 5381;
+	for (int i = 0; i < p_paths.size(); i++) {
+
+		FileAccess *f = FileAccess::open(p_paths[i], FileAccess::READ);
+		ERR_CONTINUE(!f);
+		int len = f->get_len();
+		if (r_buffer.size() < len)
+			r_buffer.resize(len);
+		f->get_buffer(r_buffer.ptrw(), len);
+		memdelete(f);
+
+		hash = hash_djb2_buffer(r_buffer.ptr(), len, hash);
+	}
+	return hash;
+}
+
+static int _load_all(const Vector<String> &p_paths, const Ref<Translation> &p_expected) {
+
+	int failed = 0;
+	for (int i = 0; i < p_paths.size(); i++) {
+
+		Ref<Translation> tr = ResourceLoader::load(p_paths[i], "", true);
+		if (tr.is_null() || tr->get_message_count() != p_expected->get_message_count() || tr->get_message("KEY_" + itos(i)) != p_expected->get_message("KEY_" + itos(i))) {
+			failed++;
+		}
+	}
+	return failed;
+}
+
+static int _lookup_all(const Vector<String> &p_paths) {
+
+	int found = 0;
+	for (int i = 0; i < p_paths.size(); i++) {
+		if (PackedData::get_singleton()->has_path(p_paths[i]))
+			found++;
+	}
+	return found;
+}
+
+bool test_read() {
+
+	const int file_count = 2000;
+	const int resource_count = 32;
+
+	String dir = _get_test_dir();
+
+	OS::get_singleton()->print("\n\nTest 1: Packing %i files in %s\n", file_count + resource_count, dir.utf8().get_data());
+
+	String pck_path = dir.plus_file("test.pck");
+	Ref<PCKPacker> packer;
+	packer.instance();
+	packer->pck_start(pck_path, 0);
+
+	Vector<String> loose_files;
+	Vector<String> packed_files;
+	uint64_t seed = 1;
+	for (int i = 0; i < file_count; i++) {
+
+		String name = "file_" + itos(i) + ".bin";
+		FileAccess *f = FileAccess::open(dir.plus_file(name), FileAccess::WRITE);
+		ERR_CONTINUE(!f);
+		int len = 256 + Math::rand_from_seed(&seed) % (64 * 1024);
+		for (int j = 0; j < len; j++) {
+			f->store_8(Math::rand_from_seed(&seed));
+		}
+		memdelete(f);
+
+		packer->add_file("res://godot_test_pack/" + name, dir.plus_file(name));
+		loose_files.push_back(dir.plus_file(name));
+		packed_files.push_back("res://godot_test_pack/" + name);
+	}
+
+	// binary resources full of strings, these are parsed straight out of the mapped pack
+	Ref<Translation> translation;
+	translation.instance();
+	for (int i = 0; i < 5000; i++) {
+		translation->add_message("KEY_" + itos(i), "text for key " + itos(i));
+	}
+
+	Vector<String> loose_resources;
+	Vector<String> packed_resources;
+	for (int i = 0; i < resource_count; i++) {
+
+		String name = "translation_" + itos(i) + ".res";
+		ResourceSaver::save(dir.plus_file(name), translation);
+		packer->add_file("res://godot_test_pack/" + name, dir.plus_file(name));
+		loose_resources.push_back(dir.plus_file(name));
+		packed_resources.push_back("res://godot_test_pack/" + name);
+	}
+
+	packer->flush();
+
+	uint64_t mem = OS::get_singleton()->get_static_memory_usage();
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Error err = PackedData::get_singleton()->add_pack(pck_path);
+	uint64_t mount_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	CHECK(err == OK);
+
+	OS::get_singleton()->print("\tmounted in %i msec, index takes %i KiB\n", int(mount_time / 1000), int((OS::get_singleton()->get_static_memory_usage() - mem) / 1024));
+
+	Vector<uint8_t> buffer;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	uint32_t loose_hash = _read_all(loose_files, buffer);
+	uint64_t loose_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	uint32_t packed_hash = _read_all(packed_files, buffer);
+	uint64_t packed_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\tread %i files: %i msec loose, %i msec from pack\n", file_count, int(loose_time / 1000), int(packed_time / 1000));
+
+	CHECK(loose_hash == packed_hash);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	int failed = _load_all(loose_resources, translation);
+	loose_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	failed += _load_all(packed_resources, translation);
+	packed_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\tload %i resources: %i msec loose, %i msec from pack\n", resource_count, int(loose_time / 1000), int(packed_time / 1000));
+
+	CHECK(failed == 0);
+
+	return true;
+}
+
+// Mounts a pack holding a large number of small files, once with its flat
+// index and once without it, as written by older versions, and looks up
+// every file in it.
+
+bool test_mount() {
+
+	const int count = 100000;
+	String dir = _get_test_dir();
+
+	String src = dir.plus_file("small.bin");
+	FileAccess *f = FileAccess::open(src, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, false);
+	for (int i = 0; i < 64; i++) {
+		f->store_8(i);
+	}
+	memdelete(f);
+
+	String pck_path = dir.plus_file("large.pck");
+	Ref<PCKPacker> packer;
+	packer.instance();
+	packer->pck_start(pck_path, 0);
+
+	Vector<String> paths;
+	for (int i = 0; i < count; i++) {
+		paths.push_back("res://godot_test_large/" + itos(i % 100) + "/file_" + itos(i) + ".bin");
+		packer->add_file(paths[i], src);
+	}
+	packer->flush();
+
+	// same pack with the index offset in the header cleared
+	String legacy_path = dir.plus_file("large_legacy.pck");
+	Vector<uint8_t> contents = FileAccess::get_file_as_array(pck_path);
+	for (int i = 5 * 4; i < 7 * 4; i++) {
+		contents.write[i] = 0;
+	}
+	f = FileAccess::open(legacy_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, false);
+	f->store_buffer(contents.ptr(), contents.size());
+	memdelete(f);
+	contents.clear();
+
+	OS::get_singleton()->print("\n\nTest 2: Mounting a pack with %i files\n", count);
+
+	uint64_t mem = OS::get_singleton()->get_static_memory_usage();
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Error err = PackedData::get_singleton()->add_pack(pck_path);
+	uint64_t mount_time = OS::get_singleton()->get_ticks_usec() - t;
+	uint64_t mount_mem = OS::get_singleton()->get_static_memory_usage() - mem;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	int found = _lookup_all(paths);
+	uint64_t lookup_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("	indexed: mounted in %i msec using %i KiB, %i lookups in %i msec\n", int(mount_time / 1000), int(mount_mem / 1024), count, int(lookup_time / 1000));
+	CHECK(err == OK && found == count);
+
+	int read = 0;
+	for (int i = 0; i < count; i += 97) {
+		f = FileAccess::open(paths[i], FileAccess::READ);
+		if (f && f->get_len() == 64 && f->get_8() == 0 && f->get_8() == 1)
+			read++;
+		if (f)
+			memdelete(f);
+	}
+	CHECK(read == (count + 96) / 97);
+
+	// the directory tree is built the first time it's needed
+	t = OS::get_singleton()->get_ticks_usec();
+	DirAccessPack *da = memnew(DirAccessPack);
+	int listed = 0;
+	if (da->change_dir("res://godot_test_large/7") == OK) {
+		da->list_dir_begin();
+		while (da->get_next() != String()) {
+			listed++;
+		}
+		da->list_dir_end();
+	}
+	memdelete(da);
+	OS::get_singleton()->print("	listed a directory in %i msec\n", int((OS::get_singleton()->get_ticks_usec() - t) / 1000));
+	CHECK(listed == count / 100);
+
+	mem = OS::get_singleton()->get_static_memory_usage();
+	t = OS::get_singleton()->get_ticks_usec();
+	err = PackedData::get_singleton()->add_pack(legacy_path);
+	mount_time = OS::get_singleton()->get_ticks_usec() - t;
+	mount_mem = OS::get_singleton()->get_static_memory_usage() - mem;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	found = _lookup_all(paths);
+	lookup_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("	without index: mounted in %i msec using %i KiB, %i lookups in %i msec\n", int(mount_time / 1000), int(mount_mem / 1024), count, int(lookup_time / 1000));
+	CHECK(err == OK && found == count);
+
+	return true;
+}
+
+// Packs the same set of text resources, small ones and a few spanning many
+// chunks, uncompressed and in the compressed modes, and reads everything
+// back, including from random positions.
+
+static String _make_text_resource(int p_index, int p_properties, uint64_t *r_seed) {
+
+	String text = "[gd_resource type=\"SpatialMaterial\" format=2]\n\n[ext_resource path=\"res://textures/texture_" + itos(p_index % 37) + ".png\" type=\"Texture\" id=1]\n\n[resource]\n";
+	for (int i = 0; i < p_properties; i++) {
+		uint32_t r = Math::rand_from_seed(r_seed);
+		switch (r % 4) {
+			case 0: {
+				text += "albedo_color = Color( " + rtos((r >> 4) % 256 / 255.0) + ", " + rtos((r >> 12) % 256 / 255.0) + ", 1, 1 )\n";
+			} break;
+			case 1: {
+				text += "metallic = " + rtos((r >> 4) % 100 / 100.0) + "\nmetallic_specular = 0.5\n";
+			} break;
+			case 2: {
+				text += "roughness = " + rtos((r >> 4) % 100 / 100.0) + "\nroughness_texture = ExtResource( 1 )\n";
+			} break;
+			case 3: {
+				text += "uv1_scale = Vector3( " + itos((r >> 4) % 8) + ", " + itos((r >> 8) % 8) + ", 1 )\nuv1_offset = Vector3( 0, 0, 0 )\n";
+			} break;
+		}
+	}
+	return text;
+}
+
+bool test_compression() {
+
+	const int count = 1000;
+	String dir = _get_test_dir();
+
+	Vector<String> loose_files;
+	uint64_t seed = 7;
+	for (int i = 0; i < count; i++) {
+
+		String name = "material_" + itos(i) + ".tres";
+		FileAccess *f = FileAccess::open(dir.plus_file(name), FileAccess::WRITE);
+		ERR_CONTINUE(!f);
+		f->store_string(_make_text_resource(i, i % 50 == 0 ? 10000 : 10 + i % 90, &seed));
+		memdelete(f);
+		loose_files.push_back(dir.plus_file(name));
+	}
+
+	OS::get_singleton()->print("\n\nTest 3: Packing %i text resources with compression\n", count);
+
+	Vector<uint8_t> buffer;
+	uint32_t loose_hash = _read_all(loose_files, buffer);
+
+	static const char *mode_names[] = { "none", "zstd", "zstd with dictionary" };
+
+	for (int mode = PCKPacker::COMPRESSION_NONE; mode <= PCKPacker::COMPRESSION_ZSTD_DICTIONARY; mode++) {
+
+		String pck_path = dir.plus_file("compressed_" + itos(mode) + ".pck");
+		String packed_dir = "res://godot_test_compressed_" + itos(mode);
+		Ref<PCKPacker> packer;
+		packer.instance();
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		packer->pck_start(pck_path, 0, PCKPacker::CompressionMode(mode));
+		Vector<String> packed_files;
+		for (int i = 0; i < count; i++) {
+			packed_files.push_back(packed_dir.plus_file(loose_files[i].get_file()));
+			packer->add_file(packed_files[i], loose_files[i]);
+		}
+		packer->flush();
+		uint64_t pack_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		FileAccess *f = FileAccess::open(pck_path, FileAccess::READ);
+		CHECK(f);
+		uint64_t pack_size = f->get_len();
+		memdelete(f);
+
+		CHECK(PackedData::get_singleton()->add_pack(pck_path) == OK);
+
+		t = OS::get_singleton()->get_ticks_usec();
+		uint32_t packed_hash = _read_all(packed_files, buffer);
+		uint64_t read_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("\t%s: %i KiB, packed in %i msec, read back in %i msec\n", mode_names[mode], int(pack_size / 1024), int(pack_time / 1000), int(read_time / 1000));
+
+		CHECK(packed_hash == loose_hash);
+
+		// random access into the files spanning several chunks
+		int mismatches = 0;
+		for (int i = 0; i < count; i += 50) {
+
+			Vector<uint8_t> loose = FileAccess::get_file_as_array(loose_files[i]);
+			f = FileAccess::open(packed_files[i], FileAccess::READ);
+			ERR_CONTINUE(!f);
+			for (int j = 0; j < 32; j++) {
+
+				uint8_t read[1000];
+				int ofs = Math::rand_from_seed(&seed) % loose.size();
+				f->seek(ofs);
+				int len = f->get_buffer(read, sizeof(read));
+				if (len != MIN(int(sizeof(read)), loose.size() - ofs) || memcmp(read, loose.ptr() + ofs, len) != 0) {
+					mismatches++;
+				}
+			}
+			f->seek(loose.size() - 1);
+			if (f->get_8() != loose[loose.size() - 1])
+				mismatches++;
+			memdelete(f);
+		}
+
+		CHECK(mismatches == 0);
+	}
+
+	return true;
+}
+
+// Cuts the end off a pack, as an interrupted download or copy would, and
+// reads the file that now runs past it.
+
+bool test_truncated() {
+
+	OS::get_singleton()->print("\n\nTest 4: Reading a file past the end of a truncated pack\n");
+
+	String dir = _get_test_dir();
+
+	String src = dir.plus_file("truncated.bin");
+	FileAccess *f = FileAccess::open(src, FileAccess::WRITE);
+	CHECK(f);
+	for (int i = 0; i < 4096; i++) {
+		f->store_8(i % 251);
+	}
+	memdelete(f);
+
+	String pck_path = dir.plus_file("truncated.pck");
+	Ref<PCKPacker> packer;
+	packer.instance();
+	packer->pck_start(pck_path, 0);
+	packer->add_file("res://godot_test_truncated/truncated.bin", src);
+	packer->flush();
+
+	Vector<uint8_t> contents = FileAccess::get_file_as_array(pck_path);
+	CHECK(contents.size() > 2048);
+	f = FileAccess::open(pck_path, FileAccess::WRITE);
+	CHECK(f);
+	f->store_buffer(contents.ptr(), contents.size() - 2048);
+	memdelete(f);
+
+	CHECK(PackedData::get_singleton()->add_pack(pck_path) == OK);
+
+	f = FileAccess::open("res://godot_test_truncated/truncated.bin", FileAccess::READ);
+	CHECK(f);
+	uint8_t read[4096];
+	int len = f->get_buffer(read, sizeof(read));
+	memdelete(f);
+
+	//only what is left of the file is read
+	OS::get_singleton()->print("\tread %i of 4096 bytes\n", len);
+	CHECK(len > 0 && len <= 4096 - 2048);
+	for (int i = 0; i < len; i++) {
+		CHECK(read[i] == i % 251);
+	}
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_read,
+	test_mount,
+	test_compression,
+	test_truncated,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+}
@@ -0,0 +1,608 @@
+/*************************************************************************/
+/*  test_process.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_process.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "scene/3d/mesh_instance.h"
+#include "scene/gui/option_button.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/mesh.h"
+#include "scene/resources/packed_scene.h"
+#include "test_macros.h"
+
+namespace TestProcess {
+
+enum {
+	NODE_COUNT = 100000,
+	INSTANCE_COUNT = 50000,
+	FRAMES = 100,
+	WIDE_COUNT = 5000,
+	DEEP_COUNT = 16,
+	LOOKUPS = 100000,
+	SCENE_NODES = 200,
+	SCENE_INSTANCES = 500,
+	PREPARE_TIMEOUT_MSEC = 30000,
+	SPAWN_NODES = 10,
+	SPAWN_CYCLES = 20000,
+	GROUP_NODES = 10000,
+	GROUP_CALLS = 100
+};
+
+class ProcessNode : public Node {
+
+	GDCLASS(ProcessNode, Node);
+
+public:
+	uint32_t frames;
+	real_t value;
+
+	void _notification(int p_what) {
+
+		if (p_what == NOTIFICATION_PROCESS) {
+			//some arithmetic, so the callback is not free
+			value = Math::sin(value + get_process_delta_time()) * 0.5 + value * 0.5;
+			frames++;
+		}
+	}
+
+	ProcessNode() {
+		frames = 0;
+		value = 0;
+	}
+};
+
+class TransformNode : public Spatial {
+
+	GDCLASS(TransformNode, Spatial);
+
+public:
+	int changes;
+	Spatial *move_on_change; //moved from inside the notification, like a script following another node would
+
+	void _notification(int p_what) {
+
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			changes++;
+			if (move_on_change)
+				move_on_change->translate(Vector3(1, 0, 0));
+		}
+	}
+
+	TransformNode() {
+		changes = 0;
+		move_on_change = NULL;
+		set_notify_transform(true);
+	}
+};
+
+// measured over the first frames by TestMainLoop, reported by the tests below
+static bool frames_processed = false;
+static uint64_t serial_usec = 0;
+static uint64_t threaded_usec = 0;
+static uint64_t move_once_usec = 0;
+static uint64_t move_often_usec = 0;
+static Spatial *instance_parent = NULL;
+
+bool test_process_nodes() {
+
+	OS::get_singleton()->print("\n\nTest 1: Processing %i nodes\n", int(NODE_COUNT));
+	OS::get_singleton()->print("\t%i usec per frame, %i usec per frame with thread safe nodes (%i threads)\n", int(serial_usec / FRAMES), int(threaded_usec / FRAMES), OS::get_singleton()->get_processor_count());
+
+	CHECK(frames_processed);
+
+	return true;
+}
+
+bool test_move_instances() {
+
+	OS::get_singleton()->print("\n\nTest 2: Moving the parent of %i visual instances\n", int(INSTANCE_COUNT));
+	OS::get_singleton()->print("\t%i usec per frame moving the parent once, %i usec moving it 4 times\n", int(move_once_usec / (FRAMES / 2)), int(move_often_usec / (FRAMES / 2)));
+
+	CHECK(instance_parent && instance_parent->get_child_count() == INSTANCE_COUNT);
+
+	//the server must have every batched transform, look some instances up where the scene has them
+	RID scenario = instance_parent->get_world()->get_scenario();
+	for (int i = 0; i < INSTANCE_COUNT; i += INSTANCE_COUNT / 100) {
+		MeshInstance *mi = Object::cast_to<MeshInstance>(instance_parent->get_child(i));
+		Vector<ObjectID> found = VS::get_singleton()->instances_cull_aabb(AABB(mi->get_global_transform().origin - Vector3(0.01, 0.01, 0.01), Vector3(0.02, 0.02, 0.02)), scenario);
+		CHECK(found.find(mi->get_instance_id()) >= 0);
+	}
+
+	return true;
+}
+
+bool test_moves_per_frame() {
+
+	OS::get_singleton()->print("\n\nTest 3: Moving a node twice in one frame\n");
+
+	SceneTree *tree = SceneTree::get_singleton();
+
+	TransformNode *leader = memnew(TransformNode);
+	TransformNode *follower = memnew(TransformNode);
+	TransformNode *child = memnew(TransformNode);
+	TransformNode *bystander = memnew(TransformNode);
+	tree->get_root()->add_child(leader);
+	tree->get_root()->add_child(bystander);
+	tree->get_root()->add_child(follower);
+	follower->add_child(child);
+	tree->flush_transform_notifications();
+
+	// freed at the end of the frame, whatever the result
+	leader->queue_delete();
+	bystander->queue_delete();
+	follower->queue_delete();
+
+	//the follower is moved while notifications are flushed, and queued behind the bystander so it is
+	//notified in the same flush. then it is moved again by the game before the next flush
+	leader->move_on_change = follower;
+	leader->translate(Vector3(0, 1, 0));
+	bystander->translate(Vector3(0, 1, 0));
+	tree->flush_transform_notifications();
+	int follower_changes = follower->changes;
+	int child_changes = child->changes;
+
+	follower->translate(Vector3(0, 0, 1));
+	tree->flush_transform_notifications();
+	CHECK(follower->changes == follower_changes + 1 && child->changes == child_changes + 1);
+
+	//several moves between flushes notify once
+	leader->move_on_change = NULL;
+	follower->translate(Vector3(0, 0, 1));
+	follower->translate(Vector3(0, 0, 1));
+	tree->flush_transform_notifications();
+	CHECK(follower->changes == follower_changes + 2 && child->changes == child_changes + 2);
+
+	CHECK(follower->get_global_transform().origin == Vector3(1, 0, 3));
+
+	return true;
+}
+
+bool test_get_node() {
+
+	OS::get_singleton()->print("\n\nTest 4: Resolving paths among %i siblings and %i levels deep\n", int(WIDE_COUNT), int(DEEP_COUNT));
+
+	SceneTree *tree = SceneTree::get_singleton();
+
+	Node *wide = memnew(Node);
+	wide->set_name("Wide");
+	tree->get_root()->add_child(wide);
+
+	for (int i = 0; i < WIDE_COUNT; i++) {
+		Node *n = memnew(Node);
+		n->set_name("Child" + itos(i));
+		wide->add_child(n);
+	}
+
+	Node *deep = memnew(Node);
+	deep->set_name("Deep");
+	tree->get_root()->add_child(deep);
+
+	wide->queue_delete();
+	deep->queue_delete();
+
+	String deep_path;
+	Node *last = deep;
+	for (int i = 0; i < DEEP_COUNT; i++) {
+		Node *n = memnew(Node);
+		n->set_name("Level" + itos(i));
+		last->add_child(n);
+		last = n;
+		deep_path += (i > 0 ? "/" : "") + n->get_name();
+	}
+
+	NodePath wide_path = "Child" + itos(WIDE_COUNT - 1);
+	Node *expected = wide->get_child(WIDE_COUNT - 1);
+
+	int found = 0;
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < LOOKUPS; i++) {
+		if (wide->get_node_or_null(wide_path) == expected)
+			found++;
+	}
+	uint64_t wide_usec = OS::get_singleton()->get_ticks_usec() - t;
+	CHECK(found == LOOKUPS);
+
+	found = 0;
+	NodePath path = deep_path;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < LOOKUPS; i++) {
+		if (deep->get_node_or_null(path) == last)
+			found++;
+	}
+	uint64_t deep_usec = OS::get_singleton()->get_ticks_usec() - t;
+	CHECK(found == LOOKUPS);
+
+	OS::get_singleton()->print("\t%i usec for %i wide lookups, %i usec for %i deep lookups\n", int(wide_usec), int(LOOKUPS), int(deep_usec), int(LOOKUPS));
+
+	//results must follow changes to the tree
+	expected->set_name("Renamed");
+	CHECK(wide->get_node_or_null(wide_path) == NULL && wide->get_node_or_null(NodePath("Renamed")) == expected);
+
+	last->get_parent()->set_name("Moved");
+	CHECK(deep->get_node_or_null(path) == NULL);
+
+	Node *parent = last->get_parent();
+	NodePath moved_path = deep_path.get_base_dir().get_base_dir() + "/Moved/" + last->get_name();
+	parent->remove_child(last);
+	CHECK(deep->get_node_or_null(moved_path) == NULL);
+	parent->add_child(last);
+	CHECK(deep->get_node_or_null(moved_path) == last);
+
+	return true;
+}
+
+bool test_instance() {
+
+	OS::get_singleton()->print("\n\nTest 5: Instancing a scene of %i nodes %i times\n", int(SCENE_NODES), int(SCENE_INSTANCES));
+
+	SceneTree *tree = SceneTree::get_singleton();
+
+	Node *scene_root = memnew(Spatial);
+	for (int i = 1; i < SCENE_NODES; i++) {
+		Spatial *n = memnew(Spatial);
+		n->set_name("Node" + itos(i));
+		n->set_translation(Vector3(i, 0, 0));
+		scene_root->add_child(n);
+		n->set_owner(scene_root);
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	scene->pack(scene_root);
+	memdelete(scene_root);
+
+	Node *spawn_parent = memnew(Node);
+	tree->get_root()->add_child(spawn_parent);
+	spawn_parent->queue_delete();
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SCENE_INSTANCES; i++) {
+		spawn_parent->add_child(scene->instance());
+	}
+	uint64_t instance_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	//build the instances in a thread, then only adding them to the tree is left
+	scene->prepare_instances(SCENE_INSTANCES);
+	uint64_t wait_start = OS::get_singleton()->get_ticks_msec();
+	while (scene->get_prepared_instance_count() < SCENE_INSTANCES) {
+		CHECK(OS::get_singleton()->get_ticks_msec() - wait_start <= PREPARE_TIMEOUT_MSEC);
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SCENE_INSTANCES; i++) {
+		spawn_parent->add_child(scene->instance());
+	}
+	uint64_t prepared_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i usec with instance(), %i usec with prepared instances\n", int(instance_usec), int(prepared_usec));
+
+	for (int i = 0; i < spawn_parent->get_child_count(); i++) {
+		CHECK(spawn_parent->get_child(i)->get_child_count() == SCENE_NODES - 1);
+	}
+
+	return true;
+}
+
+bool test_pool() {
+
+	OS::get_singleton()->print("\n\nTest 6: Spawning and freeing a scene of %i nodes %i times\n", int(SPAWN_NODES), int(SPAWN_CYCLES));
+
+	SceneTree *tree = SceneTree::get_singleton();
+
+	Spatial *scene_root = memnew(Spatial);
+	for (int i = 1; i < SPAWN_NODES; i++) {
+		Spatial *n = memnew(Spatial);
+		n->set_name("Node" + itos(i));
+		scene_root->add_child(n);
+		n->set_owner(scene_root);
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	scene->pack(scene_root);
+	scene->set_path("res://test_recycle.tscn"); //instances are recognized by their filename
+	memdelete(scene_root);
+
+	Node *spawn_parent = memnew(Node);
+	tree->get_root()->add_child(spawn_parent);
+	spawn_parent->queue_delete();
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SPAWN_CYCLES; i++) {
+		Spatial *s = Object::cast_to<Spatial>(scene->instance());
+		spawn_parent->add_child(s);
+		s->set_translation(Vector3(i, 0, 0));
+		memdelete(s);
+	}
+	uint64_t spawn_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	int reset = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SPAWN_CYCLES; i++) {
+		Spatial *s = Object::cast_to<Spatial>(scene->instance());
+		spawn_parent->add_child(s);
+		if (s->get_translation() == Vector3())
+			reset++; //recycled instances must be back to the packed state
+		s->set_translation(Vector3(i, 0, 0));
+		scene->recycle_instance(s);
+	}
+	uint64_t pool_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i usec freeing instances, %i usec recycling them\n", int(spawn_usec), int(pool_usec));
+
+	CHECK(reset == SPAWN_CYCLES);
+	CHECK(scene->get_recycled_instance_count() == 1 && spawn_parent->get_child_count() == 0);
+
+	//runtime connections and groups are dropped, so _ready() can add them again
+	Node *s = scene->instance();
+	spawn_parent->add_child(s);
+	s->add_to_group("spawned");
+	s->connect("tree_exiting", spawn_parent, "queue_delete");
+	CHECK(scene->recycle_instance(s));
+	CHECK(!s->is_in_group("spawned") && !s->is_connected("tree_exiting", spawn_parent, "queue_delete"));
+
+	//an instance missing nodes of the scene is refused, and left to the caller
+	s = scene->instance();
+	memdelete(s->get_child(0));
+	bool recycled = scene->recycle_instance(s);
+	memdelete(s);
+	CHECK(!recycled && scene->get_recycled_instance_count() == 0);
+
+	//as is a node that isn't an instance of the scene
+	s = memnew(Spatial);
+	recycled = scene->recycle_instance(s);
+	memdelete(s);
+	CHECK(!recycled);
+
+	//instances freed while waiting are skipped
+	s = scene->instance();
+	scene->recycle_instance(s);
+	memdelete(s);
+	s = scene->instance();
+	CHECK(s);
+	int children = s->get_child_count();
+	memdelete(s);
+	CHECK(children == SPAWN_NODES - 1);
+
+	//as are instances put back in a tree by the caller
+	s = scene->instance();
+	scene->recycle_instance(s);
+	spawn_parent->add_child(s);
+	Node *taken = scene->instance();
+	CHECK(taken != s);
+	memdelete(taken);
+
+	//what nodes connect in their constructor is kept, only what was added later is dropped
+	Node *ui_root = memnew(Node);
+	OptionButton *option = memnew(OptionButton);
+	option->set_name("Option");
+	ui_root->add_child(option);
+	option->set_owner(ui_root);
+
+	Ref<PackedScene> ui_scene;
+	ui_scene.instance();
+	ui_scene->pack(ui_root);
+	ui_scene->set_path("res://test_recycle_ui.tscn");
+	memdelete(ui_root);
+
+	s = ui_scene->instance();
+	spawn_parent->add_child(s);
+	option = Object::cast_to<OptionButton>(s->get_node(NodePath("Option")));
+	option->get_popup()->connect("id_pressed", spawn_parent, "queue_delete");
+	option->set_process(true);
+	CHECK(ui_scene->recycle_instance(s));
+	CHECK(option->get_popup()->is_connected("id_pressed", option, "_selected"));
+	CHECK(!option->get_popup()->is_connected("id_pressed", spawn_parent, "queue_delete"));
+	CHECK(!option->is_processing() && !option->is_in_group("idle_process"));
+	memdelete(s);
+
+	return true;
+}
+
+bool test_groups() {
+
+	OS::get_singleton()->print("\n\nTest 7: Calling a group of %i nodes while nodes join it\n", int(GROUP_NODES));
+
+	SceneTree *tree = SceneTree::get_singleton();
+
+	Node *group_parent = memnew(Node);
+	tree->get_root()->add_child(group_parent);
+	group_parent->queue_delete();
+
+	for (int i = 0; i < GROUP_NODES; i++) {
+		ProcessNode *n = memnew(ProcessNode);
+		n->add_to_group("units");
+		group_parent->add_child(n);
+	}
+
+	//a node joins in the middle of the tree before each call
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < GROUP_CALLS; i++) {
+		ProcessNode *n = memnew(ProcessNode);
+		n->add_to_group("units");
+		group_parent->get_child(i * 37)->add_child(n);
+		tree->call_group_flags(SceneTree::GROUP_CALL_REALTIME, "units", "set_process_priority", 0);
+	}
+	uint64_t call_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i usec per call\n", int(call_usec / GROUP_CALLS));
+
+	List<Node *> nodes;
+	tree->get_nodes_in_group("units", &nodes);
+	CHECK(nodes.size() == GROUP_NODES + GROUP_CALLS);
+	for (List<Node *>::Element *E = nodes.front(); E && E->next(); E = E->next()) {
+		CHECK(!E->get()->is_greater_than(E->next()->get()));
+	}
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_process_nodes,
+	test_move_instances,
+	test_moves_per_frame,
+	test_get_node,
+	test_instance,
+	test_pool,
+	test_groups,
+	0
+
+};
+
+// processes and moves nodes for a few hundred frames, then runs the tests
+class TestMainLoop : public SceneTree {
+
+	Node *process_parent;
+	Vector<ProcessNode *> process_nodes;
+	int frame;
+
+	bool _check_frames(uint32_t p_expected) {
+
+		for (int i = 0; i < process_nodes.size(); i++) {
+			if (process_nodes[i]->frames != p_expected)
+				return false;
+		}
+		return true;
+	}
+
+public:
+	virtual void request_quit() {
+
+		quit();
+	}
+
+	virtual void init() {
+
+		SceneTree::init();
+
+		process_parent = memnew(Node);
+		get_root()->add_child(process_parent);
+
+		for (int i = 0; i < NODE_COUNT; i++) {
+
+			ProcessNode *n = memnew(ProcessNode);
+			n->set_process_priority(i % 4);
+			n->set_process(true);
+			process_parent->add_child(n);
+			process_nodes.push_back(n);
+		}
+
+		frame = 0;
+		instance_parent = NULL;
+	}
+
+	void _create_instances() {
+
+		instance_parent = memnew(Spatial);
+		get_root()->add_child(instance_parent);
+
+		//a tiny custom AABB makes each instance findable where the server has it
+		Ref<ArrayMesh> mesh;
+		mesh.instance();
+
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+
+			MeshInstance *mi = memnew(MeshInstance);
+			mi->set_mesh(mesh);
+			mi->set_custom_aabb(AABB(Vector3(-0.001, -0.001, -0.001), Vector3(0.002, 0.002, 0.002)));
+			mi->set_translation(Vector3(i % 100, i / 100, 0));
+			instance_parent->add_child(mi);
+		}
+
+		flush_transform_notifications();
+	}
+
+	virtual bool idle(float p_time) {
+
+		if (frame == FRAMES) {
+			for (int i = 0; i < process_nodes.size(); i++) {
+				process_nodes[i]->set_process_thread_safe(true);
+			}
+		}
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		bool ret = SceneTree::idle(p_time);
+		t = OS::get_singleton()->get_ticks_usec() - t;
+
+		if (frame < FRAMES)
+			serial_usec += t;
+		else
+			threaded_usec += t;
+
+		frame++;
+
+		if (frame == FRAMES * 2) {
+
+			frames_processed = _check_frames(FRAMES * 2);
+
+			process_parent->queue_delete();
+			process_nodes.clear();
+			_create_instances();
+		}
+
+		if (instance_parent) {
+
+			//moving several times per frame walks the children only once, and sends all instance transforms as one command
+			bool often = frame > FRAMES * 2 + FRAMES / 2;
+			t = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < (often ? 4 : 1); i++) {
+				instance_parent->rotate_y(0.01);
+			}
+			flush_transform_notifications();
+			t = OS::get_singleton()->get_ticks_usec() - t;
+
+			if (often)
+				move_often_usec += t;
+			else
+				move_once_usec += t;
+		}
+
+		if (frame == FRAMES * 3) {
+
+			run_test_funcs(test_funcs);
+			return true;
+		}
+
+		return ret;
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(TestMainLoop);
+}
+} // namespace TestProcess
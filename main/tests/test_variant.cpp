@@ -0,0 +1,733 @@
+/*************************************************************************/
+/*  test_variant.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_variant.h"
+
+#include "core/compact_ordered_hash_map.h"
+#include "core/io/marshalls.h"
+#include "core/math/math_funcs.h"
+#include "core/ordered_hash_map.h"
+#include "core/os/file_access.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/variant.h"
+#include "core/variant_parser.h"
+#include "core/vector.h"
+#include "test_macros.h"
+
+namespace TestVariant {
+
+bool test_move_string() {
+
+	OS::get_singleton()->print("\n\nTest 1: String move\n");
+
+	String a = "Godot";
+	const CharType *buf = a.ptr();
+
+	String b = MOVE(a);
+	CHECK(b == "Godot");
+	CHECK(b.ptr() == buf); // no copy, same buffer
+	CHECK(a.empty());
+
+	String c;
+	c = MOVE(b);
+	CHECK(c == "Godot");
+	CHECK(b.empty());
+
+	return true;
+}
+
+bool test_move_vector() {
+
+	OS::get_singleton()->print("\n\nTest 2: Vector move, push_back and emplace\n");
+
+	Vector<String> v;
+	String s = "moved";
+	v.push_back(MOVE(s));
+	CHECK(s.empty());
+	CHECK(v.size() == 1 && v[0] == "moved");
+
+	v.emplace_back("emplaced");
+	CHECK(v.size() == 2 && v[1] == "emplaced");
+
+	v.emplace(0, "first");
+	CHECK(v.size() == 3 && v[0] == "first" && v[1] == "moved" && v[2] == "emplaced");
+
+	v.insert(1, v[2]); // insert aliasing an element
+	CHECK(v.size() == 4 && v[1] == "emplaced" && v[3] == "emplaced");
+
+	v.remove(0);
+	CHECK(v.size() == 3 && v[0] == "emplaced" && v[1] == "moved");
+
+	const String *buf = v.ptr();
+	Vector<String> w = MOVE(v);
+	CHECK(w.ptr() == buf);
+	CHECK(v.empty());
+
+	return true;
+}
+
+bool test_move_variant() {
+
+	OS::get_singleton()->print("\n\nTest 3: Variant, Array and Dictionary move\n");
+
+	Array arr;
+	arr.push_back(1);
+	arr.push_back("two");
+
+	Variant va = arr;
+	Variant vb = MOVE(va);
+	CHECK(va.get_type() == Variant::NIL);
+	CHECK(vb.get_type() == Variant::ARRAY);
+	CHECK(Array(vb) == arr); // arrays compare by reference
+
+	Variant vc = Transform(Basis(), Vector3(1, 2, 3));
+	vc = MOVE(vb);
+	CHECK(vb.get_type() == Variant::NIL);
+	CHECK(vc.get_type() == Variant::ARRAY);
+
+	// assigning an element of the array to the variant holding it
+	Variant vd = arr;
+	vd = MOVE(arr[1]);
+	CHECK(vd == Variant("two"));
+
+	Dictionary d;
+	d["key"] = "value";
+	Variant ve = MOVE(d);
+	CHECK(Dictionary(ve).size() == 1);
+
+	Dictionary e;
+	e = Dictionary(ve);
+	CHECK(e["key"] == Variant("value"));
+
+	// moved-from containers are empty and still usable
+	Array f = MOVE(arr);
+	CHECK(f.size() == 2);
+	CHECK(arr.size() == 0);
+	arr.push_back(3);
+	CHECK(arr.size() == 1 && f.size() == 2);
+
+	Dictionary g = MOVE(e);
+	CHECK(g.size() == 1);
+	CHECK(e.empty());
+	e["other"] = 1;
+	CHECK(e.size() == 1 && !g.has("other"));
+
+	// move assignment doesn't hand the target's old contents to the source
+	f = MOVE(arr);
+	CHECK(f.size() == 1 && arr.empty());
+	g = MOVE(e);
+	CHECK(g.has("other") && e.empty());
+	Array h = arr;
+	h.push_back(4);
+	CHECK(h.size() == 1 && arr.empty());
+
+	return true;
+}
+
+bool test_move_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 4: Copy vs. move benchmark\n");
+
+	const int count = 1000000;
+	String s = "benchmark string";
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	{
+		Vector<Variant> v;
+		for (int i = 0; i < count; i++) {
+			Variant tmp = s;
+			v.push_back(tmp);
+		}
+	}
+	uint64_t copy_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	{
+		Vector<Variant> v;
+		for (int i = 0; i < count; i++) {
+			Variant tmp = s;
+			v.push_back(MOVE(tmp));
+		}
+	}
+	uint64_t move_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i push_back: copy %i usec, move %i usec\n", count, (int)copy_time, (int)move_time);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	{
+		Variant a = s;
+		Variant b;
+		for (int i = 0; i < count; i++) {
+			b = a;
+			a = b;
+		}
+	}
+	copy_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	{
+		Variant a = s;
+		Variant b;
+		for (int i = 0; i < count; i++) {
+			b = MOVE(a);
+			a = MOVE(b);
+		}
+	}
+	move_time = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\t%i Variant assignments: copy %i usec, move %i usec\n", count * 2, (int)copy_time, (int)move_time);
+
+	return true;
+}
+
+bool test_dictionary() {
+
+	OS::get_singleton()->print("\n\nTest 5: Dictionary order, erase and lookup\n");
+
+	Dictionary d;
+	CHECK(d.empty());
+	CHECK(d.next(NULL) == NULL);
+
+	for (int i = 0; i < 1000; i++) {
+		d[i] = i * 2;
+	}
+	d["key"] = "value";
+	CHECK(d.size() == 1001);
+	CHECK(d.has("key") && String(d["key"]) == "value");
+	CHECK(int(d[500]) == 1000);
+	CHECK(d.getptr(5000) == NULL);
+
+	// erase most of it, pointers to the remaining values stay valid
+	Variant *kept = d.getptr(503);
+	CHECK(kept && int(*kept) == 1006);
+	for (int i = 0; i < 1000; i++) {
+		if (i % 10 != 3) {
+			CHECK(d.erase(i));
+		}
+	}
+	CHECK(!d.erase(0));
+	CHECK(d.size() == 101);
+	CHECK(d.getptr(503) == kept && int(*kept) == 1006);
+
+	// insertion order is kept, and reinserted keys go last
+	d[0] = "again";
+	Array keys = d.keys();
+	CHECK(keys.size() == 102);
+	for (int i = 0; i < 100; i++) {
+		CHECK(int(keys[i]) == i * 10 + 3);
+		CHECK(int(d.get_value_at_index(i)) == (i * 10 + 3) * 2);
+	}
+	CHECK(String(keys[100]) == "key");
+	CHECK(int(keys[101]) == 0);
+	CHECK(d.get_key_at_index(102).get_type() == Variant::NIL);
+
+	int count = 0;
+	for (const Variant *k = d.next(NULL); k; k = d.next(k)) {
+		CHECK(*k == keys[count]);
+		count++;
+	}
+	CHECK(count == 102);
+
+	Dictionary dup = d.duplicate();
+	CHECK(dup.size() == d.size() && dup.hash() == d.hash());
+
+	d.clear();
+	CHECK(d.empty() && d.next(NULL) == NULL);
+	d["x"] = 1;
+	CHECK(d.size() == 1 && int(d["x"]) == 1);
+
+	// insertions never move the other values, even with holes left by erasing
+	CompactOrderedHashMap<int, int> churn;
+	churn.insert(-1, -1);
+	int *first = churn.getptr(-1);
+	for (int i = 0; i < 100000; i++) {
+		churn.insert(i, i);
+		if (i >= 16) {
+			CHECK(churn.erase(i - 16));
+		}
+	}
+	CHECK(churn.size() == 17);
+	CHECK(churn.getptr(-1) == first && *first == -1);
+	CHECK(churn[99999] == 99999 && !churn.has(99983));
+
+	// until the holes are compacted explicitly
+	churn.compact();
+	CHECK(churn.get_memory_usage() < 4096);
+	CHECK(churn.size() == 17 && churn[-1] == -1 && churn[99990] == 99990);
+	int order = 0;
+	for (int i = churn.next_pos(-1); i >= 0; i = churn.next_pos(i)) {
+		CHECK(churn.key_at(i) == (order == 0 ? -1 : 99983 + order));
+		order++;
+	}
+
+	return true;
+}
+
+bool test_dictionary_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 6: Dictionary memory and speed\n");
+
+	const int count = 200000;
+
+	uint64_t mem = Memory::get_mem_usage();
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	{
+		OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> map;
+		for (int i = 0; i < count; i++) {
+			map[i] = i;
+		}
+		uint64_t insert_time = OS::get_singleton()->get_ticks_usec() - t;
+		uint64_t used = Memory::get_mem_usage() - mem;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		int found = 0;
+		for (int i = 0; i < count * 2; i++) {
+			found += map.has(i);
+		}
+		CHECK(found == count);
+		uint64_t lookup_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("\tOrderedHashMap: %i bytes per element, insert %i usec, lookup %i usec\n", int(used / count), (int)insert_time, (int)lookup_time);
+	}
+
+	mem = Memory::get_mem_usage();
+	t = OS::get_singleton()->get_ticks_usec();
+	{
+		CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> map;
+		for (int i = 0; i < count; i++) {
+			map[i] = i;
+		}
+		uint64_t insert_time = OS::get_singleton()->get_ticks_usec() - t;
+		uint64_t used = Memory::get_mem_usage() - mem;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		int found = 0;
+		for (int i = 0; i < count * 2; i++) {
+			found += map.has(i);
+		}
+		CHECK(found == count);
+		uint64_t lookup_time = OS::get_singleton()->get_ticks_usec() - t;
+
+		OS::get_singleton()->print("\tCompactOrderedHashMap: %i bytes per element, insert %i usec, lookup %i usec\n", int(used / count), (int)insert_time, (int)lookup_time);
+	}
+
+	return true;
+}
+
+bool test_packed_array() {
+
+	OS::get_singleton()->print("\n\nTest 7: Array of numbers packing and unpacking\n");
+
+	Array a;
+	for (int i = 0; i < 10; i++) {
+		a.push_back(i);
+	}
+	a.insert(0, 100);
+	a.push_front(200);
+	CHECK(a.size() == 12);
+	CHECK(int(a.get_value(0)) == 200 && int(a.get_value(1)) == 100 && int(a.get_value(11)) == 9);
+	CHECK(a.find(5) == 7 && a.find(5.0) == -1 && a.rfind(3) == 5 && a.count(9) == 1);
+	CHECK(a.has(100) && !a.has(Vector2()));
+
+	a.sort();
+	CHECK(int(a.front()) == 0 && int(a.back()) == 200);
+	CHECK(a.bsearch(5) == 5);
+	a.invert();
+	CHECK(int(a.front()) == 200);
+	a.erase(200);
+	CHECK(a.size() == 11 && int(a.pop_front()) == 100 && int(a.pop_back()) == 0);
+
+	Array b = a.duplicate();
+	CHECK(b.size() == 9 && b.hash() == a.hash());
+	b.set(0, 7);
+	CHECK(int(b.get_value(0)) == 7 && int(a.get_value(0)) == 9);
+
+	// a different type unpacks, the values stay the same
+	a.push_back("string");
+	CHECK(a.size() == 10 && int(a[0]) == 9 && String(a[9]) == "string");
+
+	// so does a reference
+	Variant &ref = b[1];
+	ref = Vector3(1, 2, 3);
+	CHECK(Vector3(b.get_value(1)) == Vector3(1, 2, 3));
+	CHECK(b.get_value(1) == b[1]);
+
+	// get_value() reads in place, a const reference unpacks for good and stays valid across writes
+	Array c;
+	c.push_back(1.5);
+	c.push_back(2.5);
+	CHECK(double(c.get_value(1)) == 2.5);
+	const Array &cc = c;
+	const Variant &elem = cc[1];
+	CHECK(double(elem) == 2.5);
+	c.set(1, 3.5);
+	CHECK(double(elem) == 3.5 && c.find(3.5) == 1);
+	c.push_back("string");
+	CHECK(double(c[0]) == 1.5 && double(c[1]) == 3.5 && c.size() == 3);
+
+	Array v;
+	v.push_back(Vector2(3, 1));
+	v.push_back(Vector2(1, 2));
+	v.sort();
+	CHECK(Vector2(v[0]) == Vector2(1, 2));
+
+	return true;
+}
+
+bool test_packed_array_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 8: Array of numbers, packed vs. Variant\n");
+
+	const int count = 1000000;
+	const char *names[2] = { "packed", "Variant" };
+
+	for (int pass = 0; pass < 2; pass++) {
+
+		uint64_t mem = Memory::get_mem_usage();
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		Array a;
+		if (pass == 1) {
+			a.push_back(Variant()); // a null first keeps the numbers boxed
+		}
+		for (int i = 0; i < count; i++) {
+			a.push_back(real_t((i * 37) % count));
+		}
+		uint64_t append_time = OS::get_singleton()->get_ticks_usec() - t;
+		uint64_t used = Memory::get_mem_usage() - mem;
+
+		t = OS::get_singleton()->get_ticks_usec();
+		real_t sum = 0;
+		for (int i = pass; i < a.size(); i++) {
+			sum += real_t(a.get_value(i));
+		}
+		uint64_t iterate_time = OS::get_singleton()->get_ticks_usec() - t;
+		CHECK(sum > 0);
+
+		if (pass == 1) {
+			a.remove(0);
+		}
+
+		t = OS::get_singleton()->get_ticks_usec();
+		a.sort();
+		uint64_t sort_time = OS::get_singleton()->get_ticks_usec() - t;
+		CHECK(real_t(a.get_value(0)) == 0 && real_t(a.get_value(count - 1)) == count - 1);
+
+		OS::get_singleton()->print("\t%s: %i bytes per element, append %i usec, iterate %i usec, sort %i usec\n", names[pass], int(used / count), (int)append_time, (int)iterate_time, (int)sort_time);
+	}
+
+	return true;
+}
+
+static Error _parse_string(const String &p_text, Variant &r_value) {
+
+	VariantParser::StreamString ss;
+	ss.s = p_text;
+	String err;
+	int line;
+	return VariantParser::parse(&ss, r_value, err, line);
+}
+
+bool test_parser_numbers() {
+
+	OS::get_singleton()->print("\n\nTest 9: Text parser, numbers in packed arrays\n");
+
+	// the same numbers as packed array and as a regular array, which goes through get_token()
+	uint64_t seed = 3;
+	String numbers;
+	for (int i = 0; i < 10000; i++) {
+		uint32_t r = Math::rand_from_seed(&seed);
+		double v = (double(r) / 0xFFFFFFFF - 0.5) * Math::pow(10.0, double(int(r % 40) - 20));
+		numbers += (i ? ", " : "") + (i % 3 ? rtoss(v) : String::num_scientific(v));
+	}
+	numbers += ", 0, -0, 1e5, 2.5e-3, -7.0, 123456789012345678, 0.000000000000000000000000000001, 3.4028235e+38";
+
+	Variant packed;
+	Variant regular;
+	CHECK(_parse_string("PoolRealArray( " + numbers + " )", packed) == OK);
+	CHECK(_parse_string("[ " + numbers + " ]", regular) == OK);
+
+	PoolRealArray floats = packed;
+	Array values = regular;
+	CHECK(floats.size() == values.size() && floats.size() == 10008);
+	for (int i = 0; i < floats.size(); i++) {
+		CHECK(floats[i] == real_t(values[i]));
+	}
+
+	Variant ints;
+	CHECK(_parse_string("PoolIntArray(1,-2 , 3\n;comment\n, 2147483647, -2147483648)", ints) == OK);
+	PoolIntArray int_array = ints;
+	CHECK(int_array.size() == 5 && int_array[1] == -2 && int_array[3] == 2147483647 && int_array[4] == -2147483648);
+
+	Variant vectors;
+	CHECK(_parse_string("PoolVector3Array( 1, 2.5, -3e2, 0.125, 0, 1 )", vectors) == OK);
+	PoolVector3Array vector_array = vectors;
+	CHECK(vector_array.size() == 2 && vector_array[0] == Vector3(1, 2.5, -300) && vector_array[1] == Vector3(0.125, 0, 1));
+
+	Variant empty;
+	CHECK(_parse_string("PoolRealArray(  )", empty) == OK && PoolRealArray(empty).size() == 0);
+	CHECK(_parse_string("PoolRealArray( 1, )", empty) != OK);
+	CHECK(_parse_string("PoolRealArray( 1 2 )", empty) != OK);
+	CHECK(_parse_string("PoolRealArray( 1, x )", empty) != OK);
+
+	return true;
+}
+
+bool test_parser_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 10: Text parser throughput\n");
+
+	const int count = 300000;
+
+	// vertex positions, as meshes hold them in text scenes
+	String path = OS::get_singleton()->get_cache_path().plus_file("godot_test_parser.tres");
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+	CHECK(f);
+	String packed_text;
+	String array_text;
+	uint64_t seed = 5;
+	for (int i = 0; i < count * 3; i++) {
+		uint32_t r = Math::rand_from_seed(&seed);
+		String n = rtoss((double(r % 2000000) - 1000000.0) / 1024.0);
+		packed_text += (i ? ", " : "PoolVector3Array( ") + n;
+		array_text += (i ? ", " : "[ ") + n;
+	}
+	packed_text += " )\n";
+	array_text += " ]\n";
+	f->store_string(packed_text + array_text);
+	uint64_t size = f->get_len();
+	memdelete(f);
+
+	f = FileAccess::open(path, FileAccess::READ);
+	CHECK(f);
+
+	// without reading ahead and through get_token(), like before, then with both
+	const char *names[2] = { "unbuffered, array", "buffered, packed array" };
+	for (int pass = 0; pass < 2; pass++) {
+
+		f->seek(pass ? 0 : packed_text.utf8().length());
+		VariantParser::StreamFile stream;
+		stream.f = f;
+		stream.readahead = pass == 1;
+
+		Variant value;
+		String err;
+		int line;
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		CHECK(VariantParser::parse(&stream, value, err, line) == OK);
+		uint64_t parse_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+
+		int parsed = pass ? PoolVector3Array(value).size() * 3 : Array(value).size();
+		CHECK(parsed == count * 3);
+
+		double mb = (pass ? packed_text.length() : array_text.length()) / (1024.0 * 1024.0);
+		OS::get_singleton()->print("\t%s: %.1f MB in %i msec, %.1f MB/s\n", names[pass], mb, int(parse_time / 1000), mb / (parse_time / 1000000.0));
+	}
+
+	memdelete(f);
+	OS::get_singleton()->print("\tfile was %i KiB\n", int(size / 1024));
+
+	return true;
+}
+
+static Vector<uint8_t> _encode(const Variant &p_value) {
+
+	int len;
+	encode_variant(p_value, NULL, len);
+	Vector<uint8_t> data;
+	data.resize(len);
+	encode_variant(p_value, data.ptrw(), len);
+	return data;
+}
+
+bool test_encoding() {
+
+	OS::get_singleton()->print("\n\nTest 11: Binary encoding\n");
+
+	PoolVector<uint8_t> bytes;
+	PoolVector<int> ints;
+	PoolVector<real_t> reals;
+	PoolVector<String> strings;
+	PoolVector<Vector2> vectors2;
+	PoolVector<Vector3> vectors3;
+	PoolVector<Color> colors;
+	for (int i = 0; i < 7; i++) {
+		bytes.push_back(i * 37);
+		ints.push_back(i * -100000);
+		reals.push_back(i * 0.25);
+		strings.push_back(String("abcdefg").substr(0, i));
+		vectors2.push_back(Vector2(i, -i));
+		vectors3.push_back(Vector3(i, i * 0.5, -i));
+		colors.push_back(Color(i * 0.125, 0.5, 1, 0.75));
+	}
+
+	Array values;
+	values.push_back(Variant());
+	values.push_back(true);
+	values.push_back(123);
+	values.push_back(int64_t(1) << 40);
+	values.push_back(0.5);
+	values.push_back(0.1);
+	values.push_back("odd");
+	values.push_back(NodePath("/root/node:property"));
+	values.push_back(Transform(Basis(Vector3(0, 1, 0), 1.0), Vector3(1, 2, 3)));
+	values.push_back(Color(1, 0.5, 0.25));
+	values.push_back(bytes);
+	values.push_back(ints);
+	values.push_back(reals);
+	values.push_back(strings);
+	values.push_back(vectors2);
+	values.push_back(vectors3);
+	values.push_back(colors);
+	Dictionary d;
+	d["values"] = values;
+	d[1] = "one";
+
+	Vector<uint8_t> data = _encode(d);
+
+	// single pass, into a buffer that is too small and at an unaligned offset
+	Vector<uint8_t> grown;
+	grown.resize(5);
+	int ofs = 3;
+	CHECK(encode_variant(d, grown, ofs) == OK);
+	CHECK(ofs == data.size() + 3);
+	CHECK(memcmp(grown.ptr() + 3, data.ptr(), data.size()) == 0);
+
+	// pool arrays keep their layout of little endian words
+	Vector<uint8_t> int_data = _encode(ints);
+	CHECK(int_data.size() == 8 + 7 * 4);
+	CHECK(decode_uint32(&int_data[4]) == 7 && int32_t(decode_uint32(&int_data[8 + 4 * 3])) == -300000);
+	Vector<uint8_t> color_data = _encode(colors);
+	CHECK(decode_float(&color_data[8 + 16 * 2]) == 0.25f && decode_float(&color_data[8 + 16 * 2 + 12]) == 0.75f);
+
+	Variant decoded;
+	int used;
+	CHECK(decode_variant(decoded, data.ptr(), data.size(), &used) == OK);
+	CHECK(used == data.size());
+	Vector<uint8_t> encoded_again = _encode(decoded);
+	CHECK(encoded_again.size() == data.size() && memcmp(encoded_again.ptr(), data.ptr(), data.size()) == 0);
+	Array decoded_values = Dictionary(decoded)["values"];
+	CHECK(decoded_values.size() == values.size());
+	for (int i = 0; i < values.size(); i++) {
+		CHECK(decoded_values[i].get_type() == values[i].get_type());
+	}
+	CHECK(PoolVector<Vector3>(decoded_values[15])[5] == vectors3[5]);
+	CHECK(PoolVector<String>(decoded_values[13]).size() == 7);
+
+	Vector<uint8_t> vector_data = _encode(vectors3);
+	PoolArrayView view;
+	CHECK(decode_pool_array_view(view, vector_data.ptr(), vector_data.size(), &used) == OK);
+	CHECK(view.type == Variant::POOL_VECTOR3_ARRAY && view.count == 7 && used == vector_data.size());
+	CHECK(decode_float(view.data + (5 * 3 + 1) * 4) == 2.5f);
+	CHECK(decode_pool_array_view(view, vector_data.ptr(), vector_data.size() - 1) != OK);
+	CHECK(decode_pool_array_view(view, data.ptr(), data.size()) != OK);
+
+	return true;
+}
+
+bool test_encoding_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 12: Binary encoding throughput\n");
+
+	const int count = 1000000;
+
+	PoolVector<Vector3> vectors;
+	vectors.resize(count);
+	{
+		PoolVector<Vector3>::Write w = vectors.write();
+		for (int i = 0; i < count; i++)
+			w[i] = Vector3(i, i * 0.5, -i);
+	}
+
+	Array players;
+	for (int i = 0; i < count / 10; i++) {
+		Dictionary player;
+		player["id"] = i;
+		player["name"] = "player_" + itos(i);
+		player["position"] = Vector3(i, 0, -i);
+		players.push_back(player);
+	}
+
+	const char *names[2] = { "PoolVector3Array", "Array of Dictionary" };
+	Variant values[2] = { vectors, players };
+
+	Vector<uint8_t> buffer;
+	for (int i = 0; i < 2; i++) {
+
+		// measuring and writing, as before, then in one pass into a reused buffer
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		Vector<uint8_t> data = _encode(values[i]);
+		uint64_t two_pass_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+
+		int len = 0;
+		encode_variant(values[i], buffer, len); // grow it once
+		len = 0;
+		t = OS::get_singleton()->get_ticks_usec();
+		CHECK(encode_variant(values[i], buffer, len) == OK);
+		uint64_t single_pass_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+		CHECK(len == data.size() && memcmp(buffer.ptr(), data.ptr(), len) == 0);
+
+		Variant decoded;
+		t = OS::get_singleton()->get_ticks_usec();
+		CHECK(decode_variant(decoded, data.ptr(), data.size()) == OK);
+		uint64_t decode_time = MAX(OS::get_singleton()->get_ticks_usec() - t, (uint64_t)1);
+
+		double mb = data.size() / (1024.0 * 1024.0);
+		OS::get_singleton()->print("\t%s, %.1f MB: encode %.0f MB/s in two passes, %.0f MB/s in one, decode %.0f MB/s\n", names[i], mb, mb / (two_pass_time / 1000000.0), mb / (single_pass_time / 1000000.0), mb / (decode_time / 1000000.0));
+	}
+
+	return true;
+}
+
+#undef CHECK
+
+TestFunc test_funcs[] = {
+
+	test_move_string,
+	test_move_vector,
+	test_move_variant,
+	test_move_benchmark,
+	test_dictionary,
+	test_dictionary_benchmark,
+	test_packed_array,
+	test_packed_array_benchmark,
+	test_parser_numbers,
+	test_parser_benchmark,
+	test_encoding,
+	test_encoding_benchmark,
+	0
+
+};
+
+MainLoop *test() {
+
+	return run_test_funcs(test_funcs);
+}
+} // namespace TestVariant
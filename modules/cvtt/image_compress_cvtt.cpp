@@ -212,7 +212,9 @@ void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::CompressS
 #ifdef NO_THREADS
 	int num_job_threads = 0;
 #else
-	int num_job_threads = OS::get_singleton()->can_use_threads() ? (OS::get_singleton()->get_processor_count() - 1) : 0;
+	// off the main thread this is likely an import worker, which already has the other cores busy
+	bool use_threads = OS::get_singleton()->can_use_threads() && Thread::get_caller_id() == Thread::get_main_id();
+	int num_job_threads = use_threads ? (OS::get_singleton()->get_processor_count() - 1) : 0;
 #endif
 
 	PoolVector<CVTTCompressionRowTask> tasks;
@@ -34,7 +34,9 @@
 #include "core/image.h"
 #include "core/os/copymem.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/print_string.h"
+#include "core/safe_refcount.h"
 
 static Image::Format _get_etc2_mode(Image::DetectChannels format) {
 	switch (format) {
@@ -57,6 +59,47 @@ static Image::Format _get_etc2_mode(Image::DetectChannels format) {
 	}
 }
 
+struct EtcMipmapTask {
+	const uint8_t *src;
+	int width;
+	int height;
+	unsigned int jobs;
+
+	unsigned char *etc_data;
+	unsigned int etc_data_len;
+};
+
+struct EtcCompressionJobQueue {
+	Etc::Image::Format format;
+	Etc::ErrorMetric error_metric;
+	float effort;
+	EtcMipmapTask *job_tasks;
+	uint32_t num_tasks;
+	uint32_t current_task;
+};
+
+static void _digest_job_queue(void *p_job_queue) {
+	EtcCompressionJobQueue *job_queue = static_cast<EtcCompressionJobQueue *>(p_job_queue);
+
+	for (uint32_t next_task = atomic_increment(&job_queue->current_task); next_task <= job_queue->num_tasks; next_task = atomic_increment(&job_queue->current_task)) {
+		EtcMipmapTask &task = job_queue->job_tasks[next_task - 1];
+
+		// convert source image to internal etc2comp format (which is equivalent to Image::FORMAT_RGBAF)
+		// NOTE: We can alternatively add a case to Image::convert to handle Image::FORMAT_RGBAF conversion.
+		Etc::ColorFloatRGBA *src_rgba_f = new Etc::ColorFloatRGBA[task.width * task.height];
+		for (int j = 0; j < task.width * task.height; j++) {
+			int si = j * 4; // RGBA8
+			src_rgba_f[j] = Etc::ColorFloatRGBA::ConvertFromRGBA8(task.src[si], task.src[si + 1], task.src[si + 2], task.src[si + 3]);
+		}
+
+		unsigned int extended_width = 0, extended_height = 0;
+		int encoding_time = 0;
+		Etc::Encode((float *)src_rgba_f, task.width, task.height, job_queue->format, job_queue->error_metric, job_queue->effort, task.jobs, task.jobs, &task.etc_data, &task.etc_data_len, &extended_width, &extended_height, &encoding_time);
+
+		delete[] src_rgba_f;
+	}
+}
+
 static Etc::Image::Format _image_format_to_etc2comp_format(Image::Format format) {
 	switch (format) {
 		case Image::FORMAT_ETC:
@@ -178,8 +221,8 @@ static void _compress_etc(Image *p_img, float p_lossy_quality, bool force_etc1_f
 	PoolVector<uint8_t>::Write w = dst_data.write();
 
 	// prepare parameters to be passed to etc2comp
-	int num_cpus = OS::get_singleton()->get_processor_count();
-	int encoding_time = 0;
+	// off the main thread this is likely an import worker, which already has the other cores busy
+	int num_cpus = Thread::get_caller_id() == Thread::get_main_id() ? OS::get_singleton()->get_processor_count() : 1;
 	float effort = 0.0; //default, reasonable time
 
 	if (p_lossy_quality > 0.75)
@@ -189,37 +232,65 @@ static void _compress_etc(Image *p_img, float p_lossy_quality, bool force_etc1_f
 	else if (p_lossy_quality > 0.95)
 		effort = 0.8;
 
-	Etc::ErrorMetric error_metric = Etc::ErrorMetric::RGBX; // NOTE: we can experiment with other error metrics
-	Etc::Image::Format etc2comp_etc_format = _image_format_to_etc2comp_format(etc_format);
-
-	int wofs = 0;
+	EtcCompressionJobQueue job_queue;
+	job_queue.error_metric = Etc::ErrorMetric::RGBX; // NOTE: we can experiment with other error metrics
+	job_queue.format = _image_format_to_etc2comp_format(etc_format);
+	job_queue.effort = effort;
 
-	print_verbose("ETC: Begin encoding, format: " + Image::get_format_name(etc_format));
-	uint64_t t = OS::get_singleton()->get_ticks_msec();
+	// mipmaps are encoded concurrently, each one splitting its blocks over
+	// a share of the cores that matches its share of the pixels
+	Vector<EtcMipmapTask> tasks;
+	tasks.resize(mmc);
+	int total_pixels = 0;
 	for (int i = 0; i < mmc; i++) {
-		// convert source image to internal etc2comp format (which is equivalent to Image::FORMAT_RGBAF)
-		// NOTE: We can alternatively add a case to Image::convert to handle Image::FORMAT_RGBAF conversion.
 		int mipmap_ofs = 0, mipmap_size = 0, mipmap_w = 0, mipmap_h = 0;
 		img->get_mipmap_offset_size_and_dimensions(i, mipmap_ofs, mipmap_size, mipmap_w, mipmap_h);
-		const uint8_t *src = &r[mipmap_ofs];
+		EtcMipmapTask &task = tasks.write[i];
+		task.src = &r[mipmap_ofs];
+		task.width = mipmap_w;
+		task.height = mipmap_h;
+		task.etc_data = NULL;
+		task.etc_data_len = 0;
+		total_pixels += mipmap_w * mipmap_h;
+	}
+	for (int i = 0; i < mmc; i++) {
+		EtcMipmapTask &task = tasks.write[i];
+		task.jobs = MAX(1, int(int64_t(num_cpus) * task.width * task.height / total_pixels));
+	}
 
-		Etc::ColorFloatRGBA *src_rgba_f = new Etc::ColorFloatRGBA[mipmap_w * mipmap_h];
-		for (int j = 0; j < mipmap_w * mipmap_h; j++) {
-			int si = j * 4; // RGBA8
-			src_rgba_f[j] = Etc::ColorFloatRGBA::ConvertFromRGBA8(src[si], src[si + 1], src[si + 2], src[si + 3]);
-		}
+	job_queue.job_tasks = tasks.ptrw();
+	job_queue.num_tasks = mmc;
+	job_queue.current_task = 0;
 
-		unsigned char *etc_data = NULL;
-		unsigned int etc_data_len = 0;
-		unsigned int extended_width = 0, extended_height = 0;
-		Etc::Encode((float *)src_rgba_f, mipmap_w, mipmap_h, etc2comp_etc_format, error_metric, effort, num_cpus, num_cpus, &etc_data, &etc_data_len, &extended_width, &extended_height, &encoding_time);
+#ifdef NO_THREADS
+	int num_job_threads = 0;
+#else
+	int num_job_threads = OS::get_singleton()->can_use_threads() ? MIN(num_cpus, mmc) - 1 : 0;
+#endif
 
-		CRASH_COND(wofs + etc_data_len > target_size);
-		memcpy(&w[wofs], etc_data, etc_data_len);
-		wofs += etc_data_len;
+	print_verbose("ETC: Begin encoding, format: " + Image::get_format_name(etc_format));
+	uint64_t t = OS::get_singleton()->get_ticks_msec();
 
-		delete[] etc_data;
-		delete[] src_rgba_f;
+	Vector<Thread *> threads;
+	threads.resize(MAX(num_job_threads, 0));
+	for (int i = 0; i < threads.size(); i++) {
+		threads.write[i] = Thread::create(_digest_job_queue, &job_queue);
+	}
+	_digest_job_queue(&job_queue);
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	int wofs = 0;
+	for (int i = 0; i < mmc; i++) {
+		const EtcMipmapTask &task = tasks[i];
+
+		CRASH_COND(wofs + task.etc_data_len > target_size);
+		memcpy(&w[wofs], task.etc_data, task.etc_data_len);
+		wofs += task.etc_data_len;
+
+		delete[] task.etc_data;
 	}
 
 	print_verbose("ETC: Time encoding: " + rtos(OS::get_singleton()->get_ticks_msec() - t));
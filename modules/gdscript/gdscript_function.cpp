@@ -467,7 +467,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 					OPCODE_BREAK;
 				}
-				*dst = ret;
+				*dst = MOVE(ret);
 #endif
 				ip += 5;
 			}
@@ -605,7 +605,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(src) + "').";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
+				*dst = MOVE(ret);
 #endif
 				ip += 4;
 			}
@@ -666,7 +666,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 					OPCODE_BREAK;
 				}
-				*dst = ret;
+				*dst = MOVE(ret);
 #endif
 				ip += 4;
 			}
@@ -995,17 +995,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				CHECK_SPACE(1);
 				int argc = _code_ptr[ip + 1];
 				Array array; //arrays are always shared
-				array.resize(argc);
 				CHECK_SPACE(argc + 2);
 
+				// pushed one by one, so arrays of numbers can stay packed
 				for (int i = 0; i < argc; i++) {
 					GET_VARIANT_PTR(v, 2 + i);
-					array[i] = *v;
+					array.push_back(*v);
 				}
 
 				GET_VARIANT_PTR(dst, 2 + argc);
 
-				*dst = array;
+				*dst = MOVE(array);
 
 				ip += 3 + argc;
 			}
@@ -1028,7 +1028,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_VARIANT_PTR(dst, 2 + argc * 2);
 
-				*dst = dict;
+				*dst = MOVE(dict);
 
 				ip += 3 + argc * 2;
 			}
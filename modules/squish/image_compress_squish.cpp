@@ -30,6 +30,10 @@
 
 #include "image_compress_squish.h"
 
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
 #include <squish.h>
 
 void image_decompress_squish(Image *p_image) {
@@ -75,6 +79,29 @@ void image_decompress_squish(Image *p_image) {
 }
 
 #ifdef TOOLS_ENABLED
+struct SquishCompressionRowTask {
+	const uint8_t *in_row_bytes;
+	uint8_t *out_row_bytes;
+	int width;
+	int height;
+};
+
+struct SquishCompressionJobQueue {
+	int squish_flags;
+	const SquishCompressionRowTask *job_tasks;
+	uint32_t num_tasks;
+	uint32_t current_task;
+};
+
+static void _digest_job_queue(void *p_job_queue) {
+	SquishCompressionJobQueue *job_queue = static_cast<SquishCompressionJobQueue *>(p_job_queue);
+
+	for (uint32_t next_task = atomic_increment(&job_queue->current_task); next_task <= job_queue->num_tasks; next_task = atomic_increment(&job_queue->current_task)) {
+		const SquishCompressionRowTask &task = job_queue->job_tasks[next_task - 1];
+		squish::CompressImage(task.in_row_bytes, task.width, task.height, task.out_row_bytes, job_queue->squish_flags);
+	}
+}
+
 void image_compress_squish(Image *p_image, float p_lossy_quality, Image::CompressSource p_source) {
 
 	if (p_image->get_format() >= Image::FORMAT_DXT1)
@@ -185,6 +212,11 @@ void image_compress_squish(Image *p_image, float p_lossy_quality, Image::Compres
 		PoolVector<uint8_t>::Write wb = data.write();
 
 		int dst_ofs = 0;
+		int block_size = (squish_comp & (squish::kDxt1 | squish::kBc4)) ? 8 : 16;
+
+		// every row of blocks of every mipmap is a separate task, so the small
+		// mipmaps are compressed alongside the big ones instead of after them
+		Vector<SquishCompressionRowTask> tasks;
 
 		for (int i = 0; i <= mm_count; i++) {
 
@@ -192,12 +224,48 @@ void image_compress_squish(Image *p_image, float p_lossy_quality, Image::Compres
 			int bh = h % 4 != 0 ? h + (4 - h % 4) : h;
 
 			int src_ofs = p_image->get_mipmap_offset(i);
-			squish::CompressImage(&rb[src_ofs], w, h, &wb[dst_ofs], squish_comp);
+
+			for (int y = 0; y < h; y += 4) {
+				SquishCompressionRowTask row_task;
+				row_task.in_row_bytes = &rb[src_ofs + y * w * 4];
+				row_task.out_row_bytes = &wb[dst_ofs + (y / 4) * (bw / 4) * block_size];
+				row_task.width = w;
+				row_task.height = MIN(4, h - y);
+				tasks.push_back(row_task);
+			}
+
 			dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
 			w = MAX(w / 2, 1);
 			h = MAX(h / 2, 1);
 		}
 
+		SquishCompressionJobQueue job_queue;
+		job_queue.squish_flags = squish_comp;
+		job_queue.job_tasks = tasks.ptr();
+		job_queue.num_tasks = tasks.size();
+		job_queue.current_task = 0;
+
+#ifdef NO_THREADS
+		int num_job_threads = 0;
+#else
+		// off the main thread this is likely an import worker, which already has the other cores busy
+		bool use_threads = OS::get_singleton()->can_use_threads() && Thread::get_caller_id() == Thread::get_main_id();
+		int num_job_threads = use_threads ? MIN(OS::get_singleton()->get_processor_count() - 1, tasks.size() - 1) : 0;
+#endif
+
+		Vector<Thread *> threads;
+		threads.resize(MAX(num_job_threads, 0));
+
+		for (int i = 0; i < threads.size(); i++) {
+			threads.write[i] = Thread::create(_digest_job_queue, &job_queue);
+		}
+		_digest_job_queue(&job_queue);
+
+		for (int i = 0; i < threads.size(); i++) {
+			Thread::wait_to_finish(threads[i]);
+			memdelete(threads[i]);
+		}
+
 		rb = PoolVector<uint8_t>::Read();
 		wb = PoolVector<uint8_t>::Write();
 
@@ -1325,5 +1325,9 @@ CanvasItem::CanvasItem() :
 
 CanvasItem::~CanvasItem() {
 
+	if (SceneTree::get_singleton()) {
+		//the canvas item may have a transform pending, if freed while the tree is processing
+		SceneTree::get_singleton()->flush_batched_transforms();
+	}
 	VisualServer::get_singleton()->free(canvas_item);
 }
@@ -133,10 +133,12 @@ void Node2D::_update_transform() {
 	_mat.set_rotation_and_scale(angle, _scale);
 	_mat.elements[2] = pos;
 
-	VisualServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
-
-	if (!is_inside_tree())
+	if (!is_inside_tree()) {
+		VisualServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
 		return;
+	}
+
+	get_tree()->set_canvas_item_transform(get_canvas_item(), _mat); //batched while the tree runs process callbacks
 
 	_notify_transform();
 }
@@ -311,10 +313,12 @@ void Node2D::set_transform(const Transform2D &p_transform) {
 	_mat = p_transform;
 	_xform_dirty = true;
 
-	VisualServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
-
-	if (!is_inside_tree())
+	if (!is_inside_tree()) {
+		VisualServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
 		return;
+	}
+
+	get_tree()->set_canvas_item_transform(get_canvas_item(), _mat); //batched while the tree runs process callbacks
 
 	_notify_transform();
 }
@@ -96,10 +96,15 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
+	/* A node whose global transform is dirty has all its descendants dirty too, as
+	 * reading a global transform cleans the whole parent chain. If it was already
+	 * propagated since the tree last flushed transform notifications, every
+	 * descendant that wants the notification is still queued, so moving the same
+	 * subtree several times per frame only walks it once.
+	 */
+	if ((data.dirty & DIRTY_GLOBAL) && data.xform_change_pass == get_tree()->xform_change_pass) {
+		return;
+	}
 
 	data.children_lock++;
 
@@ -117,6 +122,8 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 		get_tree()->xform_change_list.add(&xform_change);
 	}
 	data.dirty |= DIRTY_GLOBAL;
+	//a node ignoring notifications was not queued, so it must not cut the next propagation short
+	data.xform_change_pass = data.ignore_notification ? get_tree()->xform_change_pass - 1 : get_tree()->xform_change_pass;
 
 	data.children_lock--;
 }
@@ -422,6 +429,8 @@ void Spatial::set_gizmo(const Ref<SpatialGizmo> &p_gizmo) {
 	if (data.gizmo.is_valid() && is_inside_world())
 		data.gizmo->free();
 	data.gizmo = p_gizmo;
+	if (data.gizmo.is_valid() && is_inside_tree())
+		get_tree()->xform_change_pass++; //dirty nodes were not queued for it, propagate fully again
 	if (data.gizmo.is_valid() && is_inside_world()) {
 
 		data.gizmo->create();
@@ -714,6 +723,9 @@ Vector3 Spatial::to_global(Vector3 p_local) const {
 
 void Spatial::set_notify_transform(bool p_enable) {
 	data.notify_transform = p_enable;
+	if (p_enable && is_inside_tree()) {
+		get_tree()->xform_change_pass++; //dirty nodes were not queued for it, propagate fully again
+	}
 }
 
 bool Spatial::is_transform_notification_enabled() const {
@@ -734,6 +746,7 @@ void Spatial::force_update_transform() {
 		return; //nothing to update
 	}
 	get_tree()->xform_change_list.remove(&xform_change);
+	get_tree()->xform_change_pass++; //this node is no longer queued
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
@@ -825,6 +838,7 @@ Spatial::Spatial() :
 		xform_change(this) {
 
 	data.dirty = DIRTY_NONE;
+	data.xform_change_pass = 0;
 	data.children_lock = 0;
 
 	data.ignore_notification = false;
@@ -75,6 +75,7 @@ class Spatial : public Node {
 		mutable Vector3 scale;
 
 		mutable int dirty;
+		uint32_t xform_change_pass;
 
 		Viewport *viewport;
 
@@ -30,6 +30,7 @@
 
 #include "visual_instance.h"
 
+#include "scene/main/scene_tree.h"
 #include "scene/scene_string_names.h"
 #include "servers/visual_server.h"
 #include "skeleton.h"
@@ -68,7 +69,7 @@ void VisualInstance::_notification(int p_what) {
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 
 			Transform gt = get_global_transform();
-			VisualServer::get_singleton()->instance_set_transform(instance, gt);
+			get_tree()->set_instance_transform(instance, gt);
 		} break;
 		case NOTIFICATION_EXIT_WORLD: {
 
@@ -156,6 +157,10 @@ VisualInstance::VisualInstance() {
 
 VisualInstance::~VisualInstance() {
 
+	if (SceneTree::get_singleton()) {
+		//the instance may have a transform pending, if freed while transform notifications are flushed
+		SceneTree::get_singleton()->flush_batched_transforms();
+	}
 	VisualServer::get_singleton()->free(instance);
 }
 
@@ -32,6 +32,8 @@
 #include "label.h"
 #include "margin_container.h"
 
+#include "core/arena_allocator.h"
+
 struct _MinSizeCache {
 
 	int min_size;
@@ -52,7 +54,7 @@ void BoxContainer::_resort() {
 	int stretch_min = 0;
 	int stretch_avail = 0;
 	float stretch_ratio_total = 0;
-	Map<Control *, _MinSizeCache> min_size_cache;
+	Map<Control *, _MinSizeCache, ::Comparator<Control *>, FrameAllocator> min_size_cache;
 
 	for (int i = 0; i < get_child_count(); i++) {
 		Control *c = Object::cast_to<Control>(get_child(i));
@@ -30,6 +30,12 @@
 
 #include "grid_container.h"
 
+#include "core/arena_allocator.h"
+
+// per-row/column scratch data, released at the end of the frame
+typedef Map<int, int, Comparator<int>, FrameAllocator> FrameIntMap;
+typedef Set<int, Comparator<int>, FrameAllocator> FrameIntSet;
+
 void GridContainer::_notification(int p_what) {
 
 	switch (p_what) {
@@ -38,10 +44,10 @@ void GridContainer::_notification(int p_what) {
 
 			int valid_controls_index;
 
-			Map<int, int> col_minw; // max of min_width  of all controls in each col (indexed by col)
-			Map<int, int> row_minh; // max of min_height of all controls in each row (indexed by row)
-			Set<int> col_expanded; // columns which have the SIZE_EXPAND flag set
-			Set<int> row_expanded; // rows which have the SIZE_EXPAND flag set
+			FrameIntMap col_minw; // max of min_width  of all controls in each col (indexed by col)
+			FrameIntMap row_minh; // max of min_height of all controls in each row (indexed by row)
+			FrameIntSet col_expanded; // columns which have the SIZE_EXPAND flag set
+			FrameIntSet row_expanded; // rows which have the SIZE_EXPAND flag set
 
 			int hsep = get_constant("hseparation");
 			int vsep = get_constant("vseparation");
@@ -79,12 +85,12 @@ void GridContainer::_notification(int p_what) {
 
 			// Evaluate the remaining space for expanded columns/rows
 			Size2 remaining_space = get_size();
-			for (Map<int, int>::Element *E = col_minw.front(); E; E = E->next()) {
+			for (FrameIntMap::Element *E = col_minw.front(); E; E = E->next()) {
 				if (!col_expanded.has(E->key()))
 					remaining_space.width -= E->get();
 			}
 
-			for (Map<int, int>::Element *E = row_minh.front(); E; E = E->next()) {
+			for (FrameIntMap::Element *E = row_minh.front(); E; E = E->next()) {
 				if (!row_expanded.has(E->key()))
 					remaining_space.height -= E->get();
 			}
@@ -96,7 +102,7 @@ void GridContainer::_notification(int p_what) {
 				// Check if all minwidth constraints are ok if we use the remaining space
 				can_fit = true;
 				int max_index = col_expanded.front()->get();
-				for (Set<int>::Element *E = col_expanded.front(); E; E = E->next()) {
+				for (FrameIntSet::Element *E = col_expanded.front(); E; E = E->next()) {
 					if (col_minw[E->get()] > col_minw[max_index]) {
 						max_index = E->get();
 					}
@@ -117,7 +123,7 @@ void GridContainer::_notification(int p_what) {
 				// Check if all minwidth constraints are ok if we use the remaining space
 				can_fit = true;
 				int max_index = row_expanded.front()->get();
-				for (Set<int>::Element *E = row_expanded.front(); E; E = E->next()) {
+				for (FrameIntSet::Element *E = row_expanded.front(); E; E = E->next()) {
 					if (row_minh[E->get()] > row_minh[max_index]) {
 						max_index = E->get();
 					}
@@ -194,8 +200,8 @@ void GridContainer::_bind_methods() {
 
 Size2 GridContainer::get_minimum_size() const {
 
-	Map<int, int> col_minw;
-	Map<int, int> row_minh;
+	FrameIntMap col_minw;
+	FrameIntMap row_minh;
 
 	int hsep = get_constant("hseparation");
 	int vsep = get_constant("vseparation");
@@ -229,11 +235,11 @@ Size2 GridContainer::get_minimum_size() const {
 
 	Size2 ms;
 
-	for (Map<int, int>::Element *E = col_minw.front(); E; E = E->next()) {
+	for (FrameIntMap::Element *E = col_minw.front(); E; E = E->next()) {
 		ms.width += E->get();
 	}
 
-	for (Map<int, int>::Element *E = row_minh.front(); E; E = E->next()) {
+	for (FrameIntMap::Element *E = row_minh.front(); E; E = E->next()) {
 		ms.height += E->get();
 	}
 
@@ -45,7 +45,11 @@
 
 VARIANT_ENUM_CAST(Node::PauseMode);
 
-int Node::orphan_node_count = 0;
+uint32_t Node::orphan_node_count = 0;
+
+//paths resolved by get_node() are valid until a node is added, removed, moved or renamed anywhere
+static uint32_t structure_version = 1;
+static bool get_node_cache = true;
 
 void Node::_notification(int p_notification) {
 
@@ -90,13 +94,13 @@ void Node::_notification(int p_notification) {
 				add_to_group("_vp_unhandled_key_input" + itos(get_viewport()->get_instance_id()));
 
 			get_tree()->node_count++;
-			orphan_node_count--;
+			atomic_decrement(&orphan_node_count);
 
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
 
 			get_tree()->node_count--;
-			orphan_node_count++;
+			atomic_increment(&orphan_node_count);
 
 			if (data.input)
 				remove_from_group("_vp_input" + itos(get_viewport()->get_instance_id()));
@@ -110,6 +114,10 @@ void Node::_notification(int p_notification) {
 				memdelete(data.path_cache);
 				data.path_cache = NULL;
 			}
+			if (data.resolved_paths) {
+				memdelete(data.resolved_paths);
+				data.resolved_paths = NULL;
+			}
 		} break;
 		case NOTIFICATION_PATH_CHANGED: {
 
@@ -323,10 +331,14 @@ void Node::_propagate_exit_tree() {
 void Node::move_child(Node *p_child, int p_pos) {
 
 	ERR_FAIL_NULL(p_child);
-	ERR_EXPLAIN("Invalid new child position: " + itos(p_pos));
-	ERR_FAIL_INDEX(p_pos, data.children.size() + 1);
-	ERR_EXPLAIN("child is not a child of this node.");
-	ERR_FAIL_COND(p_child->data.parent != this);
+	if (p_pos < 0 || p_pos > data.children.size()) {
+		ERR_EXPLAIN("Invalid new child position: " + itos(p_pos));
+		ERR_FAIL_INDEX(p_pos, data.children.size() + 1);
+	}
+	if (p_child->data.parent != this) {
+		ERR_EXPLAIN("child is not a child of this node.");
+		ERR_FAIL_COND(p_child->data.parent != this);
+	}
 	if (data.blocked > 0) {
 		ERR_EXPLAIN("Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
 		ERR_FAIL_COND(data.blocked > 0);
@@ -345,6 +357,7 @@ void Node::move_child(Node *p_child, int p_pos) {
 
 	data.children.remove(p_child->data.pos);
 	data.children.insert(p_pos, p_child);
+	atomic_increment(&structure_version);
 
 	if (data.tree) {
 		data.tree->tree_changed();
@@ -853,6 +866,34 @@ void Node::set_process_priority(int p_priority) {
 		data.tree->make_group_changed("physics_process_internal");
 }
 
+void Node::set_process_thread_safe(bool p_enable) {
+
+	if (data.process_thread_safe == p_enable)
+		return;
+
+	data.process_thread_safe = p_enable;
+
+	if (!data.tree)
+		return;
+
+	if (is_processing())
+		data.tree->make_group_changed("idle_process");
+
+	if (is_processing_internal())
+		data.tree->make_group_changed("idle_process_internal");
+
+	if (is_physics_processing())
+		data.tree->make_group_changed("physics_process");
+
+	if (is_physics_processing_internal())
+		data.tree->make_group_changed("physics_process_internal");
+}
+
+bool Node::is_process_thread_safe() const {
+
+	return data.process_thread_safe;
+}
+
 void Node::set_process_input(bool p_enable) {
 
 	if (p_enable == data.input)
@@ -915,7 +956,13 @@ StringName Node::get_name() const {
 
 void Node::_set_name_nocheck(const StringName &p_name) {
 
+	StringName old_name = data.name;
 	data.name = p_name;
+
+	if (data.parent) {
+		data.parent->_child_renamed(this, old_name);
+	}
+	atomic_increment(&structure_version);
 }
 
 String Node::invalid_character = ". : @ / \"";
@@ -937,12 +984,15 @@ void Node::set_name(const String &p_name) {
 	_validate_node_name(name);
 
 	ERR_FAIL_COND(name == "");
+	StringName old_name = data.name;
 	data.name = name;
 
 	if (data.parent) {
 
 		data.parent->_validate_child_name(this);
+		data.parent->_child_renamed(this, old_name);
 	}
+	atomic_increment(&structure_version);
 
 	propagate_notification(NOTIFICATION_PATH_CHANGED);
 
@@ -1148,6 +1198,21 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
 	p_child->data.parent = this;
+
+	if (data.children_by_name) {
+		if (data.children_by_name->has(p_name)) {
+			//names were not validated, fall back to searching the children in order
+			memdelete(data.children_by_name);
+			data.children_by_name = NULL;
+			data.children_name_clash = true;
+		} else {
+			data.children_by_name->set(p_name, p_child);
+		}
+	} else if (data.children.size() >= CHILD_NAME_INDEX_MIN && !data.children_name_clash) {
+		//built here rather than by lookups, which are const and may come from other threads
+		_build_child_name_index();
+	}
+	atomic_increment(&structure_version);
 	p_child->notification(NOTIFICATION_PARENTED);
 
 	if (data.tree) {
@@ -1180,9 +1245,6 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 		ERR_FAIL_COND(data.blocked > 0);
 	}
 
-	ERR_EXPLAIN("Can't add child while a notification is happening.");
-	ERR_FAIL_COND(data.blocked > 0);
-
 	/* Validate name */
 	_validate_child_name(p_child, p_legible_unique_name);
 
@@ -1280,6 +1342,22 @@ void Node::remove_child(Node *p_child) {
 	child_count = data.children.size();
 	children = data.children.ptrw();
 
+	if (data.children_by_name) {
+		if (child_count < CHILD_NAME_INDEX_MIN / 2) {
+			memdelete(data.children_by_name);
+			data.children_by_name = NULL;
+		} else {
+			Node **E = data.children_by_name->getptr(p_child->data.name);
+			if (E && *E == p_child) {
+				data.children_by_name->erase(p_child->data.name);
+			}
+		}
+	}
+	if (child_count == 0) {
+		data.children_name_clash = false;
+	}
+	atomic_increment(&structure_version);
+
 	for (int i = idx; i < child_count; i++) {
 
 		children[i]->data.pos = i;
@@ -1308,8 +1386,52 @@ Node *Node::get_child(int p_index) const {
 	return data.children[p_index];
 }
 
+void Node::_build_child_name_index() {
+
+	data.children_by_name = memnew(ChildNameIndex);
+
+	int cc = data.children.size();
+	Node *const *cd = data.children.ptr();
+
+	for (int i = 0; i < cc; i++) {
+
+		if (data.children_by_name->has(cd[i]->data.name)) {
+			memdelete(data.children_by_name);
+			data.children_by_name = NULL;
+			data.children_name_clash = true;
+			return;
+		}
+		data.children_by_name->set(cd[i]->data.name, cd[i]);
+	}
+}
+
+void Node::_child_renamed(Node *p_child, const StringName &p_old_name) {
+
+	if (!data.children_by_name) {
+		return;
+	}
+
+	Node **E = data.children_by_name->getptr(p_old_name);
+	if (E && *E == p_child) {
+		data.children_by_name->erase(p_old_name);
+	}
+
+	if (data.children_by_name->has(p_child->data.name)) {
+		memdelete(data.children_by_name);
+		data.children_by_name = NULL;
+		data.children_name_clash = true;
+	} else {
+		data.children_by_name->set(p_child->data.name, p_child);
+	}
+}
+
 Node *Node::_get_child_by_name(const StringName &p_name) const {
 
+	if (data.children_by_name) {
+		Node *const *E = data.children_by_name->getptr(p_name);
+		return E ? *E : NULL;
+	}
+
 	int cc = data.children.size();
 	Node *const *cd = data.children.ptr();
 
@@ -1327,6 +1449,38 @@ Node *Node::get_node_or_null(const NodePath &p_path) const {
 		return NULL;
 	}
 
+	//single names are found quickly through the child index, cache only longer paths.
+	//the cache is filled from a const method, so other threads only resolve
+	if (!get_node_cache || p_path.get_name_count() < 2 || Thread::get_caller_id() != Thread::get_main_id()) {
+		return _resolve_path(p_path);
+	}
+
+	uint32_t version = atomic_add(&structure_version, 0);
+
+	if (data.resolved_paths && data.resolved_paths->version == version) {
+		Node *const *E = data.resolved_paths->paths.getptr(p_path);
+		if (E) {
+			return *E;
+		}
+	}
+
+	Node *node = _resolve_path(p_path);
+
+	if (!data.resolved_paths) {
+		data.resolved_paths = memnew(ResolvedPathCache);
+		data.resolved_paths->version = version;
+	} else if (data.resolved_paths->version != version || data.resolved_paths->paths.size() >= RESOLVED_PATH_CACHE_MAX) {
+		data.resolved_paths->paths.clear();
+		data.resolved_paths->version = version;
+	}
+
+	data.resolved_paths->paths.set(p_path, node);
+
+	return node;
+}
+
+Node *Node::_resolve_path(const NodePath &p_path) const {
+
 	if (!data.inside_tree && p_path.is_absolute()) {
 		ERR_EXPLAIN("Can't use get_node() with absolute paths from outside the active scene tree.");
 		ERR_FAIL_V(NULL);
@@ -1366,18 +1520,7 @@ Node *Node::get_node_or_null(const NodePath &p_path) const {
 
 		} else {
 
-			next = NULL;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == NULL) {
 				return NULL;
 			};
@@ -1704,6 +1847,7 @@ void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 	}
 
 	gd.persistent = p_persistent;
+	gd.serial = next_connection_serial();
 
 	data.grouped[p_identifier] = gd;
 }
@@ -1740,6 +1884,7 @@ void Node::get_groups(List<GroupInfo> *p_groups) const {
 		GroupInfo gi;
 		gi.name = E->key();
 		gi.persistent = E->get().persistent;
+		gi.serial = E->get().serial;
 		p_groups->push_back(gi);
 	}
 }
@@ -1954,6 +2099,16 @@ Ref<SceneState> Node::get_scene_inherited_state() const {
 	return data.inherited_state;
 }
 
+void Node::set_scene_instance_serial(uint64_t p_serial) {
+
+	data.instance_serial = p_serial;
+}
+
+uint64_t Node::get_scene_instance_serial() const {
+
+	return data.instance_serial;
+}
+
 void Node::set_scene_instance_load_placeholder(bool p_enable) {
 
 	data.use_placeholder = p_enable;
@@ -2719,6 +2874,7 @@ void Node::_bind_methods() {
 	ProjectSettings::get_singleton()->set_custom_property_info("node/name_num_separator", PropertyInfo(Variant::INT, "node/name_num_separator", PROPERTY_HINT_ENUM, "None,Space,Underscore,Dash"));
 	GLOBAL_DEF("node/name_casing", NAME_CASING_PASCAL_CASE);
 	ProjectSettings::get_singleton()->set_custom_property_info("node/name_casing", PropertyInfo(Variant::INT, "node/name_casing", PROPERTY_HINT_ENUM, "PascalCase,camelCase,snake_case"));
+	get_node_cache = GLOBAL_DEF("node/cache_resolved_paths", true);
 
 	ClassDB::bind_method(D_METHOD("add_child_below_node", "node", "child_node", "legible_unique_name"), &Node::add_child_below_node, DEFVAL(false));
 
@@ -2765,6 +2921,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_process_delta_time"), &Node::get_process_delta_time);
 	ClassDB::bind_method(D_METHOD("set_process", "enable"), &Node::set_process);
 	ClassDB::bind_method(D_METHOD("set_process_priority", "priority"), &Node::set_process_priority);
+	ClassDB::bind_method(D_METHOD("set_process_thread_safe", "enable"), &Node::set_process_thread_safe);
+	ClassDB::bind_method(D_METHOD("is_process_thread_safe"), &Node::is_process_thread_safe);
 	ClassDB::bind_method(D_METHOD("is_processing"), &Node::is_processing);
 	ClassDB::bind_method(D_METHOD("set_process_input", "enable"), &Node::set_process_input);
 	ClassDB::bind_method(D_METHOD("is_processing_input"), &Node::is_processing_input);
@@ -2931,11 +3089,13 @@ Node::Node() {
 	data.pos = -1;
 	data.depth = -1;
 	data.blocked = 0;
+	data.instance_serial = 0;
 	data.parent = NULL;
 	data.tree = NULL;
 	data.physics_process = false;
 	data.idle_process = false;
 	data.process_priority = 0;
+	data.process_thread_safe = false;
 	data.physics_process_internal = false;
 	data.idle_process_internal = false;
 	data.inside_tree = false;
@@ -2950,6 +3110,9 @@ Node::Node() {
 	data.pause_owner = NULL;
 	data.network_master = 1; //server by default
 	data.path_cache = NULL;
+	data.resolved_paths = NULL;
+	data.children_by_name = NULL;
+	data.children_name_clash = false;
 	data.parent_owned = false;
 	data.in_constructor = true;
 	data.viewport = NULL;
@@ -2957,7 +3120,7 @@ Node::Node() {
 	data.display_folded = false;
 	data.ready_first = true;
 
-	orphan_node_count++;
+	atomic_increment(&orphan_node_count);
 }
 
 Node::~Node() {
@@ -2966,10 +3129,17 @@ Node::~Node() {
 	data.owned.clear();
 	data.children.clear();
 
+	if (data.children_by_name) {
+		memdelete(data.children_by_name);
+	}
+	if (data.resolved_paths) {
+		memdelete(data.resolved_paths);
+	}
+
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
 
-	orphan_node_count--;
+	atomic_decrement(&orphan_node_count);
 }
 
 ////////////////////////////////
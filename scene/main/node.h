@@ -72,17 +72,40 @@ public:
 
 	struct ComparatorWithPriority {
 
-		bool operator()(const Node *p_a, const Node *p_b) const { return p_b->data.process_priority == p_a->data.process_priority ? p_b->is_greater_than(p_a) : p_b->data.process_priority > p_a->data.process_priority; }
+		bool operator()(const Node *p_a, const Node *p_b) const {
+			if (p_b->data.process_priority != p_a->data.process_priority)
+				return p_b->data.process_priority > p_a->data.process_priority;
+			//thread safe nodes go last within a priority, so they form a contiguous run
+			if (p_b->data.process_thread_safe != p_a->data.process_thread_safe)
+				return p_b->data.process_thread_safe;
+			return p_b->is_greater_than(p_a);
+		}
 	};
 
-	static int orphan_node_count;
+	static uint32_t orphan_node_count;
 
 private:
 	struct GroupData {
 
 		bool persistent;
+		uint64_t serial; // same counter as signal connections, see Object::get_connection_serial()
 		SceneTree::Group *group;
-		GroupData() { persistent = false; }
+		GroupData() {
+			persistent = false;
+			serial = 0;
+		}
+	};
+
+	enum {
+		CHILD_NAME_INDEX_MIN = 32, // children needed before lookups by name use a hash index
+		RESOLVED_PATH_CACHE_MAX = 64
+	};
+
+	typedef HashMap<StringName, Node *> ChildNameIndex;
+
+	struct ResolvedPathCache {
+		uint32_t version;
+		HashMap<NodePath, Node *> paths;
 	};
 
 	struct Data {
@@ -90,12 +113,15 @@ private:
 		String filename;
 		Ref<SceneState> instance_state;
 		Ref<SceneState> inherited_state;
+		uint64_t instance_serial; // connections and groups made after this were added at runtime, see PackedScene::recycle_instance()
 
 		HashMap<NodePath, int> editable_instances;
 
 		Node *parent;
 		Node *owner;
 		Vector<Node *> children; // list of children
+		ChildNameIndex *children_by_name; // only created for nodes with many children, when they are added
+		bool children_name_clash; // children with the same name were added without validation, index can't be used
 		int pos;
 		int depth;
 		int blocked; // safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
@@ -126,6 +152,7 @@ private:
 		bool physics_process;
 		bool idle_process;
 		int process_priority;
+		bool process_thread_safe;
 
 		bool physics_process_internal;
 		bool idle_process_internal;
@@ -141,6 +168,7 @@ private:
 		bool display_folded;
 
 		mutable NodePath *path_cache;
+		mutable ResolvedPathCache *resolved_paths; // only used by the main thread
 
 	} data;
 
@@ -156,6 +184,9 @@ private:
 	void _print_tree(const Node *p_node);
 
 	Node *_get_child_by_name(const StringName &p_name) const;
+	void _build_child_name_index();
+	void _child_renamed(Node *p_child, const StringName &p_old_name);
+	Node *_resolve_path(const NodePath &p_path) const;
 
 	void _replace_connections_target(Node *p_new_target);
 
@@ -297,6 +328,7 @@ public:
 
 		StringName name;
 		bool persistent;
+		uint64_t serial;
 	};
 
 	void get_groups(List<GroupInfo> *p_groups) const;
@@ -346,6 +378,9 @@ public:
 
 	void set_process_priority(int p_priority);
 
+	void set_process_thread_safe(bool p_enable);
+	bool is_process_thread_safe() const;
+
 	void set_process_input(bool p_enable);
 	bool is_processing_input() const;
 
@@ -375,6 +410,9 @@ public:
 	void set_scene_instance_load_placeholder(bool p_enable);
 	bool get_scene_instance_load_placeholder() const;
 
+	void set_scene_instance_serial(uint64_t p_serial);
+	uint64_t get_scene_instance_serial() const;
+
 	static Vector<Variant> make_binds(VARIANT_ARG_LIST);
 
 	void replace_by(Node *p_node, bool p_keep_data = false);
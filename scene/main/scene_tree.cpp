@@ -112,39 +112,51 @@ void SceneTree::node_renamed(Node *p_node) {
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
-		E = group_map.insert(p_group, Group());
+	Group *g = group_map.getptr(p_group);
+	if (!g) {
+		g = &group_map.set(p_group, Group())->value();
 	}
 
-	if (E->get().nodes.find(p_node) != -1) {
+#ifdef DEBUG_ENABLED
+	if (g->nodes.find(p_node) != -1) {
 		ERR_EXPLAIN("Already in group: " + p_group);
-		ERR_FAIL_V(&E->get());
+		ERR_FAIL_V(g);
 	}
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+#endif
+	//appended out of order, _update_group_order() merges it in
+	g->nodes.push_back(p_node);
+	return g;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	ERR_FAIL_COND(!E);
+	Group *g = group_map.getptr(p_group);
+	ERR_FAIL_COND(!g);
+
+	int idx = g->nodes.find(p_node);
+	ERR_FAIL_COND(idx == -1);
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.empty())
-		group_map.erase(E);
+	//removing keeps the order of the rest
+	g->nodes.remove(idx);
+	if (idx < g->sorted_count)
+		g->sorted_count--;
+
+	if (g->nodes.empty())
+		group_map.erase(p_group);
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (E)
-		E->get().changed = true;
+	Group *g = group_map.getptr(p_group);
+	if (g)
+		g->changed = true;
 }
 
 void SceneTree::flush_transform_notifications() {
 
+	xform_change_pass++;
+
+	xform_batch_lock++;
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 
@@ -154,6 +166,52 @@ void SceneTree::flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	//nodes moved by the notifications above propagated in this pass and were flushed too,
+	//so they are dirty without being queued anymore
+	xform_change_pass++;
+
+	xform_batch_lock--;
+
+	if (xform_batch_lock == 0)
+		flush_batched_transforms();
+}
+
+void SceneTree::set_instance_transform(RID p_instance, const Transform &p_transform) {
+
+	if (xform_batch_lock == 0) {
+		VS::get_singleton()->instance_set_transform(p_instance, p_transform);
+		return;
+	}
+
+	xform_batch_instances.push_back(p_instance);
+	xform_batch_transforms.push_back(p_transform);
+}
+
+void SceneTree::set_canvas_item_transform(RID p_canvas_item, const Transform2D &p_transform) {
+
+	if (xform_batch_lock == 0) {
+		VS::get_singleton()->canvas_item_set_transform(p_canvas_item, p_transform);
+		return;
+	}
+
+	xform_batch_canvas_items.push_back(p_canvas_item);
+	xform_batch_canvas_transforms.push_back(p_transform);
+}
+
+void SceneTree::flush_batched_transforms() {
+
+	if (!xform_batch_instances.empty()) {
+		VS::get_singleton()->instances_set_transforms(xform_batch_instances, xform_batch_transforms);
+		xform_batch_instances.clear();
+		xform_batch_transforms.clear();
+	}
+
+	if (!xform_batch_canvas_items.empty()) {
+		VS::get_singleton()->canvas_items_set_transforms(xform_batch_canvas_items, xform_batch_canvas_transforms);
+		xform_batch_canvas_items.clear();
+		xform_batch_canvas_transforms.clear();
+	}
 }
 
 void SceneTree::_flush_ugc() {
@@ -176,32 +234,92 @@ void SceneTree::_flush_ugc() {
 	ugc_locked = false;
 }
 
+template <class C>
+static void _merge_group_nodes(Node **p_nodes, int p_sorted_count, int p_node_count) {
+
+	//sort the nodes added since the last time, then find where each goes among the sorted ones
+	int added_count = p_node_count - p_sorted_count;
+	Node **added = (Node **)alloca(sizeof(Node *) * added_count);
+	int *positions = (int *)alloca(sizeof(int) * added_count);
+
+	memcpy(added, &p_nodes[p_sorted_count], sizeof(Node *) * added_count);
+
+	SortArray<Node *, C> node_sort;
+	node_sort.sort(added, added_count);
+
+	C compare;
+	int from = 0;
+	for (int i = 0; i < added_count; i++) {
+
+		int lo = from;
+		int hi = p_sorted_count;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (compare(added[i], p_nodes[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		positions[i] = lo;
+		from = lo;
+	}
+
+	//move everything once, from the back
+	int end = p_sorted_count;
+	for (int i = added_count - 1; i >= 0; i--) {
+
+		int pos = positions[i];
+		memmove(&p_nodes[pos + i + 1], &p_nodes[pos], sizeof(Node *) * (end - pos));
+		p_nodes[pos + i] = added[i];
+		end = pos;
+	}
+}
+
 void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 
-	if (!g.changed)
+	int node_count = g.nodes.size();
+
+	if (g.priority_order != p_use_priority) {
+		g.priority_order = p_use_priority;
+		g.changed = true;
+	}
+
+	if (!g.changed && g.sorted_count == node_count)
 		return;
-	if (g.nodes.empty())
+	if (node_count == 0)
 		return;
 
 	Node **nodes = g.nodes.ptrw();
-	int node_count = g.nodes.size();
 
-	if (p_use_priority) {
-		SortArray<Node *, Node::ComparatorWithPriority> node_sort;
-		node_sort.sort(nodes, node_count);
+	if (g.changed || g.sorted_count < node_count - g.sorted_count || node_count - g.sorted_count > GROUP_MERGE_MAX) {
+
+		//many nodes out of place, sort them all
+		if (p_use_priority) {
+			SortArray<Node *, Node::ComparatorWithPriority> node_sort;
+			node_sort.sort(nodes, node_count);
+		} else {
+			SortArray<Node *, Node::Comparator> node_sort;
+			node_sort.sort(nodes, node_count);
+		}
 	} else {
-		SortArray<Node *, Node::Comparator> node_sort;
-		node_sort.sort(nodes, node_count);
+
+		if (p_use_priority) {
+			_merge_group_nodes<Node::ComparatorWithPriority>(nodes, g.sorted_count, node_count);
+		} else {
+			_merge_group_nodes<Node::Comparator>(nodes, g.sorted_count, node_count);
+		}
 	}
+
+	g.sorted_count = node_count;
 	g.changed = false;
 }
 
 void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, VARIANT_ARG_DECLARE) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *gp = group_map.getptr(p_group);
+	if (!gp)
 		return;
-	Group &g = E->get();
+	Group &g = *gp;
 	if (g.nodes.empty())
 		return;
 
@@ -232,7 +350,7 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -277,17 +395,17 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *gp = group_map.getptr(p_group);
+	if (!gp)
 		return;
-	Group &g = E->get();
+	Group &g = *gp;
 	if (g.nodes.empty())
 		return;
 
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -326,17 +444,17 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 
 void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *gp = group_map.getptr(p_group);
+	if (!gp)
 		return;
-	Group &g = E->get();
+	Group &g = *gp;
 	if (g.nodes.empty())
 		return;
 
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -474,10 +592,13 @@ bool SceneTree::iteration(float p_time) {
 
 	emit_signal("physics_frame");
 
+	//transforms set by the callbacks are sent together by the next flush
+	xform_batch_lock++;
 	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
+	xform_batch_lock--;
 	flush_transform_notifications();
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "update_worlds");
 	root_lock--;
@@ -518,6 +639,8 @@ bool SceneTree::idle(float p_time) {
 
 	flush_transform_notifications();
 
+	//transforms set by the callbacks are sent together by the next flush
+	xform_batch_lock++;
 	_notify_group_pause("idle_process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
 	_notify_group_pause("idle_process", Node::NOTIFICATION_PROCESS);
 
@@ -532,6 +655,7 @@ bool SceneTree::idle(float p_time) {
 
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
+	xform_batch_lock--;
 	flush_transform_notifications(); //transforms after world update, to avoid unnecessary enter/exit notifications
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "update_worlds");
 
@@ -615,6 +739,8 @@ void SceneTree::finish() {
 		root->_propagate_after_exit_tree();
 		memdelete(root); //delete root
 	}
+
+	process_pool.finish();
 }
 
 void SceneTree::quit() {
@@ -899,10 +1025,10 @@ bool SceneTree::is_paused() const {
 
 void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *gp = group_map.getptr(p_group);
+	if (!gp)
 		return;
-	Group &g = E->get();
+	Group &g = *gp;
 	if (g.nodes.empty())
 		return;
 
@@ -913,7 +1039,7 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	Variant arg = p_input;
 	const Variant *v[1] = { &arg };
@@ -941,33 +1067,78 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 		call_skip.clear();
 }
 
+void SceneTree::_process_node_threaded(uint32_t p_index, ThreadedProcess *p_process) {
+
+	Node *n = p_process->nodes[p_index];
+	if (p_process->check_skip && call_skip.has(n))
+		return;
+	if (p_process->check_pause && !n->can_process())
+		return;
+	if (!n->can_process_notification(p_process->notification))
+		return;
+
+	n->notification(p_process->notification);
+}
+
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *gp = group_map.getptr(p_group);
+	if (!gp)
 		return;
-	Group &g = E->get();
+	Group &g = *gp;
 	if (g.nodes.empty())
 		return;
 
 	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
+	//keep a reference, so copy on write happens in case something is removed from process while being called.
+	//only read through it, asking for a writable pointer would copy the whole array every frame.
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
+
+	//pause state only needs to be resolved per node while paused
+	bool check_pause = pause;
+
+	//end of the last thread safe run that was too small to be worth processing in parallel
+	int serial_run_end = 0;
 
 	call_lock++;
 
 	for (int i = 0; i < node_count; i++) {
 
 		Node *n = nodes[i];
+
+		if (i >= serial_run_end && n->data.process_thread_safe) {
+
+			//nodes marked thread safe are sorted last within their priority, process the whole run in parallel
+			int run_end = i + 1;
+			while (run_end < node_count && nodes[run_end]->data.process_thread_safe && nodes[run_end]->data.process_priority == n->data.process_priority)
+				run_end++;
+
+			if (run_end - i >= PROCESS_THREADED_MIN_NODES && OS::get_singleton()->get_processor_count() > 1) {
+
+				if (!process_pool.is_initialized())
+					process_pool.init();
+
+				ThreadedProcess tp;
+				tp.nodes = &nodes[i];
+				tp.notification = p_notification;
+				tp.check_pause = check_pause;
+				tp.check_skip = !call_skip.empty();
+				process_pool.do_work(run_end - i, this, &SceneTree::_process_node_threaded, &tp);
+				i = run_end - 1;
+				continue;
+			}
+
+			serial_run_end = run_end;
+		}
+
 		if (call_lock && call_skip.has(n))
 			continue;
 
-		if (!n->can_process())
+		if (check_pause && !n->can_process())
 			continue;
 		if (!n->can_process_notification(p_notification))
 			continue;
@@ -1048,18 +1219,18 @@ int64_t SceneTree::get_event_count() const {
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return ret;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*g); //update order just in case
+	int nc = g->nodes.size();
 	if (nc == 0)
 		return ret;
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptrw();
+	Node *const *ptr = g->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		ret[i] = ptr[i];
@@ -1074,15 +1245,15 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*g); //update order just in case
+	int nc = g->nodes.size();
 	if (nc == 0)
 		return;
-	Node **ptr = E->get().nodes.ptrw();
+	Node *const *ptr = g->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		p_list->push_back(ptr[i]);
@@ -1980,6 +2151,8 @@ SceneTree::SceneTree() {
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/shapes/collision/max_contacts_displayed", PropertyInfo(Variant::INT, "debug/shapes/collision/max_contacts_displayed", PROPERTY_HINT_RANGE, "0,20000,1")); // No negative
 
 	tree_version = 1;
+	xform_change_pass = 0;
+	xform_batch_lock = 0;
 	physics_process_time = 1;
 	idle_process_time = 1;
 
@@ -31,9 +31,11 @@
 #ifndef SCENE_MAIN_LOOP_H
 #define SCENE_MAIN_LOOP_H
 
+#include "core/hash_map.h"
 #include "core/io/multiplayer_api.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/os/thread_work_pool.h"
 #include "core/self_list.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world.h"
@@ -94,12 +96,22 @@ public:
 	};
 
 private:
+	enum {
+		GROUP_MERGE_MAX = 1024 // nodes added to a group that are merged into the sorted ones, above this the group is sorted again
+	};
+
 	struct Group {
 
 		Vector<Node *> nodes;
 		//uint64_t last_tree_version;
-		bool changed;
-		Group() { changed = false; };
+		int sorted_count; // nodes before this are in tree order, the ones added after it are merged in when the order is needed
+		bool changed; // order of the sorted nodes may no longer be valid, sort them all again
+		bool priority_order;
+		Group() {
+			sorted_count = 0;
+			changed = false;
+			priority_order = false;
+		};
 	};
 
 	Viewport *root;
@@ -117,7 +129,7 @@ private:
 	bool pause;
 	int root_lock;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group> group_map;
 	bool _quit;
 	bool initialized;
 	bool input_handled;
@@ -163,6 +175,23 @@ private:
 	void _flush_ugc();
 
 	_FORCE_INLINE_ void _update_group_order(Group &g, bool p_use_priority = false);
+
+	enum {
+		PROCESS_THREADED_MIN_NODES = 64 //smaller runs of thread safe nodes are not worth waking the workers for
+	};
+
+	//created on the first threaded run and kept, spawning threads every frame costs more than processing small groups
+	ThreadWorkPool process_pool;
+
+	struct ThreadedProcess {
+
+		Node *const *nodes;
+		int notification;
+		bool check_pause;
+		bool check_skip;
+	};
+
+	void _process_node_threaded(uint32_t p_index, ThreadedProcess *p_process);
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName &p_group);
@@ -221,6 +250,14 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	uint32_t xform_change_pass; //incremented whenever nodes may leave xform_change_list, see Spatial::_propagate_transform_changed()
+
+	//instance and canvas item transforms changed while flushing or processing, sent to VisualServer as one command each
+	int xform_batch_lock;
+	Vector<RID> xform_batch_instances;
+	Vector<Transform> xform_batch_transforms;
+	Vector<RID> xform_batch_canvas_items;
+	Vector<Transform2D> xform_batch_canvas_transforms;
 
 #ifdef DEBUG_ENABLED
 
@@ -312,6 +349,10 @@ public:
 
 	void flush_transform_notifications();
 
+	void set_instance_transform(RID p_instance, const Transform &p_transform);
+	void set_canvas_item_transform(RID p_canvas_item, const Transform2D &p_transform);
+	void flush_batched_transforms();
+
 	virtual void input_text(const String &p_text);
 	virtual void input_event(const Ref<InputEvent> &p_event);
 	virtual void init();
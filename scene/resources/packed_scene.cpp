@@ -92,8 +92,10 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 		if (i > 0) {
 
-			ERR_EXPLAIN(vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]))
-			ERR_FAIL_COND_V(n.parent == -1, NULL)
+			if (n.parent == -1) {
+				ERR_EXPLAIN(vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]));
+				ERR_FAIL_COND_V(n.parent == -1, NULL);
+			}
 			NODE_FROM_ID(nparent, n.parent);
 #ifdef DEBUG_ENABLED
 			if (!nparent && (n.parent & FLAG_ID_IS_PATH)) {
@@ -353,6 +355,196 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+void SceneState::_build_reset_properties() const {
+
+	int nc = nodes.size();
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+	const Variant *props = variants.ptr();
+	int prop_count = variants.size();
+
+	reset_properties.resize(nc);
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nodes[i];
+		Vector<ResetProperty> &reset = reset_properties.write[i];
+
+		Map<StringName, Variant> saved;
+		List<StringName> saved_order;
+
+		for (int j = 0; j < n.properties.size(); j++) {
+
+			ERR_FAIL_INDEX(n.properties[j].name, sname_count);
+			ERR_FAIL_INDEX(n.properties[j].value, prop_count);
+
+			StringName name = snames[n.properties[j].name];
+			const Variant &value = props[n.properties[j].value];
+
+			if (name == CoreStringNames::get_singleton()->_script) {
+				continue; //keep the script instance
+			}
+			if (value.get_type() == Variant::OBJECT) {
+				Ref<Resource> res = value;
+				if (res.is_valid() && res->is_local_to_scene()) {
+					continue; //the instance owns a copy, keep it
+				}
+			}
+
+			saved[name] = value;
+			saved_order.push_back(name);
+		}
+
+		bool created_here = n.type != TYPE_INSTANCED && n.instance < 0 && !(i == 0 && base_scene_idx >= 0);
+
+		if (created_here && ClassDB::class_exists(snames[n.type])) {
+			//properties not saved are at the class default
+			List<PropertyInfo> plist;
+			ClassDB::get_property_list(snames[n.type], &plist);
+
+			for (List<PropertyInfo>::Element *E = plist.front(); E; E = E->next()) {
+
+				if (!(E->get().usage & PROPERTY_USAGE_STORAGE) || E->get().name == "script") {
+					continue;
+				}
+
+				ResetProperty rp;
+				rp.name = E->get().name;
+
+				Map<StringName, Variant>::Element *S = saved.find(rp.name);
+				if (S) {
+					rp.value = S->get();
+					saved.erase(S);
+				} else {
+					rp.value = ClassDB::class_get_default_property_value(snames[n.type], rp.name);
+				}
+				reset.push_back(rp);
+			}
+		}
+
+		//the rest is set by the instanced scene or not known to the class (handled by _set)
+		for (List<StringName>::Element *E = saved_order.front(); E; E = E->next()) {
+
+			Map<StringName, Variant>::Element *S = saved.find(E->get());
+			if (S) {
+				ResetProperty rp;
+				rp.name = S->key();
+				rp.value = S->get();
+				reset.push_back(rp);
+			}
+		}
+	}
+}
+
+// the node that instancing p_idx created under p_root, NULL if it was removed since.
+// p_found holds the nodes already found for lower indices
+Node *SceneState::_get_instance_node(Node *p_root, Node *const *p_found, int p_idx) const {
+
+	if (p_idx == 0) {
+		return p_root;
+	}
+
+	const NodeData &n = nodes[p_idx];
+	Node *parent = NULL;
+	if (n.parent & FLAG_ID_IS_PATH) {
+		parent = p_root->get_node_or_null(node_paths[n.parent & FLAG_MASK]);
+	} else if (n.parent >= 0 && n.parent < p_idx) {
+		parent = p_found[n.parent];
+	}
+
+	return parent ? parent->_get_child_by_name(names[n.name]) : NULL;
+}
+
+// whether every node instancing created is still under p_root, so reset_instance() can restore all of them
+bool SceneState::is_instance_intact(Node *p_root) const {
+
+	ERR_FAIL_NULL_V(p_root, false);
+
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(nc == 0, false);
+
+	const Variant *props = variants.ptr();
+	Node **found = (Node **)alloca(sizeof(Node *) * nc);
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nodes[i];
+		Node *node = _get_instance_node(p_root, found, i);
+		if (!node) {
+			return false;
+		}
+		found[i] = node;
+
+		Ref<PackedScene> sdata;
+		if (i == 0) {
+			if (base_scene_idx >= 0) {
+				sdata = props[base_scene_idx];
+			}
+		} else if (n.instance >= 0 && !(n.instance & FLAG_INSTANCE_IS_PLACEHOLDER)) {
+			sdata = props[n.instance & FLAG_MASK];
+		}
+
+		if (sdata.is_valid() && !sdata->get_state()->is_instance_intact(node)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SceneState::reset_instance(Node *p_root) const {
+
+	ERR_FAIL_NULL(p_root);
+
+	int nc = nodes.size();
+	ERR_FAIL_COND(nc == 0);
+
+	if (reset_properties.size() != nc) {
+		_build_reset_properties();
+	}
+
+	const Variant *props = variants.ptr();
+	const NodeData *nd = nodes.ptr();
+
+	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nd[i];
+		Node *node = _get_instance_node(p_root, ret_nodes, i);
+
+		if (node) {
+			Ref<PackedScene> sdata;
+			if (i == 0) {
+				//inherited scene, restore the base first
+				if (base_scene_idx >= 0) {
+					sdata = props[base_scene_idx];
+				}
+			} else if (n.instance >= 0 && !(n.instance & FLAG_INSTANCE_IS_PLACEHOLDER)) {
+				sdata = props[n.instance & FLAG_MASK];
+			}
+
+			if (sdata.is_valid()) {
+				sdata->get_state()->reset_instance(node);
+			}
+		}
+
+		ret_nodes[i] = node;
+
+		if (!node) {
+			continue;
+		}
+
+		const Vector<ResetProperty> &reset = reset_properties[i];
+		int rc = reset.size();
+		const ResetProperty *rp = reset.ptr();
+
+		for (int j = 0; j < rc; j++) {
+			node->set(rp[j].name, rp[j].value);
+		}
+	}
+}
+
 static int _nm_get_string(const String &p_string, Map<StringName, int> &name_map) {
 
 	if (name_map.has(p_string))
@@ -929,6 +1121,7 @@ void SceneState::clear() {
 	node_path_cache.clear();
 	node_paths.clear();
 	editable_instances.clear();
+	reset_properties.clear();
 	base_scene_idx = -1;
 }
 
@@ -1098,6 +1291,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 		ERR_FAIL();
 	}
 
+	reset_properties.clear();
+
 	PoolVector<String> snames = p_dictionary["names"];
 	if (snames.size()) {
 
@@ -1557,6 +1752,8 @@ int SceneState::add_node_path(const NodePath &p_path) {
 }
 int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int p_instance, int p_index) {
 
+	reset_properties.clear();
+
 	NodeData nd;
 	nd.parent = p_parent;
 	nd.owner = p_owner;
@@ -1575,6 +1772,8 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	ERR_FAIL_INDEX(p_name, names.size());
 	ERR_FAIL_INDEX(p_value, variants.size());
 
+	reset_properties.clear();
+
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
@@ -1662,8 +1861,251 @@ SceneState::SceneState() {
 
 ////////////////
 
+void PackedScene::_prepare_thread_func(void *p_userdata) {
+
+	PackedScene *ps = (PackedScene *)p_userdata;
+
+	while (true) {
+
+		ps->instances_mutex->lock();
+		if (ps->prepare_exit || ps->prepare_pending == 0) {
+			ps->prepare_running = false;
+			ps->instances_mutex->unlock();
+			break;
+		}
+		ps->prepare_pending--;
+		ps->instances_mutex->unlock();
+
+		Node *s = ps->state->instance(SceneState::GEN_EDIT_STATE_DISABLED);
+		if (!s) {
+			//can't instance, don't keep trying
+			ps->instances_mutex->lock();
+			ps->prepare_pending = 0;
+			ps->instances_mutex->unlock();
+			continue;
+		}
+
+		ps->instances_mutex->lock();
+		ps->prepared_instances.push_back(s);
+		ps->instances_mutex->unlock();
+	}
+}
+
+Node *PackedScene::_take_ready_instance() const {
+
+	if (!instances_mutex) {
+		return NULL;
+	}
+
+	Node *s = NULL;
+
+	instances_mutex->lock();
+	while (!s && recycled_instances.size()) {
+		//skip instances freed or put back in a tree while they were waiting
+		s = Object::cast_to<Node>(ObjectDB::get_instance(recycled_instances.front()->get()));
+		recycled_instances.pop_front();
+		if (s && (s->is_inside_tree() || s->get_parent())) {
+			s = NULL;
+		}
+	}
+	if (!s && prepared_instances.size()) {
+		s = prepared_instances.front()->get();
+		prepared_instances.pop_front();
+	}
+	instances_mutex->unlock();
+
+	return s;
+}
+
+void PackedScene::_clear_ready_instances() {
+
+	if (prepare_thread) {
+
+		instances_mutex->lock();
+		prepare_exit = true;
+		instances_mutex->unlock();
+
+		Thread::wait_to_finish(prepare_thread);
+		memdelete(prepare_thread);
+		prepare_thread = NULL;
+		prepare_exit = false;
+	}
+
+	prepare_pending = 0;
+
+	while (prepared_instances.size()) {
+		memdelete(prepared_instances.front()->get());
+		prepared_instances.pop_front();
+	}
+
+	while (recycled_instances.size()) {
+		Object *obj = ObjectDB::get_instance(recycled_instances.front()->get());
+		if (obj) {
+			memdelete(obj);
+		}
+		recycled_instances.pop_front();
+	}
+}
+
+void PackedScene::prepare_instances(int p_count) {
+
+	ERR_FAIL_COND(p_count < 0);
+	ERR_FAIL_COND(!can_instance());
+
+	if (!instances_mutex) {
+		instances_mutex = Mutex::create();
+	}
+
+#ifdef NO_THREADS
+	for (int i = 0; i < p_count; i++) {
+		Node *s = state->instance(SceneState::GEN_EDIT_STATE_DISABLED);
+		ERR_FAIL_COND(!s);
+		prepared_instances.push_back(s);
+	}
+#else
+	instances_mutex->lock();
+	prepare_pending += p_count;
+	bool start = !prepare_running && prepare_pending > 0;
+	if (start) {
+		prepare_running = true;
+	}
+	instances_mutex->unlock();
+
+	if (start) {
+		if (prepare_thread) {
+			//previous batch is done, the thread is exiting
+			Thread::wait_to_finish(prepare_thread);
+			memdelete(prepare_thread);
+		}
+		prepare_thread = Thread::create(_prepare_thread_func, this);
+	}
+#endif
+}
+
+int PackedScene::get_prepared_instance_count() const {
+
+	if (!instances_mutex) {
+		return 0;
+	}
+
+	instances_mutex->lock();
+	int count = prepared_instances.size();
+	instances_mutex->unlock();
+
+	return count;
+}
+
+// back to how instancing left it: connections and groups made after the instance was handed out are dropped,
+// so _ready() can add them again. Those made by constructors and the scene itself are older and stay
+static void _prepare_recycle_recursive(Node *p_node, uint64_t p_serial) {
+
+	List<Object::Connection> connections;
+	p_node->get_all_signal_connections(&connections);
+	p_node->get_signals_connected_to_this(&connections);
+
+	for (List<Object::Connection>::Element *E = connections.front(); E; E = E->next()) {
+
+		const Object::Connection &c = E->get();
+		if (c.serial > p_serial && c.source->is_connected(c.signal, c.target, c.method)) {
+			c.source->disconnect(c.signal, c.target, c.method);
+		}
+	}
+
+	List<Node::GroupInfo> groups;
+	p_node->get_groups(&groups);
+
+	for (List<Node::GroupInfo>::Element *E = groups.front(); E; E = E->next()) {
+
+		if (E->get().serial <= p_serial) {
+			continue;
+		}
+
+		//processing groups follow their flags, which have to be cleared with them
+		StringName name = E->get().name;
+		if (name == "idle_process") {
+			p_node->set_process(false);
+		} else if (name == "idle_process_internal") {
+			p_node->set_process_internal(false);
+		} else if (name == "physics_process") {
+			p_node->set_physics_process(false);
+		} else if (name == "physics_process_internal") {
+			p_node->set_physics_process_internal(false);
+		} else {
+			p_node->remove_from_group(name);
+		}
+	}
+
+	p_node->request_ready();
+
+	int cc = p_node->get_child_count();
+	for (int i = 0; i < cc; i++) {
+		_prepare_recycle_recursive(p_node->get_child(i), p_serial);
+	}
+}
+
+bool PackedScene::recycle_instance(Node *p_node) {
+
+	ERR_FAIL_NULL_V(p_node, false);
+	ERR_FAIL_COND_V(!can_instance(), false);
+	ERR_FAIL_COND_V(p_node->is_queued_for_deletion(), false);
+
+	//instances are recognized by the file they were instanced from, built-in and unsaved scenes don't have one
+	String path = get_path();
+	if (path == String() || path.find("::") != -1) {
+		ERR_EXPLAIN("Only scenes saved to their own file can recycle instances.");
+		ERR_FAIL_V(false);
+	}
+	if (p_node->get_filename() != path) {
+		ERR_EXPLAIN("Node '" + p_node->get_name() + "' is not an instance of this scene: " + path);
+		ERR_FAIL_V(false);
+	}
+
+	if (p_node->get_scene_instance_serial() == 0) {
+		ERR_EXPLAIN("Node '" + p_node->get_name() + "' was not created by instance(), what it had at first is unknown.");
+		ERR_FAIL_V(false);
+	}
+
+	//nodes removed since can't be restored, the caller frees the instance instead
+	if (!state->is_instance_intact(p_node)) {
+		return false;
+	}
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	//runtime connections go first, so restoring properties doesn't emit signals to them.
+	//reset while outside the tree, where setting properties is cheapest
+	_prepare_recycle_recursive(p_node, p_node->get_scene_instance_serial());
+	state->reset_instance(p_node);
+
+	if (!instances_mutex) {
+		instances_mutex = Mutex::create();
+	}
+
+	instances_mutex->lock();
+	recycled_instances.push_back(p_node->get_instance_id());
+	instances_mutex->unlock();
+
+	return true;
+}
+
+int PackedScene::get_recycled_instance_count() const {
+
+	if (!instances_mutex) {
+		return 0;
+	}
+
+	instances_mutex->lock();
+	int count = recycled_instances.size();
+	instances_mutex->unlock();
+
+	return count;
+}
+
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
 
+	_clear_ready_instances();
 	state->set_bundled_scene(p_scene);
 }
 
@@ -1674,11 +2116,13 @@ Dictionary PackedScene::_get_bundled_scene() const {
 
 Error PackedScene::pack(Node *p_scene) {
 
+	_clear_ready_instances();
 	return state->pack(p_scene);
 }
 
 void PackedScene::clear() {
 
+	_clear_ready_instances();
 	state->clear();
 }
 
@@ -1696,7 +2140,13 @@ Node *PackedScene::instance(GenEditState p_edit_state) const {
 	}
 #endif
 
-	Node *s = state->instance((SceneState::GenEditState)p_edit_state);
+	Node *s = NULL;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED) {
+		s = _take_ready_instance();
+	}
+	if (!s) {
+		s = state->instance((SceneState::GenEditState)p_edit_state);
+	}
 	if (!s)
 		return NULL;
 
@@ -1709,11 +2159,15 @@ Node *PackedScene::instance(GenEditState p_edit_state) const {
 
 	s->notification(Node::NOTIFICATION_INSTANCED);
 
+	//anything connected or grouped from here on is undone by recycle_instance()
+	s->set_scene_instance_serial(Object::get_connection_serial());
+
 	return s;
 }
 
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 
+	_clear_ready_instances();
 	state = p_by;
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1723,6 +2177,7 @@ void PackedScene::replace_state(Ref<SceneState> p_by) {
 
 void PackedScene::recreate_state() {
 
+	_clear_ready_instances();
 	state = Ref<SceneState>(memnew(SceneState));
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1746,6 +2201,10 @@ void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instance", "edit_state"), &PackedScene::instance, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instance"), &PackedScene::can_instance);
+	ClassDB::bind_method(D_METHOD("prepare_instances", "count"), &PackedScene::prepare_instances);
+	ClassDB::bind_method(D_METHOD("get_prepared_instance_count"), &PackedScene::get_prepared_instance_count);
+	ClassDB::bind_method(D_METHOD("recycle_instance", "node"), &PackedScene::recycle_instance);
+	ClassDB::bind_method(D_METHOD("get_recycled_instance_count"), &PackedScene::get_recycled_instance_count);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
 	ClassDB::bind_method(D_METHOD("get_state"), &PackedScene::get_state);
@@ -1760,4 +2219,18 @@ void PackedScene::_bind_methods() {
 PackedScene::PackedScene() {
 
 	state = Ref<SceneState>(memnew(SceneState));
+
+	prepare_thread = NULL;
+	instances_mutex = NULL;
+	prepare_pending = 0;
+	prepare_running = false;
+	prepare_exit = false;
+}
+
+PackedScene::~PackedScene() {
+
+	_clear_ready_instances();
+	if (instances_mutex) {
+		memdelete(instances_mutex);
+	}
 }
@@ -31,6 +31,8 @@
 #ifndef PACKED_SCENE_H
 #define PACKED_SCENE_H
 
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
 #include "core/resource.h"
 #include "scene/main/node.h"
 
@@ -92,6 +94,18 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	struct ResetProperty {
+
+		StringName name;
+		Variant value;
+	};
+
+	// per node, the stored properties and the values reset_instance() gives them, built on first use
+	mutable Vector<Vector<ResetProperty> > reset_properties;
+
+	void _build_reset_properties() const;
+	Node *_get_instance_node(Node *p_root, Node *const *p_found, int p_idx) const;
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -143,6 +157,8 @@ public:
 
 	bool can_instance() const;
 	Node *instance(GenEditState p_edit_state) const;
+	bool is_instance_intact(Node *p_root) const;
+	void reset_instance(Node *p_root) const;
 
 	//unbuild API
 
@@ -201,6 +217,19 @@ class PackedScene : public Resource {
 
 	Ref<SceneState> state;
 
+	// instances built ahead of time in a thread or recycled after use, handed out by instance()
+	Thread *prepare_thread;
+	Mutex *instances_mutex;
+	mutable List<Node *> prepared_instances;
+	mutable List<ObjectID> recycled_instances; // may be freed while waiting, so validated when taken
+	int prepare_pending;
+	bool prepare_running;
+	bool prepare_exit;
+
+	static void _prepare_thread_func(void *p_userdata);
+	Node *_take_ready_instance() const;
+	void _clear_ready_instances();
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
 
@@ -222,6 +251,12 @@ public:
 	bool can_instance() const;
 	Node *instance(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
+	void prepare_instances(int p_count);
+	int get_prepared_instance_count() const;
+
+	bool recycle_instance(Node *p_node);
+	int get_recycled_instance_count() const;
+
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
 
@@ -233,6 +268,7 @@ public:
 	Ref<SceneState> get_state();
 
 	PackedScene();
+	~PackedScene();
 };
 
 VARIANT_ENUM_CAST(PackedScene::GenEditState)
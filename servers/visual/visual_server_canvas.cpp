@@ -414,6 +414,22 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 
 	canvas_item->xform = p_transform;
 }
+void VisualServerCanvas::canvas_items_set_transforms(const Vector<RID> &p_items, const Vector<Transform2D> &p_transforms) {
+
+	ERR_FAIL_COND(p_items.size() != p_transforms.size());
+
+	int count = p_items.size();
+	const RID *items = p_items.ptr();
+	const Transform2D *transforms = p_transforms.ptr();
+
+	for (int i = 0; i < count; i++) {
+
+		Item *canvas_item = canvas_item_owner.getornull(items[i]);
+		ERR_CONTINUE(!canvas_item);
+
+		canvas_item->xform = transforms[i];
+	}
+}
 void VisualServerCanvas::canvas_item_set_clip(RID p_item, bool p_clip) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -583,12 +583,9 @@ void VisualServerScene::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 
 	instance->layer_mask = p_mask;
 }
-void VisualServerScene::instance_set_transform(RID p_instance, const Transform &p_transform) {
+void VisualServerScene::_instance_set_transform(Instance *p_instance, const Transform &p_transform) {
 
-	Instance *instance = instance_owner.get(p_instance);
-	ERR_FAIL_COND(!instance);
-
-	if (instance->transform == p_transform)
+	if (p_instance->transform == p_transform)
 		return; //must be checked to avoid worst evil
 
 #ifdef DEBUG_ENABLED
@@ -604,8 +601,31 @@ void VisualServerScene::instance_set_transform(RID p_instance, const Transform &
 	}
 
 #endif
-	instance->transform = p_transform;
-	_instance_queue_update(instance, true);
+	p_instance->transform = p_transform;
+	_instance_queue_update(p_instance, true);
+}
+void VisualServerScene::instance_set_transform(RID p_instance, const Transform &p_transform) {
+
+	Instance *instance = instance_owner.get(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	_instance_set_transform(instance, p_transform);
+}
+void VisualServerScene::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) {
+
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	int count = p_instances.size();
+	const RID *instances = p_instances.ptr();
+	const Transform *transforms = p_transforms.ptr();
+
+	for (int i = 0; i < count; i++) {
+
+		Instance *instance = instance_owner.get(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		_instance_set_transform(instance, transforms[i]);
+	}
 }
 void VisualServerScene::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
 